@@ -0,0 +1,327 @@
+#include "RpgBenchmark.h"
+
+
+
+#define RPG_BENCHMARK_STRINGIFY_INTERNAL(x)		#x
+#define RPG_BENCHMARK_STRINGIFY(x)				RPG_BENCHMARK_STRINGIFY_INTERNAL(x)
+
+#if defined(__clang__)
+#define RPG_BENCHMARK_COMPILER		"clang " __clang_version__
+#elif defined(__GNUC__)
+#define RPG_BENCHMARK_COMPILER		"gcc " __VERSION__
+#elif defined(_MSC_VER)
+#define RPG_BENCHMARK_COMPILER		"msvc " RPG_BENCHMARK_STRINGIFY(_MSC_FULL_VER)
+#else
+#define RPG_BENCHMARK_COMPILER		"unknown"
+#endif
+
+
+#ifdef RPG_BUILD_DEBUG
+#define RPG_BENCHMARK_BUILD_CONFIG		"debug"
+#elif RPG_BUILD_DEVELOPMENT
+#define RPG_BENCHMARK_BUILD_CONFIG		"development"
+#else
+#define RPG_BENCHMARK_BUILD_CONFIG		"shipping"
+#endif // RPG_BUILD_DEBUG
+
+
+// Upper bound of calibrated iteration count
+#define RPG_BENCHMARK_MAX_ITERATION_COUNT		(1LL << 30)
+
+
+RPG_LOG_DECLARE_CATEGORY_STATIC(RpgLogBenchmark, VERBOSITY_LOG)
+
+
+
+namespace RpgBenchmark
+{
+	static FConfig Config;
+	static RpgArray<FResult> Results;
+	static double TickToNs;
+
+	// Written by UsePointer, never read
+	static const volatile void* volatile PointerSink;
+
+
+	static inline uint64_t GetTickCounter() noexcept
+	{
+		return SDL_GetPerformanceCounter();
+	}
+
+
+	static inline double MeasureIterations(FFunction function, void* context, int64_t iterationCount) noexcept
+	{
+		const uint64_t startTick = GetTickCounter();
+
+		for (int64_t i = 0; i < iterationCount; ++i)
+		{
+			function(context);
+		}
+
+		return static_cast<double>(GetTickCounter() - startTick) * TickToNs;
+	}
+
+
+	static bool ContainsIgnoreCase(const char* cstr, const char* subString) noexcept
+	{
+		const int len = RpgPlatformMemory::CStringLength(cstr);
+		const int subLen = RpgPlatformMemory::CStringLength(subString);
+
+		for (int i = 0; i + subLen <= len; ++i)
+		{
+			if (SDL_strncasecmp(cstr + i, subString, subLen) == 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
+	// Write JSON string with quotes and escaped characters
+	static void WriteJsonString(SDL_IOStream* file, const char* cstr) noexcept
+	{
+		SDL_IOprintf(file, "\"");
+
+		for (const char* c = cstr; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				SDL_IOprintf(file, "\\%c", *c);
+			}
+			else if (static_cast<unsigned char>(*c) < 0x20)
+			{
+				SDL_IOprintf(file, "\\u%04x", static_cast<unsigned char>(*c));
+			}
+			else
+			{
+				SDL_IOprintf(file, "%c", *c);
+			}
+		}
+
+		SDL_IOprintf(file, "\"");
+	}
+
+
+	static void GetDateTimeString(char* out_Buffer, int bufferSize) noexcept
+	{
+		SDL_Time ticks = 0;
+		SDL_DateTime dateTime{};
+
+		if (SDL_GetCurrentTime(&ticks) && SDL_TimeToDateTime(ticks, &dateTime, false))
+		{
+			snprintf(out_Buffer, bufferSize, "%04i-%02i-%02iT%02i:%02i:%02iZ", dateTime.year, dateTime.month, dateTime.day, dateTime.hour, dateTime.minute, dateTime.second);
+		}
+		else
+		{
+			snprintf(out_Buffer, bufferSize, "unknown");
+		}
+	}
+
+};
+
+
+void RpgBenchmark::Initialize(const FConfig& config) noexcept
+{
+	RPG_IsMainThread();
+
+	Config = config;
+
+	if (Config.SampleCount < 1)
+	{
+		Config.SampleCount = 1;
+	}
+
+	if (Config.MinSampleTimeMs <= 0.0)
+	{
+		Config.MinSampleTimeMs = RPG_BENCHMARK_DEFAULT_MIN_SAMPLE_TIME_MS;
+	}
+
+	TickToNs = 1000000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+	Results.Clear();
+
+	RPG_Log(RpgLogBenchmark, "Initialize benchmark (samples: %i, min sample time: %.1f ms, filter: %s)", Config.SampleCount, Config.MinSampleTimeMs, Config.Filter ? Config.Filter : "none");
+}
+
+
+void RpgBenchmark::Shutdown() noexcept
+{
+	Results.Clear(true);
+}
+
+
+bool RpgBenchmark::ShouldRun(const char* suite, const char* name) noexcept
+{
+	if (Config.Filter == nullptr || Config.Filter[0] == '\0')
+	{
+		return true;
+	}
+
+	char fullName[160];
+	snprintf(fullName, sizeof(fullName), "%s/%s", suite, name);
+
+	return ContainsIgnoreCase(fullName, Config.Filter);
+}
+
+
+void RpgBenchmark::Run(const char* suite, const char* name, int64_t itemCount, FFunction function, void* context) noexcept
+{
+	RPG_IsMainThread();
+
+	if (!ShouldRun(suite, name))
+	{
+		return;
+	}
+
+	const double minSampleNs = Config.MinSampleTimeMs * 1000000.0;
+
+	// Warmup (page faults, caches, lazy initialization)
+	MeasureIterations(function, context, 1);
+
+	// Calibrate number of iterations per sample
+	int64_t iterationCount = 1;
+
+	while (iterationCount < RPG_BENCHMARK_MAX_ITERATION_COUNT)
+	{
+		const double elapsedNs = MeasureIterations(function, context, iterationCount);
+
+		if (elapsedNs >= minSampleNs)
+		{
+			break;
+		}
+
+		// Scale towards target with some headroom, at most 10x per step in case the first measurement was noise
+		double scale = (elapsedNs > 0.0) ? (minSampleNs * 1.2 / elapsedNs) : 10.0;
+		scale = (scale < 2.0) ? 2.0 : (scale > 10.0 ? 10.0 : scale);
+
+		iterationCount = static_cast<int64_t>(static_cast<double>(iterationCount) * scale);
+	}
+
+	if (iterationCount > RPG_BENCHMARK_MAX_ITERATION_COUNT)
+	{
+		iterationCount = RPG_BENCHMARK_MAX_ITERATION_COUNT;
+	}
+
+	RpgArray<double> sampleNs(Config.SampleCount);
+	double totalNs = 0.0;
+
+	for (int s = 0; s < Config.SampleCount; ++s)
+	{
+		sampleNs[s] = MeasureIterations(function, context, iterationCount) / static_cast<double>(iterationCount);
+		totalNs += sampleNs[s];
+	}
+
+	RpgAlgorithm::Sort(sampleNs.GetData(), sampleNs.GetCount());
+
+	FResult& result = Results.Add();
+	snprintf(result.Suite, sizeof(result.Suite), "%s", suite);
+	snprintf(result.Name, sizeof(result.Name), "%s", name);
+	result.ItemCount = itemCount;
+	result.IterationCount = iterationCount;
+	result.SampleCount = Config.SampleCount;
+	result.MinNs = sampleNs[0];
+	result.MedianNs = sampleNs[Config.SampleCount / 2];
+	result.MeanNs = totalNs / Config.SampleCount;
+	result.MaxNs = sampleNs[Config.SampleCount - 1];
+
+	const double perItemNs = (itemCount > 0) ? result.MedianNs / static_cast<double>(itemCount) : result.MedianNs;
+
+	RPG_Log(RpgLogBenchmark, "%-10s %-48s %14.1f ns/iter %10.2f ns/item (min %.1f, max %.1f)", suite, name, result.MedianNs, perItemNs, result.MinNs, result.MaxNs);
+}
+
+
+const RpgArray<RpgBenchmark::FResult>& RpgBenchmark::GetResults() noexcept
+{
+	return Results;
+}
+
+
+bool RpgBenchmark::WriteJson(const char* filePath, const char* opt_Tag) noexcept
+{
+	SDL_IOStream* file = SDL_IOFromFile(filePath, "w");
+	if (file == nullptr)
+	{
+		RPG_LogError(RpgLogBenchmark, "Write results to file (%s) failed. Cannot open file!", filePath);
+		return false;
+	}
+
+	char dateTime[32];
+	GetDateTimeString(dateTime, sizeof(dateTime));
+
+	SDL_IOprintf(file, "{\n");
+	SDL_IOprintf(file, "\t\"tag\": ");
+	WriteJsonString(file, opt_Tag ? opt_Tag : "");
+	SDL_IOprintf(file, ",\n");
+	SDL_IOprintf(file, "\t\"date\": \"%s\",\n", dateTime);
+	SDL_IOprintf(file, "\t\"platform\": \"%s\",\n", SDL_GetPlatform());
+	SDL_IOprintf(file, "\t\"compiler\": ");
+	WriteJsonString(file, RPG_BENCHMARK_COMPILER);
+	SDL_IOprintf(file, ",\n");
+	SDL_IOprintf(file, "\t\"build\": \"%s\",\n", RPG_BENCHMARK_BUILD_CONFIG);
+	SDL_IOprintf(file, "\t\"cpu_count\": %i,\n", SDL_GetNumLogicalCPUCores());
+	SDL_IOprintf(file, "\t\"sample_count\": %i,\n", Config.SampleCount);
+	SDL_IOprintf(file, "\t\"min_sample_time_ms\": %.3f,\n", Config.MinSampleTimeMs);
+	SDL_IOprintf(file, "\t\"results\": [\n");
+
+	for (int i = 0; i < Results.GetCount(); ++i)
+	{
+		const FResult& result = Results[i];
+		const double perItemNs = (result.ItemCount > 0) ? result.MedianNs / static_cast<double>(result.ItemCount) : result.MedianNs;
+
+		SDL_IOprintf(file, "\t\t{ \"suite\": ");
+		WriteJsonString(file, result.Suite);
+		SDL_IOprintf(file, ", \"name\": ");
+		WriteJsonString(file, result.Name);
+		SDL_IOprintf(file, ", \"items\": %lld, \"iterations\": %lld, \"samples\": %i, \"min_ns\": %.3f, \"median_ns\": %.3f, \"mean_ns\": %.3f, \"max_ns\": %.3f, \"ns_per_item\": %.4f }%s\n",
+			static_cast<long long>(result.ItemCount), static_cast<long long>(result.IterationCount), result.SampleCount,
+			result.MinNs, result.MedianNs, result.MeanNs, result.MaxNs, perItemNs,
+			(i + 1 < Results.GetCount()) ? "," : ""
+		);
+	}
+
+	SDL_IOprintf(file, "\t]\n");
+	SDL_IOprintf(file, "}\n");
+	SDL_CloseIO(file);
+
+	RPG_Log(RpgLogBenchmark, "Write %i results to (%s)", Results.GetCount(), filePath);
+
+	return true;
+}
+
+
+bool RpgBenchmark::WriteCsv(const char* filePath, const char* opt_Tag) noexcept
+{
+	SDL_IOStream* file = SDL_IOFromFile(filePath, "w");
+	if (file == nullptr)
+	{
+		RPG_LogError(RpgLogBenchmark, "Write results to file (%s) failed. Cannot open file!", filePath);
+		return false;
+	}
+
+	SDL_IOprintf(file, "tag,suite,name,items,iterations,samples,min_ns,median_ns,mean_ns,max_ns,ns_per_item\n");
+
+	for (int i = 0; i < Results.GetCount(); ++i)
+	{
+		const FResult& result = Results[i];
+		const double perItemNs = (result.ItemCount > 0) ? result.MedianNs / static_cast<double>(result.ItemCount) : result.MedianNs;
+
+		SDL_IOprintf(file, "%s,%s,%s,%lld,%lld,%i,%.3f,%.3f,%.3f,%.3f,%.4f\n",
+			opt_Tag ? opt_Tag : "", result.Suite, result.Name,
+			static_cast<long long>(result.ItemCount), static_cast<long long>(result.IterationCount), result.SampleCount,
+			result.MinNs, result.MedianNs, result.MeanNs, result.MaxNs, perItemNs
+		);
+	}
+
+	SDL_CloseIO(file);
+
+	RPG_Log(RpgLogBenchmark, "Write %i results to (%s)", Results.GetCount(), filePath);
+
+	return true;
+}
+
+
+void RpgBenchmark::UsePointer(const volatile void* pointer) noexcept
+{
+	PointerSink = pointer;
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "core/RpgPlatform.h"
+#include "core/dsa/RpgArray.h"
+
+
+
+// Default number of measured samples per benchmark
+#define RPG_BENCHMARK_DEFAULT_SAMPLE_COUNT			5
+
+// Default minimum duration of one sample. Iteration count is scaled until a sample takes at least this long
+#define RPG_BENCHMARK_DEFAULT_MIN_SAMPLE_TIME_MS	20.0
+
+
+
+namespace RpgBenchmark
+{
+	struct FConfig
+	{
+		// Only run benchmarks whose "<suite>/<name>" contains this string (case-insensitive). nullptr runs all
+		const char* Filter{ nullptr };
+
+		int SampleCount{ RPG_BENCHMARK_DEFAULT_SAMPLE_COUNT };
+		double MinSampleTimeMs{ RPG_BENCHMARK_DEFAULT_MIN_SAMPLE_TIME_MS };
+	};
+
+
+	struct FResult
+	{
+		char Suite[32];
+		char Name[96];
+
+		// Number of items processed by one iteration (elements, lookups, tasks...)
+		int64_t ItemCount;
+
+		// Number of iterations per sample
+		int64_t IterationCount;
+
+		int SampleCount;
+
+		// Time per iteration in nanoseconds
+		double MinNs;
+		double MedianNs;
+		double MeanNs;
+		double MaxNs;
+	};
+
+
+	// Function called for each iteration
+	typedef void (*FFunction)(void* context);
+
+
+	// Initialize benchmark runner. Must be called from main thread
+	// @param config - Runner configuration
+	// @returns None
+	void Initialize(const FConfig& config) noexcept;
+
+
+	// Free all results
+	// @returns None
+	void Shutdown() noexcept;
+
+
+	// Check if benchmark passes the filter
+	// @param suite - Suite name
+	// @param name - Benchmark name
+	// @returns True if benchmark should run
+	[[nodiscard]] bool ShouldRun(const char* suite, const char* name) noexcept;
+
+
+	// [Block] Run and measure benchmark. <function> is called once for warmup, then the iteration count is calibrated to
+	// FConfig::MinSampleTimeMs and each sample calls <function> IterationCount times.
+	// @param suite - Suite name
+	// @param name - Benchmark name
+	// @param itemCount - Number of items processed by one call of <function>, used to report time per item
+	// @param function - Function to measure
+	// @param context - User data passed to <function>
+	// @returns None
+	void Run(const char* suite, const char* name, int64_t itemCount, FFunction function, void* context) noexcept;
+
+
+	// [Block] Run and measure benchmark. <function>() is called for each iteration
+	template<typename TFunction>
+	inline void Run(const char* suite, const char* name, int64_t itemCount, TFunction&& function) noexcept
+	{
+		typedef std::remove_reference_t<TFunction> FFunctionType;
+
+		Run(suite, name, itemCount,
+			[](void* context)
+			{
+				(*static_cast<FFunctionType*>(context))();
+			},
+			const_cast<void*>(static_cast<const void*>(&function))
+		);
+	}
+
+
+	// Get all measured results in order of execution
+	[[nodiscard]] const RpgArray<FResult>& GetResults() noexcept;
+
+
+	// Write results as JSON
+	// @param filePath - Output file path
+	// @param opt_Tag - Label stored with the results (engine drop, commit), can be nullptr
+	// @returns True on success
+	bool WriteJson(const char* filePath, const char* opt_Tag) noexcept;
+
+
+	// Write results as CSV. One row per benchmark, times in nanoseconds
+	// @param filePath - Output file path
+	// @param opt_Tag - Label stored in the first column, can be nullptr
+	// @returns True on success
+	bool WriteCsv(const char* filePath, const char* opt_Tag) noexcept;
+
+
+	// Opaque to the optimizer. Used by DoNotOptimize on compilers without inline asm
+	void UsePointer(const volatile void* pointer) noexcept;
+
+
+	// Prevent compiler from removing computation of <value> as dead code
+	template<typename T>
+	inline void DoNotOptimize(const T& value) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		UsePointer(&value);
+#endif // __GNUC__ || __clang__
+	}
+
+
+	// Force pending memory writes to be treated as observable
+	inline void ClobberMemory() noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#else
+		UsePointer(nullptr);
+#endif // __GNUC__ || __clang__
+	}
+
+
+	// Deterministic pseudo random generator (xorshift64*), benchmark data must be the same between runs
+	struct FRandom
+	{
+		uint64_t State{ 0x9E3779B97F4A7C15ULL };
+
+		inline uint64_t Next() noexcept
+		{
+			State ^= State >> 12;
+			State ^= State << 25;
+			State ^= State >> 27;
+
+			return State * 0x2545F4914F6CDD1DULL;
+		}
+
+		inline uint32_t NextUint32() noexcept
+		{
+			return static_cast<uint32_t>(Next() >> 32);
+		}
+
+		// @returns Random integer in range [0, maxExclusive)
+		inline int NextInt(int maxExclusive) noexcept
+		{
+			return static_cast<int>(NextUint32() % static_cast<uint32_t>(maxExclusive));
+		}
+
+		// @returns Random float in range [0, 1)
+		inline float NextFloat() noexcept
+		{
+			return static_cast<float>(NextUint32() >> 8) / 16777216.0f;
+		}
+	};
+
+};
+
+
+
+// Benchmark suites, called in order by RpgBenchmarkMain
+namespace RpgBenchmarkSuite
+{
+	void Container() noexcept;
+	void String() noexcept;
+	void Math() noexcept;
+	void Thread() noexcept;
+	void World() noexcept;
+
+};
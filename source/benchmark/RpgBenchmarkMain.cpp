@@ -0,0 +1,90 @@
+#include "RpgBenchmark.h"
+#include "core/RpgCommandLine.h"
+#include "core/RpgAllocator.h"
+#include "core/RpgProfiler.h"
+#include "core/RpgThreadPool.h"
+
+
+
+// Usage: RpgBenchmark [-filter=<suite/name>] [-samples=<count>] [-min_time_ms=<ms>] [-format=json|csv] [-out=<path>] [-tag=<label>]
+int main(int argc, char** argv)
+{
+// ------------------------------------------------------------------------------------------------- //
+// 	Initialization
+// ------------------------------------------------------------------------------------------------- //
+	{
+		char commandArgs[1024]{};
+		int length = 0;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			length += snprintf(commandArgs + length, sizeof(commandArgs) - length, (i > 1) ? " %s" : "%s", argv[i]);
+
+			if (length >= static_cast<int>(sizeof(commandArgs)))
+			{
+				break;
+			}
+		}
+
+		RpgCommandLine::Initialize(commandArgs);
+	}
+
+	RpgPlatformConsole::Initialize();
+	RpgPlatformLog::Initialize(RpgPlatformLog::VERBOSITY_LOG);
+	RpgPlatformProcess::Initialize();
+
+	RpgProfiler::Initialize();
+	RpgFrameArena::Initialize();
+	RpgThreadPool::Initialize();
+
+
+	RpgBenchmark::FConfig config;
+	config.Filter = RpgCommandLine::GetCommandValue("filter");
+
+	if (RpgCommandLine::HasCommand("samples"))
+	{
+		config.SampleCount = RpgCommandLine::GetCommandValueInt("samples");
+	}
+
+	if (RpgCommandLine::HasCommand("min_time_ms"))
+	{
+		config.MinSampleTimeMs = static_cast<double>(RpgCommandLine::GetCommandValueInt("min_time_ms"));
+	}
+
+	const char* format = RpgCommandLine::GetCommandValue("format");
+	const bool bCsv = format && RpgPlatformMemory::CStringCompare(format, "csv", true);
+
+	const char* outputFilePath = RpgCommandLine::GetCommandValue("out");
+	if (outputFilePath == nullptr)
+	{
+		outputFilePath = bCsv ? "RpgBenchmark.csv" : "RpgBenchmark.json";
+	}
+
+
+// ------------------------------------------------------------------------------------------------- //
+// 	Run
+// ------------------------------------------------------------------------------------------------- //
+	RpgBenchmark::Initialize(config);
+
+	RpgBenchmarkSuite::Container();
+	RpgBenchmarkSuite::String();
+	RpgBenchmarkSuite::Math();
+	RpgBenchmarkSuite::Thread();
+	RpgBenchmarkSuite::World();
+
+	const char* tag = RpgCommandLine::GetCommandValue("tag");
+	const bool bWritten = bCsv ? RpgBenchmark::WriteCsv(outputFilePath, tag) : RpgBenchmark::WriteJson(outputFilePath, tag);
+
+	RpgBenchmark::Shutdown();
+
+
+// ------------------------------------------------------------------------------------------------- //
+// 	Shutdown
+// ------------------------------------------------------------------------------------------------- //
+	RpgThreadPool::Shutdown();
+	RpgFrameArena::Shutdown();
+	RpgProfiler::Shutdown();
+	RpgPlatformProcess::Shutdown();
+
+	return bWritten ? 0 : 1;
+}
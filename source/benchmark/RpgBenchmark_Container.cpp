@@ -0,0 +1,571 @@
+#include "RpgBenchmark.h"
+#include "core/RpgAllocator.h"
+#include "core/dsa/RpgFreeList.h"
+#include "core/dsa/RpgMap.h"
+#include "core/dsa/RpgQueue.h"
+#include <algorithm>
+
+
+
+#define RPG_BENCHMARK_SUITE		"Container"
+
+
+namespace RpgBenchmarkContainer
+{
+	struct FElement
+	{
+		int Id;
+		float Position[3];
+		float Velocity[3];
+	};
+
+
+	static void Array() noexcept
+	{
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Array/AddValue_10k", 10000, []()
+		{
+			RpgArray<int> array;
+
+			for (int i = 0; i < 10000; ++i)
+			{
+				array.AddValue(i);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Array/AddValue_Reserved_10k", 10000, []()
+		{
+			RpgArray<int> array;
+			array.Reserve(10000);
+
+			for (int i = 0; i < 10000; ++i)
+			{
+				array.AddValue(i);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Array/AddValue_Struct_10k", 10000, []()
+		{
+			RpgArray<FElement> array;
+
+			for (int i = 0; i < 10000; ++i)
+			{
+				array.AddValue(FElement{ i });
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Array/InsertAtFirst_1k", 1000, []()
+		{
+			RpgArray<int> array;
+			array.AddValue(0);
+
+			for (int i = 1; i < 1000; ++i)
+			{
+				array.InsertAt(i, 0);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgArray<int> source(10000);
+		for (int i = 0; i < source.GetCount(); ++i)
+		{
+			source[i] = i;
+		}
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Array/RemoveAtFirst_KeepOrder_1k", 1000, [&]()
+		{
+			RpgArray<int> array(source.GetData(), 1000);
+
+			while (!array.IsEmpty())
+			{
+				array.RemoveAt(0, true);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Array/RemoveAtFirst_Swap_10k", 10000, [&]()
+		{
+			RpgArray<int> array(source);
+
+			while (!array.IsEmpty())
+			{
+				array.RemoveAt(0, false);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Array/FindIndexByValue_Last_10k", 10000, [&]()
+		{
+			RpgBenchmark::DoNotOptimize(source.FindIndexByValue(9999));
+		});
+	}
+
+
+	static void ArraySmall() noexcept
+	{
+		// Short lived list that fits inline, typical temporary in gameplay/render code
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ArraySmall/Heap_Add_16", 16, []()
+		{
+			RpgArray<int> array;
+
+			for (int i = 0; i < 16; ++i)
+			{
+				array.AddValue(i);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ArraySmall/Inline_Add_16", 16, []()
+		{
+			RpgArraySmall<int, 16> array;
+
+			for (int i = 0; i < 16; ++i)
+			{
+				array.AddValue(i);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ArraySmall/Spill_Add_64", 64, []()
+		{
+			RpgArraySmall<int, 16> array;
+
+			for (int i = 0; i < 64; ++i)
+			{
+				array.AddValue(i);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+	}
+
+
+	static void ArrayFrame() noexcept
+	{
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ArrayFrame/Heap_Add_1k", 1000, []()
+		{
+			RpgArray<int> array;
+
+			for (int i = 0; i < 1000; ++i)
+			{
+				array.AddValue(i);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+
+		// Arena is reset each iteration as it would be at frame start
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ArrayFrame/Arena_Add_1k", 1000, []()
+		{
+			RpgFrameArena::BeginFrame(0);
+
+			RpgArrayFrame<int> array;
+
+			for (int i = 0; i < 1000; ++i)
+			{
+				array.AddValue(i);
+			}
+
+			RpgBenchmark::DoNotOptimize(array.GetData());
+		});
+	}
+
+
+	static void FreeList() noexcept
+	{
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "FreeList/Add_100k", 100000, []()
+		{
+			RpgFreeList<FElement> freeList;
+
+			for (int i = 0; i < 100000; ++i)
+			{
+				const int index = freeList.Add();
+				RpgBenchmark::DoNotOptimize(index);
+			}
+		});
+
+		RpgFreeList<FElement> fullFreeList;
+		for (int i = 0; i < 100000; ++i)
+		{
+			fullFreeList[fullFreeList.Add()].Id = i;
+		}
+
+		// Re-added elements fill the removed slots, the list is full again after each iteration
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "FreeList/RemoveAndReAdd_Half_100k", 100000, [&]()
+		{
+			RpgFreeList<FElement>& freeList = fullFreeList;
+
+			for (int i = 0; i < 100000; i += 2)
+			{
+				freeList.RemoveAt(i);
+			}
+
+			for (int i = 0; i < 50000; ++i)
+			{
+				const int index = freeList.Add();
+				RpgBenchmark::DoNotOptimize(index);
+			}
+		});
+
+		// Iteration cost depends on density, empty ranges are skipped 64 slots at a time using valid bitset
+		const int CAPACITY = 100000;
+		const int densityPercents[] = { 5, 50, 100 };
+
+		for (int d = 0; d < 3; ++d)
+		{
+			const int densityPercent = densityPercents[d];
+
+			RpgFreeList<FElement> freeList;
+			for (int i = 0; i < CAPACITY; ++i)
+			{
+				freeList[freeList.Add()].Id = i;
+			}
+
+			RpgBenchmark::FRandom random;
+			for (int i = 0; i < CAPACITY; ++i)
+			{
+				if (random.NextInt(100) >= densityPercent)
+				{
+					freeList.RemoveAt(i);
+				}
+			}
+
+			char name[64];
+			snprintf(name, sizeof(name), "FreeList/Iterate_100k_Density%i", densityPercent);
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, name, freeList.GetCount(), [&]()
+			{
+				int sum = 0;
+
+				for (auto it = freeList.CreateConstIterator(); it; ++it)
+				{
+					sum += it.GetValue().Id;
+				}
+
+				RpgBenchmark::DoNotOptimize(sum);
+			});
+		}
+
+		// Baseline: same number of elements packed in array
+		RpgArray<FElement> array(CAPACITY);
+		for (int i = 0; i < CAPACITY; ++i)
+		{
+			array[i].Id = i;
+		}
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "FreeList/Baseline_ArrayIterate_100k", CAPACITY, [&]()
+		{
+			int sum = 0;
+
+			for (const FElement& element : array)
+			{
+				sum += element.Id;
+			}
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+	}
+
+
+	static void Map() noexcept
+	{
+		const int LOOKUP_COUNT = 1000;
+		const int counts[] = { 100, 10000, 1000000 };
+
+		for (int c = 0; c < 3; ++c)
+		{
+			const int count = counts[c];
+
+			RpgMap<int, int> map;
+			map.Reserve(count);
+
+			RpgArray<int> keys(count);
+			RpgArray<int> values(count);
+
+			// Unique non-negative keys (multiplication by odd number is bijective modulo 2^31)
+			for (int i = 0; i < count; ++i)
+			{
+				keys[i] = static_cast<int>((static_cast<uint32_t>(i) * 2654435761u) & 0x7FFFFFFF);
+				values[i] = i;
+
+				map.Add(keys[i]) = i;
+			}
+
+			RpgBenchmark::FRandom random;
+			RpgArray<int> lookupKeys(LOOKUP_COUNT);
+			for (int i = 0; i < LOOKUP_COUNT; ++i)
+			{
+				lookupKeys[i] = keys[random.NextInt(count)];
+			}
+
+			char name[64];
+
+			snprintf(name, sizeof(name), "Map/Find_Hit_%i", count);
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, name, LOOKUP_COUNT, [&]()
+			{
+				int sum = 0;
+
+				for (int i = 0; i < LOOKUP_COUNT; ++i)
+				{
+					sum += *map.GetValueByKey(lookupKeys[i]);
+				}
+
+				RpgBenchmark::DoNotOptimize(sum);
+			});
+
+			snprintf(name, sizeof(name), "Map/Find_Miss_%i", count);
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, name, LOOKUP_COUNT, [&]()
+			{
+				int found = 0;
+
+				for (int i = 0; i < LOOKUP_COUNT; ++i)
+				{
+					// Keys are non-negative
+					found += map.Exists(-1 - i) ? 1 : 0;
+				}
+
+				RpgBenchmark::DoNotOptimize(found);
+			});
+
+			// Baseline: linear scan of key array. Fewer lookups for large count to keep runtime reasonable
+			const int linearLookupCount = (count > 10000) ? 16 : LOOKUP_COUNT;
+
+			snprintf(name, sizeof(name), "Map/Baseline_LinearScan_Hit_%i", count);
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, name, linearLookupCount, [&]()
+			{
+				int sum = 0;
+
+				for (int i = 0; i < linearLookupCount; ++i)
+				{
+					sum += values[keys.FindIndexByValue(lookupKeys[i])];
+				}
+
+				RpgBenchmark::DoNotOptimize(sum);
+			});
+		}
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Map/Add_10k", 10000, []()
+		{
+			RpgMap<int, int> map;
+
+			for (int i = 0; i < 10000; ++i)
+			{
+				map.Add(i * 7919) = i;
+			}
+
+			RpgBenchmark::DoNotOptimize(map.GetCount());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Map/AddRemove_10k", 20000, []()
+		{
+			RpgMap<int, int> map;
+
+			for (int i = 0; i < 10000; ++i)
+			{
+				map.Add(i * 7919) = i;
+			}
+
+			for (int i = 0; i < 10000; ++i)
+			{
+				map.Remove(i * 7919);
+			}
+
+			RpgBenchmark::DoNotOptimize(map.GetCount());
+		});
+	}
+
+
+	static void Sort() noexcept
+	{
+		const int COUNT = 100000;
+
+		RpgArray<int> randomInts(COUNT);
+		RpgArray<uint32_t> randomKeys(COUNT);
+		RpgArray<FElement> randomElements(COUNT);
+
+		RpgBenchmark::FRandom random;
+		for (int i = 0; i < COUNT; ++i)
+		{
+			randomInts[i] = static_cast<int>(random.NextUint32() >> 1);
+			randomKeys[i] = random.NextUint32();
+			randomElements[i].Id = static_cast<int>(random.NextUint32() >> 1);
+		}
+
+		RpgArray<int> sortedInts(randomInts);
+		RpgAlgorithm::Sort(sortedInts.GetData(), COUNT);
+
+		RpgArray<int> ints(COUNT);
+		RpgArray<uint32_t> keys(COUNT);
+		RpgArray<FElement> elements(COUNT);
+
+		// Copy of input is included in measured time for all variants
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/IntroSort_Int_100k", COUNT, [&]()
+		{
+			ints = randomInts;
+			RpgAlgorithm::Sort(ints.GetData(), COUNT);
+			RpgBenchmark::DoNotOptimize(ints.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/Baseline_StdSort_Int_100k", COUNT, [&]()
+		{
+			ints = randomInts;
+			std::sort(ints.begin(), ints.end());
+			RpgBenchmark::DoNotOptimize(ints.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/IntroSort_Sorted_Int_100k", COUNT, [&]()
+		{
+			ints = sortedInts;
+			RpgAlgorithm::Sort(ints.GetData(), COUNT);
+			RpgBenchmark::DoNotOptimize(ints.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/Baseline_StdSort_Sorted_Int_100k", COUNT, [&]()
+		{
+			ints = sortedInts;
+			std::sort(ints.begin(), ints.end());
+			RpgBenchmark::DoNotOptimize(ints.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/IntroSort_Struct_100k", COUNT, [&]()
+		{
+			elements = randomElements;
+			RpgAlgorithm::Sort(elements.GetData(), COUNT, [](const FElement& a, const FElement& b) { return a.Id < b.Id; });
+			RpgBenchmark::DoNotOptimize(elements.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/Baseline_StdSort_Struct_100k", COUNT, [&]()
+		{
+			elements = randomElements;
+			std::sort(elements.begin(), elements.end(), [](const FElement& a, const FElement& b) { return a.Id < b.Id; });
+			RpgBenchmark::DoNotOptimize(elements.GetData());
+		});
+
+		RpgArray<uint32_t> tempKeys(COUNT);
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/RadixSort_Uint32_100k", COUNT, [&]()
+		{
+			keys = randomKeys;
+			RpgAlgorithm::RadixSort<uint32_t, uint32_t>(keys.GetData(), nullptr, COUNT, tempKeys.GetData(), nullptr);
+			RpgBenchmark::DoNotOptimize(keys.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/Baseline_StdSort_Uint32_100k", COUNT, [&]()
+		{
+			keys = randomKeys;
+			std::sort(keys.begin(), keys.end());
+			RpgBenchmark::DoNotOptimize(keys.GetData());
+		});
+
+		// 64-bit key with payload, e.g. sort key of draw call and its index
+		struct FKeyPayload
+		{
+			uint64_t Key;
+			uint32_t Payload;
+		};
+
+		RpgArray<uint64_t> randomKeys64(COUNT);
+		RpgArray<FKeyPayload> randomKeyPayloads(COUNT);
+
+		for (int i = 0; i < COUNT; ++i)
+		{
+			randomKeys64[i] = random.Next();
+			randomKeyPayloads[i].Key = randomKeys64[i];
+			randomKeyPayloads[i].Payload = static_cast<uint32_t>(i);
+		}
+
+		RpgArray<uint64_t> keys64(COUNT);
+		RpgArray<uint64_t> tempKeys64(COUNT);
+		RpgArray<uint32_t> payloads(COUNT);
+		RpgArray<uint32_t> tempPayloads(COUNT);
+		RpgArray<FKeyPayload> keyPayloads(COUNT);
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/RadixSort_Uint64_Payload_100k", COUNT, [&]()
+		{
+			keys64 = randomKeys64;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				payloads[i] = static_cast<uint32_t>(i);
+			}
+
+			RpgAlgorithm::RadixSort<uint64_t, uint32_t>(keys64.GetData(), payloads.GetData(), COUNT, tempKeys64.GetData(), tempPayloads.GetData());
+			RpgBenchmark::DoNotOptimize(keys64.GetData());
+			RpgBenchmark::DoNotOptimize(payloads.GetData());
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Sort/Baseline_StdSort_Uint64_Payload_100k", COUNT, [&]()
+		{
+			keyPayloads = randomKeyPayloads;
+			std::sort(keyPayloads.begin(), keyPayloads.end(), [](const FKeyPayload& a, const FKeyPayload& b) { return a.Key < b.Key; });
+			RpgBenchmark::DoNotOptimize(keyPayloads.GetData());
+		});
+	}
+
+
+	static void Queue() noexcept
+	{
+		// Single thread push/pop cost. Cross-thread throughput is measured in Thread suite
+		const int BATCH_COUNT = 256;
+
+		RpgQueueSPSC<int> queueSPSC(BATCH_COUNT);
+		RpgQueueMPMC<int> queueMPMC(BATCH_COUNT);
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Queue/SPSC_PushPop_256", BATCH_COUNT, [&]()
+		{
+			int value = 0;
+
+			for (int i = 0; i < BATCH_COUNT; ++i)
+			{
+				queueSPSC.Push(i);
+			}
+
+			for (int i = 0; i < BATCH_COUNT; ++i)
+			{
+				queueSPSC.Pop(value);
+			}
+
+			RpgBenchmark::DoNotOptimize(value);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Queue/MPMC_PushPop_256", BATCH_COUNT, [&]()
+		{
+			int value = 0;
+
+			for (int i = 0; i < BATCH_COUNT; ++i)
+			{
+				queueMPMC.Push(i);
+			}
+
+			for (int i = 0; i < BATCH_COUNT; ++i)
+			{
+				queueMPMC.Pop(value);
+			}
+
+			RpgBenchmark::DoNotOptimize(value);
+		});
+	}
+
+};
+
+
+void RpgBenchmarkSuite::Container() noexcept
+{
+	RpgBenchmarkContainer::Array();
+	RpgBenchmarkContainer::ArraySmall();
+	RpgBenchmarkContainer::ArrayFrame();
+	RpgBenchmarkContainer::FreeList();
+	RpgBenchmarkContainer::Map();
+	RpgBenchmarkContainer::Sort();
+	RpgBenchmarkContainer::Queue();
+}
@@ -0,0 +1,178 @@
+#include "RpgBenchmark.h"
+#include "core/RpgMath.h"
+
+
+
+#define RPG_BENCHMARK_SUITE		"Math"
+
+
+namespace RpgBenchmarkMath
+{
+	constexpr int COUNT = 1024;
+
+
+	struct FData
+	{
+		RpgArray<RpgVector3> Positions;
+		RpgArray<RpgVector3> Scales;
+		RpgArray<RpgQuaternion> Rotations;
+		RpgArray<RpgVector3> PitchYawRolls;
+		RpgArray<RpgMatrixTransform> Matrices;
+		RpgArray<RpgMatrixTransform> ParentMatrices;
+		RpgArray<RpgMatrixTransform> Results;
+		RpgArray<RpgBoundingAABB> Bounds;
+
+
+		FData() noexcept
+			: Positions(COUNT)
+			, Scales(COUNT)
+			, Rotations(COUNT)
+			, PitchYawRolls(COUNT)
+			, Matrices(COUNT)
+			, ParentMatrices(COUNT)
+			, Results(COUNT)
+			, Bounds(COUNT)
+		{
+			RpgBenchmark::FRandom random;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				Positions[i] = RpgVector3(random.NextFloat() * 200.0f - 100.0f, random.NextFloat() * 200.0f - 100.0f, random.NextFloat() * 200.0f - 100.0f);
+				Scales[i] = RpgVector3(0.5f + random.NextFloat());
+				PitchYawRolls[i] = RpgVector3(random.NextFloat() * 360.0f, random.NextFloat() * 360.0f, random.NextFloat() * 360.0f);
+				Rotations[i] = RpgQuaternion::FromPitchYawRollDegree(PitchYawRolls[i]);
+				Matrices[i] = RpgMatrixTransform(Positions[i], Rotations[i], Scales[i]);
+				ParentMatrices[i] = RpgMatrixTransform(Positions[COUNT - 1 - i], Rotations[i], RpgVector3(1.0f));
+				Bounds[i] = RpgBoundingAABB(Positions[i] - 1.0f, Positions[i] + 1.0f);
+			}
+		}
+	};
+
+
+	static void Matrix(FData& data) noexcept
+	{
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Matrix/Multiply_1k", COUNT, [&data]()
+		{
+			for (int i = 0; i < COUNT; ++i)
+			{
+				data.Results[i] = data.Matrices[i] * data.ParentMatrices[i];
+			}
+
+			RpgBenchmark::ClobberMemory();
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Matrix/Inverse_1k", COUNT, [&data]()
+		{
+			for (int i = 0; i < COUNT; ++i)
+			{
+				data.Results[i] = data.Matrices[i].GetInverse();
+			}
+
+			RpgBenchmark::ClobberMemory();
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Matrix/Compose_1k", COUNT, [&data]()
+		{
+			for (int i = 0; i < COUNT; ++i)
+			{
+				data.Results[i] = RpgMatrixTransform(data.Positions[i], data.Rotations[i], data.Scales[i]);
+			}
+
+			RpgBenchmark::ClobberMemory();
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Matrix/Decompose_1k", COUNT, [&data]()
+		{
+			RpgVector3 position;
+			RpgQuaternion rotation;
+			RpgVector3 scale;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				data.Matrices[i].Decompose(position, rotation, scale);
+				RpgBenchmark::DoNotOptimize(position);
+				RpgBenchmark::DoNotOptimize(rotation);
+				RpgBenchmark::DoNotOptimize(scale);
+			}
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Matrix/TransformPoint_1k", COUNT, [&data]()
+		{
+			RpgVector3 sum;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				sum += data.Positions[i] * data.Matrices[i];
+			}
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+	}
+
+
+	static void Quaternion(FData& data) noexcept
+	{
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Quaternion/FromPitchYawRoll_1k", COUNT, [&data]()
+		{
+			for (int i = 0; i < COUNT; ++i)
+			{
+				data.Rotations[i] = RpgQuaternion::FromPitchYawRollDegree(data.PitchYawRolls[i]);
+			}
+
+			RpgBenchmark::ClobberMemory();
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Quaternion/Slerp_1k", COUNT, [&data]()
+		{
+			RpgQuaternion result;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				result = RpgQuaternion::Slerp(data.Rotations[i], data.Rotations[COUNT - 1 - i], 0.35f);
+				RpgBenchmark::DoNotOptimize(result);
+			}
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Quaternion/RotateVector_1k", COUNT, [&data]()
+		{
+			RpgVector3 sum;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				sum += RpgQuaternion::RotateVector(data.Rotations[i], data.Positions[i]);
+			}
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+	}
+
+
+	static void Bounding(FData& data) noexcept
+	{
+		const RpgMatrixTransform cameraTransform(RpgVector3(0.0f, 0.0f, -150.0f), RpgQuaternion());
+		const RpgBoundingFrustum frustum(cameraTransform, RpgMatrixProjection::CreatePerspective(16.0f / 9.0f, 90.0f, 0.1f, 1000.0f));
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Bounding/FrustumTestAABB_1k", COUNT, [&data, &frustum]()
+		{
+			int visibleCount = 0;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				visibleCount += frustum.TestIntersectAABB(data.Bounds[i]) ? 1 : 0;
+			}
+
+			RpgBenchmark::DoNotOptimize(visibleCount);
+		});
+	}
+
+};
+
+
+void RpgBenchmarkSuite::Math() noexcept
+{
+	RpgBenchmarkMath::FData data;
+
+	RpgBenchmarkMath::Matrix(data);
+	RpgBenchmarkMath::Quaternion(data);
+	RpgBenchmarkMath::Bounding(data);
+}
@@ -0,0 +1,229 @@
+#include "RpgBenchmark.h"
+#include "core/RpgString.h"
+#include "core/dsa/RpgMap.h"
+
+
+
+#define RPG_BENCHMARK_SUITE		"String"
+
+
+namespace RpgBenchmarkString
+{
+	// Number of distinct names. Name table never shrinks, benchmarks only look up names created up front.
+	constexpr int NAME_COUNT = 1024;
+
+
+	static RpgArray<RpgString> GenerateStrings(int count, const char* prefix) noexcept
+	{
+		RpgArray<RpgString> strings(count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			strings[i] = RpgString::Format("%s_%i_Mesh_Component", prefix, i);
+		}
+
+		return strings;
+	}
+
+
+	static void String() noexcept
+	{
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "String/Format_1k", 1000, []()
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				RpgString string = RpgString::Format("Object_%i (%.2f, %.2f, %.2f)", i, 1.0f, 2.0f, 3.0f);
+				RpgBenchmark::DoNotOptimize(string.GetData());
+			}
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "String/ConstructCopy_1k", 1000, []()
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				RpgString string("SkeletalMesh_Character_Body");
+				RpgString copy(string);
+				RpgBenchmark::DoNotOptimize(copy.GetData());
+			}
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "String/Append_1k", 1000, []()
+		{
+			RpgString string;
+
+			for (int i = 0; i < 1000; ++i)
+			{
+				string.AppendInPlace("abc", 3);
+			}
+
+			RpgBenchmark::DoNotOptimize(string.GetData());
+		});
+
+		const RpgArray<RpgString> strings = GenerateStrings(NAME_COUNT, "Actor");
+		const RpgArray<RpgString> stringsUpper = GenerateStrings(NAME_COUNT, "ACTOR");
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "String/Equals_1k", NAME_COUNT, [&strings]()
+		{
+			int equalCount = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				equalCount += strings[i].Equals(strings[NAME_COUNT - 1 - i]) ? 1 : 0;
+			}
+
+			RpgBenchmark::DoNotOptimize(equalCount);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "String/Equals_IgnoreCase_1k", NAME_COUNT, [&strings, &stringsUpper]()
+		{
+			int equalCount = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				equalCount += strings[i].Equals(stringsUpper[i], true) ? 1 : 0;
+			}
+
+			RpgBenchmark::DoNotOptimize(equalCount);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "String/Hash_1k", NAME_COUNT, [&strings]()
+		{
+			uint64_t hash = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				hash ^= RpgPlatformMemory::CStringHash(*strings[i]);
+			}
+
+			RpgBenchmark::DoNotOptimize(hash);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "String/Hash_IgnoreCase_1k", NAME_COUNT, [&strings]()
+		{
+			uint64_t hash = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				hash ^= RpgPlatformMemory::CStringHash(*strings[i], true);
+			}
+
+			RpgBenchmark::DoNotOptimize(hash);
+		});
+	}
+
+
+	static void Name() noexcept
+	{
+		const RpgArray<RpgString> strings = GenerateStrings(NAME_COUNT, "Actor");
+		const RpgArray<RpgString> stringsUpper = GenerateStrings(NAME_COUNT, "ACTOR");
+
+		RpgArray<RpgName> names(NAME_COUNT);
+		for (int i = 0; i < NAME_COUNT; ++i)
+		{
+			names[i] = *strings[i];
+		}
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Name/FindOrAdd_Existing_1k", NAME_COUNT, [&strings]()
+		{
+			uint32_t id = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				id ^= RpgName(*strings[i]).GetId();
+			}
+
+			RpgBenchmark::DoNotOptimize(id);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Name/FindOrAdd_Existing_IgnoreCase_1k", NAME_COUNT, [&stringsUpper]()
+		{
+			uint32_t id = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				id ^= RpgName(*stringsUpper[i]).GetId();
+			}
+
+			RpgBenchmark::DoNotOptimize(id);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Name/Format_Existing_1k", NAME_COUNT, []()
+		{
+			uint32_t id = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				id ^= RpgName::Format("Actor_%i_Mesh_Component", i).GetId();
+			}
+
+			RpgBenchmark::DoNotOptimize(id);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Name/Equals_1k", NAME_COUNT, [&names]()
+		{
+			int equalCount = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				equalCount += (names[i] == names[NAME_COUNT - 1 - i]) ? 1 : 0;
+			}
+
+			RpgBenchmark::DoNotOptimize(equalCount);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Name/Hash_1k", NAME_COUNT, [&names]()
+		{
+			uint64_t hash = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				hash ^= Rpg_GetHash(names[i]);
+			}
+
+			RpgBenchmark::DoNotOptimize(hash);
+		});
+
+
+		// Map keyed by string vs interned name
+		RpgMap<RpgString, int> stringMap;
+		RpgMap<RpgName, int> nameMap;
+
+		for (int i = 0; i < NAME_COUNT; ++i)
+		{
+			stringMap.Add(strings[i], i);
+			nameMap.Add(names[i], i);
+		}
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Map/StringKey_Find_1k", NAME_COUNT, [&stringMap, &strings]()
+		{
+			int sum = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				sum += *stringMap.GetValueByKey(strings[i]);
+			}
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Map/NameKey_Find_1k", NAME_COUNT, [&nameMap, &names]()
+		{
+			int sum = 0;
+
+			for (int i = 0; i < NAME_COUNT; ++i)
+			{
+				sum += *nameMap.GetValueByKey(names[i]);
+			}
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+	}
+
+};
+
+
+void RpgBenchmarkSuite::String() noexcept
+{
+	RpgBenchmarkString::String();
+	RpgBenchmarkString::Name();
+}
@@ -0,0 +1,608 @@
+#include "RpgBenchmark.h"
+#include "core/RpgThreadPool.h"
+#include "core/dsa/RpgQueue.h"
+#include <algorithm>
+#include <atomic>
+
+
+
+#define RPG_BENCHMARK_SUITE		"Thread"
+
+
+namespace RpgBenchmarkThread
+{
+	class FEmptyTask : public RpgThreadTask
+	{
+	public:
+		virtual void Execute() noexcept override
+		{
+		}
+
+		virtual const char* GetTaskName() const noexcept override
+		{
+			return "Benchmark_Empty";
+		}
+	};
+
+
+	class FCounterTask : public RpgThreadTask
+	{
+	public:
+		std::atomic<int>* Counter{ nullptr };
+
+		virtual void Execute() noexcept override
+		{
+			Counter->fetch_add(1, std::memory_order_relaxed);
+		}
+
+		virtual const char* GetTaskName() const noexcept override
+		{
+			return "Benchmark_Counter";
+		}
+	};
+
+
+	// Background task that submits background subtasks and waits for them (e.g. model import waiting on its texture imports)
+	class FBackgroundParentTask : public RpgThreadTask
+	{
+	public:
+		static constexpr int CHILD_COUNT = 8;
+
+		FCounterTask Children[CHILD_COUNT];
+
+
+		FBackgroundParentTask() noexcept
+		{
+			SetPriority(RpgThreadTaskPriority::BACKGROUND);
+
+			for (int i = 0; i < CHILD_COUNT; ++i)
+			{
+				Children[i].SetPriority(RpgThreadTaskPriority::BACKGROUND);
+			}
+		}
+
+
+		virtual void Execute() noexcept override
+		{
+			RpgThreadTask* childPtrs[CHILD_COUNT];
+
+			for (int i = 0; i < CHILD_COUNT; ++i)
+			{
+				Children[i].Reset();
+				childPtrs[i] = &Children[i];
+			}
+
+			RpgThreadPool::SubmitTasks(childPtrs, CHILD_COUNT);
+			RPG_THREAD_TASK_WaitAll(childPtrs, CHILD_COUNT);
+		}
+
+
+		virtual const char* GetTaskName() const noexcept override
+		{
+			return "Benchmark_BackgroundParent";
+		}
+	};
+
+
+	// Roughly the work of animating one skeleton: concatenate local bone matrices down the bone chain
+	class FAnimationTask : public RpgThreadTask
+	{
+	public:
+		static constexpr int BONE_COUNT = 64;
+
+		float LocalMatrices[BONE_COUNT][16];
+		float WorldMatrices[BONE_COUNT][16];
+
+
+		FAnimationTask() noexcept
+		{
+			RpgBenchmark::FRandom random;
+
+			for (int b = 0; b < BONE_COUNT; ++b)
+			{
+				for (int e = 0; e < 16; ++e)
+				{
+					LocalMatrices[b][e] = random.NextFloat();
+				}
+			}
+		}
+
+
+		virtual void Execute() noexcept override
+		{
+			RpgPlatformMemory::MemCopy(WorldMatrices[0], LocalMatrices[0], sizeof(float) * 16);
+
+			for (int b = 1; b < BONE_COUNT; ++b)
+			{
+				const float* local = LocalMatrices[b];
+				const float* parent = WorldMatrices[b - 1];
+				float* world = WorldMatrices[b];
+
+				for (int r = 0; r < 4; ++r)
+				{
+					for (int c = 0; c < 4; ++c)
+					{
+						world[r * 4 + c] = local[r * 4 + 0] * parent[0 * 4 + c] + local[r * 4 + 1] * parent[1 * 4 + c] +
+							local[r * 4 + 2] * parent[2 * 4 + c] + local[r * 4 + 3] * parent[3 * 4 + c];
+					}
+				}
+			}
+
+			RpgBenchmark::DoNotOptimize(WorldMatrices[BONE_COUNT - 1][0]);
+		}
+
+
+		virtual const char* GetTaskName() const noexcept override
+		{
+			return "Benchmark_Animation";
+		}
+	};
+
+
+	// Number of tasks submitted per iteration in contended submit benchmark
+	constexpr int SUBMIT_TASK_COUNT = 10240;
+	constexpr int SUBMIT_THREAD_COUNT = 4;
+
+
+	struct FSubmitContext
+	{
+		RpgThreadTask** Tasks{ nullptr };
+		int TaskCount{ 0 };
+	};
+
+
+	// Submit tasks one by one, every submit contends with other submitters and with workers popping the queue
+	static int SDLCALL SubmitTasksOneByOne(void* data) noexcept
+	{
+		FSubmitContext* context = static_cast<FSubmitContext*>(data);
+
+		for (int i = 0; i < context->TaskCount; ++i)
+		{
+			RpgThreadPool::SubmitTasks(&context->Tasks[i], 1);
+		}
+
+		return 0;
+	}
+
+
+	static void Task() noexcept
+	{
+		{
+			FEmptyTask task;
+			RpgThreadTask* taskPtr = &task;
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Task/SubmitWait_Single", 1, [&task, &taskPtr]()
+			{
+				task.Reset();
+				RpgThreadPool::SubmitTasks(&taskPtr, 1);
+				task.Wait();
+			});
+		}
+
+		{
+			constexpr int TASK_COUNT = 256;
+
+			RpgArray<FEmptyTask> tasks(TASK_COUNT);
+			RpgArray<RpgThreadTask*> taskPtrs(TASK_COUNT);
+
+			for (int i = 0; i < TASK_COUNT; ++i)
+			{
+				taskPtrs[i] = &tasks[i];
+			}
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Task/SubmitWaitAll_256", TASK_COUNT, [&tasks, &taskPtrs]()
+			{
+				for (int i = 0; i < TASK_COUNT; ++i)
+				{
+					tasks[i].Reset();
+				}
+
+				RpgThreadPool::SubmitTasks(taskPtrs.GetData(), TASK_COUNT);
+				RPG_THREAD_TASK_WaitAll(taskPtrs, TASK_COUNT);
+			});
+		}
+
+		{
+			RpgArray<FEmptyTask> tasks(SUBMIT_TASK_COUNT);
+			RpgArray<RpgThreadTask*> taskPtrs(SUBMIT_TASK_COUNT);
+
+			for (int i = 0; i < SUBMIT_TASK_COUNT; ++i)
+			{
+				taskPtrs[i] = &tasks[i];
+			}
+
+			FSubmitContext contexts[SUBMIT_THREAD_COUNT];
+			constexpr int TASK_PER_THREAD = SUBMIT_TASK_COUNT / SUBMIT_THREAD_COUNT;
+
+			for (int t = 0; t < SUBMIT_THREAD_COUNT; ++t)
+			{
+				contexts[t].Tasks = taskPtrs.GetData(t * TASK_PER_THREAD);
+				contexts[t].TaskCount = TASK_PER_THREAD;
+			}
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Task/SubmitContended_4T_10k", SUBMIT_TASK_COUNT, [&tasks, &taskPtrs, &contexts]()
+			{
+				for (int i = 0; i < SUBMIT_TASK_COUNT; ++i)
+				{
+					tasks[i].Reset();
+				}
+
+				SDL_Thread* threads[SUBMIT_THREAD_COUNT];
+
+				for (int t = 0; t < SUBMIT_THREAD_COUNT; ++t)
+				{
+					threads[t] = SDL_CreateThread(SubmitTasksOneByOne, "Benchmark_Submitter", &contexts[t]);
+					RPG_Check(threads[t]);
+				}
+
+				// Every task must have been submitted before waiting, waiting on idle task returns immediately
+				for (int t = 0; t < SUBMIT_THREAD_COUNT; ++t)
+				{
+					SDL_WaitThread(threads[t], nullptr);
+				}
+
+				RPG_THREAD_TASK_WaitAll(taskPtrs, SUBMIT_TASK_COUNT);
+			});
+		}
+
+		{
+			constexpr int ANIMATION_TASK_COUNT = 512;
+
+			RpgArray<FAnimationTask> tasks(ANIMATION_TASK_COUNT);
+			RpgArray<RpgThreadTask*> taskPtrs(ANIMATION_TASK_COUNT + 1);
+			FEmptyTask waitTask;
+
+			// Task waited by main thread is submitted first, all animation tasks are queued behind it.
+			// Time over the baseline is the cost of main thread waiting on one task while hundreds are outstanding
+			taskPtrs[0] = &waitTask;
+
+			for (int i = 0; i < ANIMATION_TASK_COUNT; ++i)
+			{
+				taskPtrs[i + 1] = &tasks[i];
+			}
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Task/WaitOne_AnimationQueued_512", 1, [&tasks, &taskPtrs, &waitTask]()
+			{
+				waitTask.Reset();
+
+				for (int i = 0; i < ANIMATION_TASK_COUNT; ++i)
+				{
+					tasks[i].Reset();
+				}
+
+				RpgThreadPool::SubmitTasks(taskPtrs.GetData(), ANIMATION_TASK_COUNT + 1);
+				waitTask.Wait();
+
+				// Tasks must be done before next iteration resets them
+				RPG_THREAD_TASK_WaitAll(taskPtrs, ANIMATION_TASK_COUNT + 1);
+			});
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Task/Baseline_SubmitWaitAll_Animation_512", 1, [&tasks, &taskPtrs]()
+			{
+				for (int i = 0; i < ANIMATION_TASK_COUNT; ++i)
+				{
+					tasks[i].Reset();
+				}
+
+				RpgThreadPool::SubmitTasks(taskPtrs.GetData(1), ANIMATION_TASK_COUNT);
+				RPG_THREAD_TASK_WaitAll(taskPtrs.GetData(1), ANIMATION_TASK_COUNT);
+			});
+		}
+
+		{
+			constexpr int CHAIN_COUNT = 64;
+
+			std::atomic<int> counter{ 0 };
+			RpgArray<FCounterTask> tasks(CHAIN_COUNT);
+			RpgArray<RpgThreadTask*> taskPtrs(CHAIN_COUNT);
+
+			for (int i = 0; i < CHAIN_COUNT; ++i)
+			{
+				tasks[i].Counter = &counter;
+				taskPtrs[i] = &tasks[i];
+			}
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Task/DependencyChain_64", CHAIN_COUNT, [&tasks, &taskPtrs]()
+			{
+				for (int i = 0; i < CHAIN_COUNT; ++i)
+				{
+					tasks[i].Reset();
+				}
+
+				for (int i = 1; i < CHAIN_COUNT; ++i)
+				{
+					tasks[i].AddDependency(&tasks[i - 1]);
+				}
+
+				RpgThreadPool::SubmitTasks(taskPtrs.GetData(), CHAIN_COUNT);
+				tasks[CHAIN_COUNT - 1].Wait();
+			});
+		}
+
+		{
+			constexpr int PARENT_COUNT = 4;
+
+			std::atomic<int> counter{ 0 };
+			FBackgroundParentTask tasks[PARENT_COUNT];
+			RpgThreadTask* taskPtrs[PARENT_COUNT];
+
+			for (int i = 0; i < PARENT_COUNT; ++i)
+			{
+				for (int c = 0; c < FBackgroundParentTask::CHILD_COUNT; ++c)
+				{
+					tasks[i].Children[c].Counter = &counter;
+				}
+
+				taskPtrs[i] = &tasks[i];
+			}
+
+			// Every background slot is taken by a parent waiting on its children. Hangs if the parent cannot run them itself
+			const int prevBackgroundWorkerLimit = RpgThreadPool::GetBackgroundWorkerLimit();
+			RpgThreadPool::SetBackgroundWorkerLimit(1);
+
+			RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Task/BackgroundNestedWait_Limit1_4x8", PARENT_COUNT * FBackgroundParentTask::CHILD_COUNT, [&tasks, &taskPtrs, &counter]()
+			{
+				counter.store(0, std::memory_order_relaxed);
+
+				for (int i = 0; i < PARENT_COUNT; ++i)
+				{
+					tasks[i].Reset();
+				}
+
+				RpgThreadPool::SubmitTasks(taskPtrs, PARENT_COUNT);
+				RPG_THREAD_TASK_WaitAll(taskPtrs, PARENT_COUNT);
+
+				RPG_ValidateV(counter.load(std::memory_order_relaxed) == PARENT_COUNT * FBackgroundParentTask::CHILD_COUNT, "Task/BackgroundNestedWait: Subtask count mismatch!");
+			});
+
+			RpgThreadPool::SetBackgroundWorkerLimit(prevBackgroundWorkerLimit);
+		}
+	}
+
+
+	static void Parallel() noexcept
+	{
+		constexpr int COUNT = 1000000;
+
+		RpgArray<int> values(COUNT);
+		RpgBenchmark::FRandom random;
+
+		for (int i = 0; i < COUNT; ++i)
+		{
+			values[i] = random.NextInt(1000);
+		}
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ParallelFor/Dispatch_Empty_64", 64, []()
+		{
+			RpgThreadPool::ParallelFor(64, 1, [](int beginIndex, int endIndex)
+			{
+				RpgBenchmark::DoNotOptimize(beginIndex);
+			});
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ParallelFor/Sum_1M", COUNT, [&values]()
+		{
+			std::atomic<int64_t> total{ 0 };
+
+			RpgThreadPool::ParallelFor(COUNT, 0, [&values, &total](int beginIndex, int endIndex)
+			{
+				int64_t sum = 0;
+
+				for (int i = beginIndex; i < endIndex; ++i)
+				{
+					sum += values[i];
+				}
+
+				total.fetch_add(sum, std::memory_order_relaxed);
+			});
+
+			RpgBenchmark::DoNotOptimize(total.load(std::memory_order_relaxed));
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ParallelFor/Baseline_Serial_Sum_1M", COUNT, [&values]()
+		{
+			int64_t sum = 0;
+
+			for (int i = 0; i < COUNT; ++i)
+			{
+				sum += values[i];
+			}
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+
+		RpgArray<int> sortValues(COUNT);
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ParallelSort/Random_1M", COUNT, [&values, &sortValues]()
+		{
+			RpgPlatformMemory::MemCopy(sortValues.GetData(), values.GetData(), sizeof(int) * COUNT);
+			RpgThreadPool::ParallelSort(sortValues.GetData(), COUNT);
+			RpgBenchmark::ClobberMemory();
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ParallelSort/Baseline_Serial_Random_1M", COUNT, [&values, &sortValues]()
+		{
+			RpgPlatformMemory::MemCopy(sortValues.GetData(), values.GetData(), sizeof(int) * COUNT);
+			RpgAlgorithm::Sort(sortValues.GetData(), COUNT);
+			RpgBenchmark::ClobberMemory();
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "ParallelSort/Baseline_StdSort_Random_1M", COUNT, [&values, &sortValues]()
+		{
+			RpgPlatformMemory::MemCopy(sortValues.GetData(), values.GetData(), sizeof(int) * COUNT);
+			std::sort(sortValues.begin(), sortValues.end());
+			RpgBenchmark::ClobberMemory();
+		});
+	}
+
+
+
+	// Number of items transferred per iteration in cross thread queue benchmarks
+	constexpr int QUEUE_ITEM_COUNT = 1 << 18;
+	constexpr int QUEUE_CAPACITY = 1024;
+	constexpr int QUEUE_MPMC_THREAD_COUNT = 4;
+
+
+	// Sum of values [0, count) pushed by one producer
+	[[nodiscard]] static inline int64_t QueueExpectedSum(int count) noexcept
+	{
+		return static_cast<int64_t>(count) * (count - 1) / 2;
+	}
+
+
+	// Spin a few times then yield, benchmark threads may outnumber cores
+	static inline void QueueBackoff(int& backoffCount) noexcept
+	{
+		if (++backoffCount < 64)
+		{
+			SDL_CPUPauseInstruction();
+		}
+		else
+		{
+			SDL_Delay(0);
+			backoffCount = 0;
+		}
+	}
+
+
+	struct FQueueContext
+	{
+		RpgQueueSPSC<int>* QueueSPSC{ nullptr };
+		RpgQueueMPMC<int>* QueueMPMC{ nullptr };
+		int ItemCount{ 0 };
+		std::atomic<int64_t>* ConsumedSum{ nullptr };
+	};
+
+
+	static int SDLCALL QueueProducerSPSC(void* data) noexcept
+	{
+		FQueueContext* context = static_cast<FQueueContext*>(data);
+		int backoffCount = 0;
+
+		for (int i = 0; i < context->ItemCount; ++i)
+		{
+			while (!context->QueueSPSC->Push(i))
+			{
+				QueueBackoff(backoffCount);
+			}
+		}
+
+		return 0;
+	}
+
+
+	static int SDLCALL QueueProducerMPMC(void* data) noexcept
+	{
+		FQueueContext* context = static_cast<FQueueContext*>(data);
+		int backoffCount = 0;
+
+		for (int i = 0; i < context->ItemCount; ++i)
+		{
+			while (!context->QueueMPMC->Push(i))
+			{
+				QueueBackoff(backoffCount);
+			}
+		}
+
+		return 0;
+	}
+
+
+	static int SDLCALL QueueConsumerMPMC(void* data) noexcept
+	{
+		FQueueContext* context = static_cast<FQueueContext*>(data);
+		int backoffCount = 0;
+		int64_t sum = 0;
+		int value = 0;
+
+		for (int i = 0; i < context->ItemCount; ++i)
+		{
+			while (!context->QueueMPMC->Pop(value))
+			{
+				QueueBackoff(backoffCount);
+			}
+
+			sum += value;
+		}
+
+		context->ConsumedSum->fetch_add(sum, std::memory_order_relaxed);
+
+		return 0;
+	}
+
+
+	static void Queue() noexcept
+	{
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Queue/SPSC_CrossThread_256k", QUEUE_ITEM_COUNT, []()
+		{
+			RpgQueueSPSC<int> queue(QUEUE_CAPACITY);
+
+			FQueueContext context;
+			context.QueueSPSC = &queue;
+			context.ItemCount = QUEUE_ITEM_COUNT;
+
+			SDL_Thread* producer = SDL_CreateThread(QueueProducerSPSC, "Benchmark_Producer", &context);
+			RPG_Check(producer);
+
+			int backoffCount = 0;
+			int64_t sum = 0;
+			int value = 0;
+			bool bInOrder = true;
+
+			for (int i = 0; i < QUEUE_ITEM_COUNT; ++i)
+			{
+				while (!queue.Pop(value))
+				{
+					QueueBackoff(backoffCount);
+				}
+
+				bInOrder &= (value == i);
+				sum += value;
+			}
+
+			SDL_WaitThread(producer, nullptr);
+
+			// Lost, duplicated or reordered item fails the run
+			RPG_ValidateV(bInOrder, "Queue/SPSC: Items popped out of FIFO order!");
+			RPG_ValidateV(sum == QueueExpectedSum(QUEUE_ITEM_COUNT), "Queue/SPSC: Consumed sum (%lld) mismatch!", static_cast<long long>(sum));
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Queue/MPMC_CrossThread_4P4C_256k", QUEUE_ITEM_COUNT, []()
+		{
+			RpgQueueMPMC<int> queue(QUEUE_CAPACITY);
+			std::atomic<int64_t> consumedSum{ 0 };
+
+			FQueueContext context;
+			context.QueueMPMC = &queue;
+			context.ItemCount = QUEUE_ITEM_COUNT / QUEUE_MPMC_THREAD_COUNT;
+			context.ConsumedSum = &consumedSum;
+
+			SDL_Thread* threads[QUEUE_MPMC_THREAD_COUNT * 2];
+
+			for (int i = 0; i < QUEUE_MPMC_THREAD_COUNT; ++i)
+			{
+				threads[i] = SDL_CreateThread(QueueProducerMPMC, "Benchmark_Producer", &context);
+				threads[QUEUE_MPMC_THREAD_COUNT + i] = SDL_CreateThread(QueueConsumerMPMC, "Benchmark_Consumer", &context);
+				RPG_Check(threads[i] && threads[QUEUE_MPMC_THREAD_COUNT + i]);
+			}
+
+			for (int i = 0; i < QUEUE_MPMC_THREAD_COUNT * 2; ++i)
+			{
+				SDL_WaitThread(threads[i], nullptr);
+			}
+
+			// Lost or duplicated item fails the run
+			const int64_t sum = consumedSum.load(std::memory_order_relaxed);
+			RPG_ValidateV(sum == QUEUE_MPMC_THREAD_COUNT * QueueExpectedSum(context.ItemCount), "Queue/MPMC: Consumed sum (%lld) mismatch!", static_cast<long long>(sum));
+		});
+	}
+
+};
+
+
+void RpgBenchmarkSuite::Thread() noexcept
+{
+	RpgBenchmarkThread::Task();
+	RpgBenchmarkThread::Parallel();
+	RpgBenchmarkThread::Queue();
+}
@@ -0,0 +1,273 @@
+#include "RpgBenchmark.h"
+#include "core/RpgAllocator.h"
+#include "core/world/RpgWorld.h"
+
+
+
+#define RPG_BENCHMARK_SUITE		"World"
+
+
+namespace RpgBenchmarkWorld
+{
+	constexpr int GAMEOBJECT_COUNT = 1000000;
+
+
+	struct FComponent
+	{
+		RPG_COMPONENT_TYPE("Benchmark - Component")
+
+	public:
+		int Value;
+
+		inline void Destroy() noexcept
+		{
+		}
+	};
+
+};
+
+
+template<>
+struct RpgComponentSnapshot<RpgBenchmarkWorld::FComponent>
+{
+	static constexpr bool bEnabled = true;
+
+	struct FRecord
+	{
+		int Value;
+	};
+
+	static inline void Save(FRecord& out_Record, const RpgBenchmarkWorld::FComponent& component, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		out_Record.Value = component.Value;
+	}
+
+	static inline void Load(RpgBenchmarkWorld::FComponent& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		component.Value = record.Value;
+	}
+};
+
+
+namespace RpgBenchmarkWorld
+{
+
+	// Run one empty frame for each frame index, frees all game objects pending destroy
+	static void FlushPendingDestroy(RpgWorld* world) noexcept
+	{
+		for (int f = 0; f < RPG_FRAME_BUFFERING; ++f)
+		{
+			RpgFrameArena::BeginFrame(f);
+			world->BeginFrame(f);
+			world->EndFrame(f);
+		}
+	}
+
+
+	static void Handle() noexcept
+	{
+		RpgWorld* world = new RpgWorld("Benchmark");
+		world->Component_Register<FComponent>();
+
+		// Every run reuses the slots freed by the previous run, generation of each slot keeps counting up
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Handle/CreateDestroy_Churn_1M", GAMEOBJECT_COUNT, [world]()
+		{
+			RpgArray<RpgGameObjectID> gameObjects(GAMEOBJECT_COUNT);
+
+			for (int i = 0; i < GAMEOBJECT_COUNT; ++i)
+			{
+				gameObjects[i] = world->GameObject_Create("GameObject");
+				world->GameObject_AddComponent<FComponent>(gameObjects[i])->Value = i;
+			}
+
+			for (int i = 0; i < GAMEOBJECT_COUNT; ++i)
+			{
+				world->GameObject_Destroy(gameObjects[i]);
+			}
+
+			FlushPendingDestroy(world);
+		});
+
+
+		RpgArray<RpgGameObjectID> gameObjects(GAMEOBJECT_COUNT);
+		RpgArray<RpgGameObjectID> staleGameObjects(GAMEOBJECT_COUNT / 2);
+
+		for (int i = 0; i < GAMEOBJECT_COUNT; ++i)
+		{
+			gameObjects[i] = world->GameObject_Create("GameObject");
+			world->GameObject_AddComponent<FComponent>(gameObjects[i])->Value = i;
+		}
+
+		// Destroy every other game object and recreate it, old handles point to reused slots with older generation
+		for (int i = 0; i < GAMEOBJECT_COUNT; i += 2)
+		{
+			staleGameObjects[i / 2] = gameObjects[i];
+			RpgGameObjectID destroy = gameObjects[i];
+			world->GameObject_Destroy(destroy);
+		}
+
+		FlushPendingDestroy(world);
+
+		for (int i = 0; i < GAMEOBJECT_COUNT; i += 2)
+		{
+			gameObjects[i] = world->GameObject_Create("GameObject");
+			world->GameObject_AddComponent<FComponent>(gameObjects[i])->Value = i;
+		}
+
+		// Random access order, defeats prefetcher like handles held by gameplay code
+		RpgArray<int> randomOrder(GAMEOBJECT_COUNT);
+		{
+			RpgBenchmark::FRandom random;
+
+			for (int i = 0; i < GAMEOBJECT_COUNT; ++i)
+			{
+				randomOrder[i] = i;
+			}
+
+			for (int i = GAMEOBJECT_COUNT - 1; i > 0; --i)
+			{
+				const int j = random.NextInt(i + 1);
+				const int temp = randomOrder[i];
+				randomOrder[i] = randomOrder[j];
+				randomOrder[j] = temp;
+			}
+		}
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Handle/IsValid_Sequential_1M", GAMEOBJECT_COUNT, [world, &gameObjects]()
+		{
+			int validCount = 0;
+
+			for (int i = 0; i < GAMEOBJECT_COUNT; ++i)
+			{
+				validCount += world->GameObject_IsValid(gameObjects[i]);
+			}
+
+			RpgBenchmark::DoNotOptimize(validCount);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Handle/IsValid_Random_1M", GAMEOBJECT_COUNT, [world, &gameObjects, &randomOrder]()
+		{
+			int validCount = 0;
+
+			for (int i = 0; i < GAMEOBJECT_COUNT; ++i)
+			{
+				validCount += world->GameObject_IsValid(gameObjects[randomOrder[i]]);
+			}
+
+			RpgBenchmark::DoNotOptimize(validCount);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Handle/IsValid_Stale_500k", GAMEOBJECT_COUNT / 2, [world, &staleGameObjects]()
+		{
+			int validCount = 0;
+
+			for (int i = 0; i < GAMEOBJECT_COUNT / 2; ++i)
+			{
+				validCount += world->GameObject_IsValid(staleGameObjects[i]);
+			}
+
+			RpgBenchmark::DoNotOptimize(validCount);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Handle/GetComponent_Random_1M", GAMEOBJECT_COUNT, [world, &gameObjects, &randomOrder]()
+		{
+			int64_t sum = 0;
+
+			for (int i = 0; i < GAMEOBJECT_COUNT; ++i)
+			{
+				sum += world->GameObject_GetComponent<FComponent>(gameObjects[randomOrder[i]])->Value;
+			}
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Query/ForEach_1M", GAMEOBJECT_COUNT, [world]()
+		{
+			int64_t sum = 0;
+
+			world->Query<FComponent>().ForEach([&sum](FComponent& component)
+			{
+				sum += component.Value;
+			});
+
+			RpgBenchmark::DoNotOptimize(sum);
+		});
+
+		delete world;
+	}
+
+
+	// Level load: create game objects one by one vs load the same game objects from snapshot data
+	static void Snapshot() noexcept
+	{
+		constexpr int COUNT = 100000;
+
+		RpgWorld* world = new RpgWorld("Benchmark");
+		world->Component_Register<FComponent>();
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Snapshot/CreatePerObject_100k", COUNT, [world]()
+		{
+			for (int i = 0; i < COUNT; ++i)
+			{
+				RpgTransform transform;
+				transform.Position = RpgVector3(static_cast<float>(i), 0.0f, 0.0f);
+
+				RpgGameObjectID gameObject = world->GameObject_Create("GameObject", transform);
+				world->GameObject_AddComponent<FComponent>(gameObject)->Value = i;
+				world->GameObject_Destroy(gameObject);
+			}
+
+			FlushPendingDestroy(world);
+		});
+
+
+		for (int i = 0; i < COUNT; ++i)
+		{
+			RpgTransform transform;
+			transform.Position = RpgVector3(static_cast<float>(i), 0.0f, 0.0f);
+
+			RpgGameObjectID gameObject = world->GameObject_Create("GameObject", transform);
+			world->GameObject_AddComponent<FComponent>(gameObject)->Value = i;
+		}
+
+		RpgArray<uint8_t> bytes;
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Snapshot/Save_100k", COUNT, [world, &bytes]()
+		{
+			world->Snapshot_Save(bytes);
+			RpgBenchmark::DoNotOptimize(bytes.GetCount());
+		});
+
+		delete world;
+
+
+		RpgWorld* loadWorld = new RpgWorld("Benchmark");
+		loadWorld->Component_Register<FComponent>();
+
+		RpgWorldSnapshotAssetTable assets;
+		RpgArray<RpgGameObjectID> gameObjects;
+
+		RpgBenchmark::Run(RPG_BENCHMARK_SUITE, "Snapshot/Load_100k", COUNT, [loadWorld, &bytes, &assets, &gameObjects]()
+		{
+			const bool bLoaded = loadWorld->Snapshot_Load(bytes.GetData(), bytes.GetCount(), assets, &gameObjects);
+			RpgBenchmark::DoNotOptimize(bLoaded);
+
+			for (int i = 0; i < gameObjects.GetCount(); ++i)
+			{
+				loadWorld->GameObject_Destroy(gameObjects[i]);
+			}
+
+			FlushPendingDestroy(loadWorld);
+		});
+
+		delete loadWorld;
+	}
+
+};
+
+
+void RpgBenchmarkSuite::World() noexcept
+{
+	RpgBenchmarkWorld::Handle();
+	RpgBenchmarkWorld::Snapshot();
+}
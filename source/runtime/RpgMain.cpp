@@ -1,5 +1,7 @@
 #include "core/RpgCommandLine.h"
 #include "core/RpgFilePath.h"
+#include "core/RpgAllocator.h"
+#include "core/RpgProfiler.h"
 #include "core/RpgThreadPool.h"
 #include "core/RpgTimer.h"
 #include "core/RpgD3D12.h"
@@ -48,6 +50,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
 	// TODO: Steam init
 
+	RpgProfiler::Initialize();
+	RpgFrameArena::Initialize();
 	RpgThreadPool::Initialize();
 
 	RpgD3D12::Initialize();
@@ -189,6 +193,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 	RpgD3D12::Shutdown();
 
 	RpgThreadPool::Shutdown();
+	RpgFrameArena::Shutdown();
+	RpgProfiler::Shutdown();
 	RpgPlatformProcess::Shutdown();
 
 	return 0;
@@ -6,7 +6,7 @@ void RpgAnimationPose::UpdateBonePoseTransforms(const RpgAnimationSkeleton* skel
 {
 	const int boneCount = skeleton->GetBoneCount();
 
-	RpgArrayInline<int, RPG_SKELETON_MAX_BONE> updateBoneIndices;
+	RpgArraySmall<int, 64> updateBoneIndices;
 	for (int b = 0; b < boneCount; ++b)
 	{
 		if (BoneDirtyTransforms[b])
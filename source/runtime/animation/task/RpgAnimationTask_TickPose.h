@@ -1,7 +1,6 @@
 #pragma once
 
 #include "core/RpgThreadPool.h"
-#include "core/dsa/RpgArray.h"
 
 
 class RpgWorld;
@@ -12,10 +11,9 @@ class RpgAnimationComponent_AnimSkeletonPose;
 class RpgAnimationTask_TickPose : public RpgThreadTask
 {
 public:
-	const RpgWorld* World;
+	RpgWorld* World;
 	float DeltaTime;
 	float GlobalPlayRate;
-	RpgArray<RpgAnimationComponent_AnimSkeletonPose*> AnimationComponents;
 
 
 public:
@@ -29,4 +27,8 @@ public:
 		return "RpgAnimationTask_TickPose";
 	}
 
+
+private:
+	void TickPose(RpgAnimationComponent_AnimSkeletonPose* comp) const noexcept;
+
 };
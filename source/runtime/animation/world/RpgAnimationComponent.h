@@ -77,3 +77,44 @@ private:
 	friend RpgAnimationTask_TickPose;
 
 };
+
+
+
+// Final pose is rebuilt from skeleton bind pose, animation restarts from its saved timer
+template<>
+struct RpgComponentSnapshot<RpgAnimationComponent_AnimSkeletonPose>
+{
+	static constexpr bool bEnabled = true;
+
+	struct FRecord
+	{
+		int SkeletonReference;
+		int ClipReference;
+		float PlayRate;
+		float AnimTimer;
+		uint8_t bLoopAnim;
+		uint8_t bPauseAnim;
+	};
+
+
+	static inline void Save(FRecord& out_Record, const RpgAnimationComponent_AnimSkeletonPose& component, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		out_Record.SkeletonReference = assets.AddReference(RpgAssetFileType::SKELETON, component.Skeleton);
+		out_Record.ClipReference = assets.AddReference(RpgAssetFileType::ANIM_CLIP, component.Clip);
+		out_Record.PlayRate = component.PlayRate;
+		out_Record.AnimTimer = component.AnimTimer;
+		out_Record.bLoopAnim = component.bLoopAnim;
+		out_Record.bPauseAnim = component.bPauseAnim;
+	}
+
+
+	static inline void Load(RpgAnimationComponent_AnimSkeletonPose& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		component.SetSkeleton(assets.Resolve<RpgSharedAnimationSkeleton>(RpgAssetFileType::SKELETON, record.SkeletonReference));
+		component.Clip = assets.Resolve<RpgSharedAnimationClip>(RpgAssetFileType::ANIM_CLIP, record.ClipReference);
+		component.PlayRate = record.PlayRate;
+		component.AnimTimer = record.AnimTimer;
+		component.bLoopAnim = record.bLoopAnim;
+		component.bPauseAnim = record.bPauseAnim;
+	}
+};
@@ -15,6 +15,8 @@ RpgAnimationWorldSubsystem::RpgAnimationWorldSubsystem() noexcept
 	GlobalPlayRate = 1.0f;
 	bDebugDrawSkeletonBones = false;
 	bTickAnimationPose = false;
+
+	DeclareComponentWrite<RpgAnimationComponent_AnimSkeletonPose>();
 }
 
 
@@ -37,47 +39,26 @@ void RpgAnimationWorldSubsystem::TickUpdate(float deltaTime) noexcept
 		return;
 	}
 
-	RpgWorld* world = GetWorld();
-
-	RpgThreadTask* submitTasks[TASK_COUNT];
-
-	// Reset tasks
-	for (int i = 0; i < TASK_COUNT; ++i)
-	{
-		RpgAnimationTask_TickPose& task = TaskTickPoses[i];
-		task.Reset();
-		task.World = world;
-		task.DeltaTime = deltaTime;
-		task.GlobalPlayRate = GlobalPlayRate;
-
-		submitTasks[i] = &task;
-	}
-
-	// Distribute tasks
-	int taskIndex = 0;
-
-	for (auto it = world->Component_CreateIterator<RpgAnimationComponent_AnimSkeletonPose>(); it; ++it)
-	{
-		RpgAnimationTask_TickPose& task = TaskTickPoses[taskIndex];
-		task.AnimationComponents.AddValue(&it.GetValue());
-		taskIndex = (taskIndex + 1) % TASK_COUNT;
-	}
+	// Tick pose task splits animation components across worker threads
+	RpgThreadTask* task = &TaskTickPose;
+	TaskTickPose.Reset();
+	TaskTickPose.World = GetWorld();
+	TaskTickPose.DeltaTime = deltaTime;
+	TaskTickPose.GlobalPlayRate = GlobalPlayRate;
 
-	RpgThreadPool::SubmitTasks(submitTasks, TASK_COUNT);
+	RpgThreadPool::SubmitTasks(&task, 1);
 }
 
 
 void RpgAnimationWorldSubsystem::Render(int frameIndex, RpgRenderer* renderer) noexcept
 {
-	RpgThreadTask* waitTasks[TASK_COUNT];
-	for (int i = 0; i < TASK_COUNT; ++i)
+	// wait task tick pose finished. This is a join rather than a dependency edge: the task is already running
+	// (edges can only be added to idle tasks) and poses are read on main thread (debug draw) and by render passes
+	if (TaskTickPose.IsRunning())
 	{
-		waitTasks[i] = &TaskTickPoses[i];
+		TaskTickPose.Wait();
 	}
 
-	// wait all task tick pose finished
-	RPG_THREAD_TASK_WaitAll(waitTasks, TASK_COUNT);
-
 
 #ifndef RPG_BUILD_SHIPPING
 	RpgWorld* world = GetWorld();
@@ -23,8 +23,7 @@ protected:
 
 
 private:
-	static constexpr int TASK_COUNT = 4;
-	RpgAnimationTask_TickPose TaskTickPoses[TASK_COUNT];
+	RpgAnimationTask_TickPose TaskTickPose;
 	bool bTickAnimationPose;
 
 };
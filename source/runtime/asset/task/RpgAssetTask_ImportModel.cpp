@@ -83,6 +83,7 @@ RpgAssetTask_ImportModel::RpgAssetTask_ImportModel() noexcept
 	bImportSkeleton = false;
 	bImportAnimation = false;
 	bGenerateTextureMipMaps = false;
+	SetPriority(RpgThreadTaskPriority::BACKGROUND);
 }
 
 
@@ -288,6 +288,7 @@ RpgAssetTask_ImportTexture::RpgAssetTask_ImportTexture() noexcept
 {
 	Format = RpgTextureFormat::TEX_2D_RGBA;
 	bGenerateMipMaps = false;
+	SetPriority(RpgThreadTaskPriority::BACKGROUND);
 }
 
 
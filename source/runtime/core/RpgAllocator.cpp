@@ -0,0 +1,281 @@
+#include "RpgAllocator.h"
+#include <atomic>
+
+
+
+namespace RpgFrameArena
+{
+	struct FBlock
+	{
+		FBlock* Next;
+		size_t SizeBytes;
+	};
+
+	// Block header is padded so that data starts at aligned address
+	constexpr size_t BLOCK_HEADER_SIZE = (sizeof(FBlock) + RPG_FRAME_ARENA_ALIGNMENT - 1) & ~static_cast<size_t>(RPG_FRAME_ARENA_ALIGNMENT - 1);
+
+
+	struct FArena
+	{
+		FBlock* FirstBlock{ nullptr };
+		FBlock* CurrentBlock{ nullptr };
+		uint8_t* Cursor{ nullptr };
+		uint8_t* End{ nullptr };
+		size_t AllocatedBytes{ 0 };
+	};
+
+
+	struct FThreadArena
+	{
+		FArena Frames[RPG_FRAME_BUFFERING];
+	};
+
+
+	static SDL_Mutex* RegistryMutex;
+	static FThreadArena** ThreadArenas;
+	static int ThreadArenaCount;
+	static int ThreadArenaCapacity;
+	static std::atomic<int> CurrentFrameIndex;
+	static bool bInitialized;
+
+	static thread_local FThreadArena* LocalThreadArena = nullptr;
+
+
+
+	static inline uint8_t* GetBlockData(FBlock* block) noexcept
+	{
+		return reinterpret_cast<uint8_t*>(block) + BLOCK_HEADER_SIZE;
+	}
+
+
+	static inline uint8_t* AlignPointer(uint8_t* ptr) noexcept
+	{
+		const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+		return reinterpret_cast<uint8_t*>((address + RPG_FRAME_ARENA_ALIGNMENT - 1) & ~static_cast<uintptr_t>(RPG_FRAME_ARENA_ALIGNMENT - 1));
+	}
+
+
+	static inline void SetCurrentBlock(FArena& arena, FBlock* block) noexcept
+	{
+		arena.CurrentBlock = block;
+		arena.Cursor = block ? GetBlockData(block) : nullptr;
+		arena.End = block ? GetBlockData(block) + block->SizeBytes : nullptr;
+	}
+
+
+	static FThreadArena* GetThreadArena() noexcept
+	{
+		if (LocalThreadArena)
+		{
+			return LocalThreadArena;
+		}
+
+		RPG_AssertV(bInitialized, "RpgFrameArena: Not initialized!");
+
+		LocalThreadArena = new FThreadArena();
+
+		SDL_LockMutex(RegistryMutex);
+		{
+			if (ThreadArenaCount == ThreadArenaCapacity)
+			{
+				ThreadArenaCapacity = (ThreadArenaCapacity > 0) ? ThreadArenaCapacity * 2 : 16;
+				ThreadArenas = reinterpret_cast<FThreadArena**>(RpgPlatformMemory::MemRealloc(ThreadArenas, sizeof(FThreadArena*) * ThreadArenaCapacity));
+			}
+
+			ThreadArenas[ThreadArenaCount++] = LocalThreadArena;
+		}
+		SDL_UnlockMutex(RegistryMutex);
+
+		return LocalThreadArena;
+	}
+
+
+	static void* AllocateFromArena(FArena& arena, size_t sizeBytes) noexcept
+	{
+		uint8_t* data = AlignPointer(arena.Cursor);
+
+		if (arena.CurrentBlock == nullptr || data + sizeBytes > arena.End)
+		{
+			// Move to next block that fits, blocks are kept from previous frames
+			FBlock* block = arena.CurrentBlock ? arena.CurrentBlock->Next : arena.FirstBlock;
+
+			while (block && block->SizeBytes < sizeBytes)
+			{
+				block = block->Next;
+			}
+
+			if (block == nullptr)
+			{
+				const size_t blockSizeBytes = (sizeBytes > RPG_FRAME_ARENA_BLOCK_SIZE) ? sizeBytes : RPG_FRAME_ARENA_BLOCK_SIZE;
+				block = reinterpret_cast<FBlock*>(RpgPlatformMemory::MemMallocAligned(BLOCK_HEADER_SIZE + blockSizeBytes, RPG_FRAME_ARENA_ALIGNMENT));
+				block->SizeBytes = blockSizeBytes;
+
+				// Insert after current block
+				if (arena.CurrentBlock)
+				{
+					block->Next = arena.CurrentBlock->Next;
+					arena.CurrentBlock->Next = block;
+				}
+				else
+				{
+					block->Next = arena.FirstBlock;
+					arena.FirstBlock = block;
+				}
+			}
+
+			SetCurrentBlock(arena, block);
+			data = arena.Cursor;
+		}
+
+		arena.Cursor = data + sizeBytes;
+		arena.AllocatedBytes += sizeBytes;
+
+		return data;
+	}
+
+};
+
+
+void RpgFrameArena::Initialize() noexcept
+{
+	if (bInitialized)
+	{
+		return;
+	}
+
+	RegistryMutex = SDL_CreateMutex();
+	CurrentFrameIndex.store(0, std::memory_order_relaxed);
+	bInitialized = true;
+}
+
+
+void RpgFrameArena::Shutdown() noexcept
+{
+	if (!bInitialized)
+	{
+		return;
+	}
+
+	for (int t = 0; t < ThreadArenaCount; ++t)
+	{
+		FThreadArena* threadArena = ThreadArenas[t];
+
+		for (int f = 0; f < RPG_FRAME_BUFFERING; ++f)
+		{
+			FBlock* block = threadArena->Frames[f].FirstBlock;
+
+			while (block)
+			{
+				FBlock* next = block->Next;
+				RpgPlatformMemory::MemFree(block);
+				block = next;
+			}
+		}
+
+		delete threadArena;
+	}
+
+	RpgPlatformMemory::MemFree(ThreadArenas);
+	ThreadArenas = nullptr;
+	ThreadArenaCount = 0;
+	ThreadArenaCapacity = 0;
+	LocalThreadArena = nullptr;
+
+	SDL_DestroyMutex(RegistryMutex);
+	RegistryMutex = nullptr;
+
+	bInitialized = false;
+}
+
+
+void RpgFrameArena::BeginFrame(int frameIndex) noexcept
+{
+	RPG_Assert(frameIndex >= 0 && frameIndex < RPG_FRAME_BUFFERING);
+
+	SDL_LockMutex(RegistryMutex);
+	{
+		for (int t = 0; t < ThreadArenaCount; ++t)
+		{
+			FArena& arena = ThreadArenas[t]->Frames[frameIndex];
+			SetCurrentBlock(arena, arena.FirstBlock);
+			arena.AllocatedBytes = 0;
+		}
+	}
+	SDL_UnlockMutex(RegistryMutex);
+
+	CurrentFrameIndex.store(frameIndex, std::memory_order_release);
+}
+
+
+void* RpgFrameArena::Allocate(size_t sizeBytes) noexcept
+{
+	FThreadArena* threadArena = GetThreadArena();
+	return AllocateFromArena(threadArena->Frames[CurrentFrameIndex.load(std::memory_order_acquire)], sizeBytes);
+}
+
+
+void* RpgFrameArena::Reallocate(void* data, size_t oldSizeBytes, size_t newSizeBytes) noexcept
+{
+	FThreadArena* threadArena = GetThreadArena();
+	FArena& arena = threadArena->Frames[CurrentFrameIndex.load(std::memory_order_acquire)];
+
+	if (data)
+	{
+		uint8_t* bytes = static_cast<uint8_t*>(data);
+
+		// Last allocation, grow in place
+		if (bytes + oldSizeBytes == arena.Cursor && bytes + newSizeBytes <= arena.End)
+		{
+			arena.Cursor = bytes + newSizeBytes;
+			arena.AllocatedBytes += newSizeBytes - oldSizeBytes;
+
+			return data;
+		}
+	}
+
+	void* newData = AllocateFromArena(arena, newSizeBytes);
+
+	if (data && oldSizeBytes > 0)
+	{
+		RpgPlatformMemory::MemCopy(newData, data, (oldSizeBytes < newSizeBytes) ? oldSizeBytes : newSizeBytes);
+	}
+
+	return newData;
+}
+
+
+void RpgFrameArena::Free(void* data, size_t sizeBytes) noexcept
+{
+	if (data == nullptr || LocalThreadArena == nullptr)
+	{
+		return;
+	}
+
+	FArena& arena = LocalThreadArena->Frames[CurrentFrameIndex.load(std::memory_order_acquire)];
+	uint8_t* bytes = static_cast<uint8_t*>(data);
+
+	// Last allocation, roll back the cursor
+	if (bytes + sizeBytes == arena.Cursor)
+	{
+		arena.Cursor = bytes;
+		arena.AllocatedBytes -= sizeBytes;
+	}
+}
+
+
+size_t RpgFrameArena::GetAllocatedBytes() noexcept
+{
+	const int frameIndex = CurrentFrameIndex.load(std::memory_order_acquire);
+	size_t allocatedBytes = 0;
+
+	SDL_LockMutex(RegistryMutex);
+	{
+		for (int t = 0; t < ThreadArenaCount; ++t)
+		{
+			allocatedBytes += ThreadArenas[t]->Frames[frameIndex].AllocatedBytes;
+		}
+	}
+	SDL_UnlockMutex(RegistryMutex);
+
+	return allocatedBytes;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "RpgPlatform.h"
+
+
+
+// Default alignment of frame arena allocation
+#define RPG_FRAME_ARENA_ALIGNMENT		16
+
+// Size of each frame arena memory block. Allocation larger than this gets its own block.
+#define RPG_FRAME_ARENA_BLOCK_SIZE		(1024 * 1024)
+
+
+
+// Per-thread linear allocator that resets every frame.
+// Each thread (main thread, worker threads) owns RPG_FRAME_BUFFERING arenas, one for each frame index.
+// Memory allocated during frame index N stays valid until BeginFrame(N) is called again, RPG_FRAME_BUFFERING frames later.
+// Do not use it in background tasks that may live longer than RPG_FRAME_BUFFERING frames.
+namespace RpgFrameArena
+{
+	// Initialize frame arena. Must be called from main thread before any allocation
+	// @returns None
+	void Initialize() noexcept;
+
+
+	// Shutdown frame arena and free memory of all threads. All threads that use frame arena must have been stopped
+	// @returns None
+	void Shutdown() noexcept;
+
+
+	// [Main thread] Reset arenas of all threads for <frameIndex> and make it current frame index
+	// @param frameIndex - Frame index [0, RPG_FRAME_BUFFERING)
+	// @returns None
+	void BeginFrame(int frameIndex) noexcept;
+
+
+	// Allocate memory from calling thread arena for current frame
+	// @param sizeBytes - Size to allocate in bytes
+	// @returns Pointer to allocated memory aligned to RPG_FRAME_ARENA_ALIGNMENT
+	[[nodiscard]] void* Allocate(size_t sizeBytes) noexcept;
+
+
+	// Reallocate memory from calling thread arena. Grows in place if <data> is the last allocation of calling thread.
+	// @param data - Previous allocation or nullptr
+	// @param oldSizeBytes - Size of previous allocation in bytes
+	// @param newSizeBytes - New size in bytes
+	// @returns Pointer to allocated memory aligned to RPG_FRAME_ARENA_ALIGNMENT
+	[[nodiscard]] void* Reallocate(void* data, size_t oldSizeBytes, size_t newSizeBytes) noexcept;
+
+
+	// Give back memory if <data> is the last allocation of calling thread, otherwise it's released on next BeginFrame
+	// @param data - Allocation to free
+	// @param sizeBytes - Size of allocation in bytes
+	// @returns None
+	void Free(void* data, size_t sizeBytes) noexcept;
+
+
+	// Get number of bytes allocated from all thread arenas of current frame
+	// @returns Allocated size in bytes
+	[[nodiscard]] size_t GetAllocatedBytes() noexcept;
+
+};
+
+
+
+// Container allocator policy. General purpose heap (mimalloc)
+struct RpgAllocatorHeap
+{
+	[[nodiscard]] static inline void* Reallocate(void* data, size_t oldSizeBytes, size_t newSizeBytes) noexcept
+	{
+		return RpgPlatformMemory::MemRealloc(data, newSizeBytes);
+	}
+
+	static inline void Free(void* data, size_t sizeBytes) noexcept
+	{
+		RpgPlatformMemory::MemFree(data);
+	}
+};
+
+
+// Container allocator policy. Per-thread frame arena, for transient containers that live within a frame
+struct RpgAllocatorFrame
+{
+	[[nodiscard]] static inline void* Reallocate(void* data, size_t oldSizeBytes, size_t newSizeBytes) noexcept
+	{
+		return RpgFrameArena::Reallocate(data, oldSizeBytes, newSizeBytes);
+	}
+
+	static inline void Free(void* data, size_t sizeBytes) noexcept
+	{
+		RpgFrameArena::Free(data, sizeBytes);
+	}
+};
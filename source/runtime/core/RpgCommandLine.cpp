@@ -1,16 +1,20 @@
 #include "RpgCommandLine.h"
 
 
+#define RPG_COMMAND_LINE_MAX_ARGUMENT		16
+#define RPG_COMMAND_LINE_NAME_LENGTH		32	// Includes null terminator
+#define RPG_COMMAND_LINE_VALUE_LENGTH		256	// Includes null terminator. Large enough for file path
+
 
 namespace RpgCommandLine
 {
 	struct FArgument
 	{
-		char Name[32];
-		char Value[32];
+		char Name[RPG_COMMAND_LINE_NAME_LENGTH];
+		char Value[RPG_COMMAND_LINE_VALUE_LENGTH];
 	};
 
-	static FArgument ArgumentArray[16];
+	static FArgument ArgumentArray[RPG_COMMAND_LINE_MAX_ARGUMENT];
 	static int ArgumentCount;
 	static bool bInitialized;
 };
@@ -35,14 +39,15 @@ void RpgCommandLine::Initialize(const char* commandArgs) noexcept
 
 	for (int i = 0; i <= len; ++i)
 	{
-		if (commandArgs[i] == '-')
+		// Dash only starts a new argument at the beginning of a word, values may contain dash (file path)
+		if (commandArgs[i] == '-' && (i == 0 || commandArgs[i - 1] == ' '))
 		{
 			if (i + 1 < len)
 			{
 				nameIndex = i + 1;
 			}
 		}
-		else if (commandArgs[i] == '=')
+		else if (commandArgs[i] == '=' && valueIndex == -1)
 		{
 			if (i + 1 < len)
 			{
@@ -66,8 +71,19 @@ void RpgCommandLine::Initialize(const char* commandArgs) noexcept
 					nameLength = i - nameIndex;
 				}
 
-				if (nameLength > 0)
+				if (nameLength > 0 && ArgumentCount < RPG_COMMAND_LINE_MAX_ARGUMENT)
 				{
+					// Truncate
+					if (nameLength >= RPG_COMMAND_LINE_NAME_LENGTH)
+					{
+						nameLength = RPG_COMMAND_LINE_NAME_LENGTH - 1;
+					}
+
+					if (valueLength >= RPG_COMMAND_LINE_VALUE_LENGTH)
+					{
+						valueLength = RPG_COMMAND_LINE_VALUE_LENGTH - 1;
+					}
+
 					FArgument& arg = ArgumentArray[ArgumentCount++];
 					RpgPlatformMemory::MemZero(&arg, sizeof(FArgument));
 					RpgPlatformMemory::MemCopy(&arg.Name, commandArgs + nameIndex, nameLength);
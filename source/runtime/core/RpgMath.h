@@ -1270,6 +1270,13 @@ public:
 	}
 
 
+	// Get 6 normalized planes (near, far, right, left, top, bottom). Plane normals point outward, point is inside if dot(normal, point) + d <= 0
+	inline void GetPlanes(RpgVector4 out_Planes[6]) const noexcept
+	{
+		DxBoundingFrustum.GetPlanes(&out_Planes[0].Xmm, &out_Planes[1].Xmm, &out_Planes[2].Xmm, &out_Planes[3].Xmm, &out_Planes[4].Xmm, &out_Planes[5].Xmm);
+	}
+
+
 	inline bool TestIntersectAABB(const RpgBoundingAABB& boundingAABB) const noexcept
 	{
 		DirectX::XMFLOAT3 aabbCenter;
@@ -1,11 +1,20 @@
 #include "RpgPlatform.h"
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cstddef>
+
+#ifndef RPG_PLATFORM_NO_MIMALLOC
 #include <mimalloc-new-delete.h>
+#endif // !RPG_PLATFORM_NO_MIMALLOC
 
 
 
 // ========================================================================================================================= //
 // PLATFORM - MEMORY
 // ========================================================================================================================= //
+#ifndef RPG_PLATFORM_NO_MIMALLOC
+
 void* RpgPlatformMemory::MemMalloc(size_t sizeBytes) noexcept
 {
 	return mi_malloc(sizeBytes);
@@ -35,6 +44,46 @@ void RpgPlatformMemory::MemFree(void* alloc) noexcept
 	mi_free(alloc);
 }
 
+#else
+
+// C runtime fallback. MemMallocAligned memory is freed with MemFree, so it must come from the same heap as malloc (no _aligned_malloc).
+void* RpgPlatformMemory::MemMalloc(size_t sizeBytes) noexcept
+{
+	return malloc(sizeBytes);
+}
+
+
+void* RpgPlatformMemory::MemMallocAligned(size_t sizeBytes, size_t alignmentBytes) noexcept
+{
+	if (alignmentBytes <= alignof(std::max_align_t))
+	{
+		return malloc(sizeBytes);
+	}
+
+	return aligned_alloc(alignmentBytes, (sizeBytes + alignmentBytes - 1) & ~(alignmentBytes - 1));
+}
+
+
+void* RpgPlatformMemory::MemRealloc(void* prevAlloc, size_t newSizeBytes) noexcept
+{
+	return realloc(prevAlloc, newSizeBytes);
+}
+
+
+void* RpgPlatformMemory::MemRecalloc(void* prevAlloc, int count, size_t sizeBytes) noexcept
+{
+	RPG_Check(prevAlloc == nullptr);
+	return calloc(count, sizeBytes);
+}
+
+
+void RpgPlatformMemory::MemFree(void* alloc) noexcept
+{
+	free(alloc);
+}
+
+#endif // !RPG_PLATFORM_NO_MIMALLOC
+
 
 void RpgPlatformMemory::MemCopy(void* dst, const void* src, size_t sizeBytes) noexcept
 {
@@ -95,6 +144,8 @@ bool RpgPlatformMemory::CStringCompare(const char* cstrA, const char* cstrB, boo
 				return false;
 			}
 		}
+
+		return true;
 	}
 
 	return strcmp(cstrA, cstrB) == 0;
@@ -131,7 +182,7 @@ int RpgPlatformMemory::CStringToInt(const char* cstr) noexcept
 }
 
 
-uint64_t RpgPlatformMemory::CStringHash(const char* cstr) noexcept
+uint64_t RpgPlatformMemory::CStringHash(const char* cstr, bool bIgnoreCase) noexcept
 {
 	const int len = CStringLength(cstr);
 	if (len == 0)
@@ -143,7 +194,7 @@ uint64_t RpgPlatformMemory::CStringHash(const char* cstr) noexcept
 
 	for (int i = 0; i < len; ++i)
 	{
-		hash += cstr[i];
+		hash += bIgnoreCase ? tolower(static_cast<unsigned char>(cstr[i])) : cstr[i];
 		hash += (hash << 10);
 		hash ^= (hash >> 6);
 	}
@@ -161,7 +212,9 @@ uint64_t RpgPlatformMemory::CStringHash(const char* cstr) noexcept
 // ========================================================================================================================= //
 // PLATFORM - CONSOLE
 // ========================================================================================================================= //
+#if RPG_PLATFORM_WINDOWS
 #define RPG_WINDOWS_CONSOLE_DEFAULT_ATTRIBUTES		(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY)
+#endif // RPG_PLATFORM_WINDOWS
 
 
 namespace RpgPlatformConsole
@@ -171,6 +224,8 @@ namespace RpgPlatformConsole
 };
 
 
+#if RPG_PLATFORM_WINDOWS
+
 void RpgPlatformConsole::Initialize() noexcept
 {
 	if (bInitialized)
@@ -237,6 +292,46 @@ void RpgPlatformConsole::OutputMessage(const char* message, int messageLength, E
 	SetConsoleTextAttribute(consoleHandle, RPG_WINDOWS_CONSOLE_DEFAULT_ATTRIBUTES);
 }
 
+#else
+
+void RpgPlatformConsole::Initialize() noexcept
+{
+	// Process is already attached to terminal (stdout)
+	bInitialized = true;
+}
+
+
+void RpgPlatformConsole::OutputMessage(const char* message, int messageLength, EOutputColor color) noexcept
+{
+	if (!bInitialized || message == nullptr || messageLength == 0)
+	{
+		return;
+	}
+
+	const char* colorCode = nullptr;
+
+	switch (color)
+	{
+		case OUTPUT_COLOR_GREEN: colorCode = "\x1b[92m"; break;
+		case OUTPUT_COLOR_YELLOW: colorCode = "\x1b[93m"; break;
+		case OUTPUT_COLOR_RED: colorCode = "\x1b[91m"; break;
+		default: break;
+	}
+
+	if (colorCode)
+	{
+		fputs(colorCode, stdout);
+		fwrite(message, 1, messageLength, stdout);
+		fputs("\x1b[0m", stdout);
+	}
+	else
+	{
+		fwrite(message, 1, messageLength, stdout);
+	}
+}
+
+#endif // RPG_PLATFORM_WINDOWS
+
 
 
 
@@ -246,8 +341,13 @@ void RpgPlatformConsole::OutputMessage(const char* message, int messageLength, E
 namespace RpgPlatformLog
 {
 	static EVerbosity GlobalVerbosity;
+#if RPG_PLATFORM_WINDOWS
 	static HANDLE OutputFileHandle;
 	static CRITICAL_SECTION OutputFileCS;
+#else
+	static FILE* OutputFileHandle;
+	static SDL_SpinLock OutputFileLock;
+#endif // RPG_PLATFORM_WINDOWS
 	static bool bInitialized;
 };
 
@@ -263,8 +363,12 @@ void RpgPlatformLog::Initialize(EVerbosity in_GlobalVerbosity, const char* opt_O
 
 	if (opt_OutputLogFilePath)
 	{
+#if RPG_PLATFORM_WINDOWS
 		OutputFileHandle = CreateFileA(opt_OutputLogFilePath, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
 		InitializeCriticalSection(&OutputFileCS);
+#else
+		OutputFileHandle = fopen(opt_OutputLogFilePath, "w");
+#endif // RPG_PLATFORM_WINDOWS
 	}
 
 	bInitialized = true;
@@ -280,10 +384,15 @@ void RpgPlatformLog::Shutdown() noexcept
 
 	if (OutputFileHandle)
 	{
+#if RPG_PLATFORM_WINDOWS
 		CloseHandle(OutputFileHandle);
 		OutputFileHandle = NULL;
 
 		DeleteCriticalSection(&OutputFileCS);
+#else
+		fclose(OutputFileHandle);
+		OutputFileHandle = nullptr;
+#endif // RPG_PLATFORM_WINDOWS
 	}
 
 	bInitialized = false;
@@ -304,6 +413,7 @@ void RpgPlatformLog::OutputMessage(RpgPlatformConsole::EOutputColor consoleOutpu
 		return;
 	}
 
+#if RPG_PLATFORM_WINDOWS
 	OutputDebugString(message);
 
 	EnterCriticalSection(&OutputFileCS);
@@ -316,6 +426,18 @@ void RpgPlatformLog::OutputMessage(RpgPlatformConsole::EOutputColor consoleOutpu
 	}
 
 	LeaveCriticalSection(&OutputFileCS);
+#else
+	SDL_LockSpinlock(&OutputFileLock);
+
+	RpgPlatformConsole::OutputMessage(message, len, consoleOutputColor);
+
+	if (OutputFileHandle)
+	{
+		fwrite(message, 1, len, OutputFileHandle);
+	}
+
+	SDL_UnlockSpinlock(&OutputFileLock);
+#endif // RPG_PLATFORM_WINDOWS
 }
 
 
@@ -392,17 +514,21 @@ RPG_LOG_DEFINE_CATEGORY(RpgLogSystem, VERBOSITY_LOG)
 // ========================================================================================================================= //
 // PLATFORM - PROCESS
 // ========================================================================================================================= //
+#ifndef RPG_PLATFORM_NO_MIMALLOC
 static void Rpg_MimallocOutput(const char* msg, void* arg)
 {
 	RpgPlatformLog::OutputMessage(RpgPlatformConsole::OUTPUT_COLOR_GREEN, msg);
 }
+#endif // !RPG_PLATFORM_NO_MIMALLOC
 
 
 
 namespace RpgPlatformProcess
 {
 	static SDL_ThreadID MainThreadId;
+#if RPG_PLATFORM_WINDOWS
 	static HWND MainWindowHandle;
+#endif // RPG_PLATFORM_WINDOWS
 	static bool bInitialized;
 };
 
@@ -414,8 +540,9 @@ void RpgPlatformProcess::Initialize() noexcept
 		return;
 	}
 
-	RPG_Log(RpgLogSystem, "Initialize platform process [WINDOWS]");
+	RPG_Log(RpgLogSystem, "Initialize platform process [%s]", SDL_GetPlatform());
 
+#ifndef RPG_PLATFORM_NO_MIMALLOC
 	mi_option_enable(mi_option_allow_large_os_pages);
 
 #ifndef RPG_BUILD_SHIPPING
@@ -423,8 +550,14 @@ void RpgPlatformProcess::Initialize() noexcept
 	mi_version();
 	mi_stats_reset();
 #endif // !RPG_BUILD_SHIPPING
+#endif // !RPG_PLATFORM_NO_MIMALLOC
 
+#if RPG_PLATFORM_WINDOWS
 	RPG_RuntimeErrorCheck(SDL_Init(SDL_INIT_VIDEO), "SDL initialization failed!");
+#else
+	// Non-windows builds are headless tools (benchmark), no video subsystem
+	RPG_RuntimeErrorCheck(SDL_Init(SDL_INIT_EVENTS), "SDL initialization failed!");
+#endif // RPG_PLATFORM_WINDOWS
 
 	MainThreadId = SDL_GetCurrentThreadID();
 
@@ -439,7 +572,7 @@ void RpgPlatformProcess::Shutdown() noexcept
 		return;
 	}
 
-	RPG_Log(RpgLogSystem, "Shutdown platform process [WINDOWS]");
+	RPG_Log(RpgLogSystem, "Shutdown platform process [%s]", SDL_GetPlatform());
 
 	SDL_Quit();
 
@@ -447,6 +580,8 @@ void RpgPlatformProcess::Shutdown() noexcept
 }
 
 
+#if RPG_PLATFORM_WINDOWS
+
 void RpgPlatformProcess::Exit(uint32_t code) noexcept
 {
 	ExitProcess(code);
@@ -471,6 +606,22 @@ HWND RpgPlatformProcess::GetMainWindowHandle() noexcept
 	return MainWindowHandle;
 }
 
+#else
+
+void RpgPlatformProcess::Exit(uint32_t code) noexcept
+{
+	fflush(stdout);
+	_Exit(static_cast<int>(code));
+}
+
+
+void RpgPlatformProcess::ShowMessageBoxError(const char* title, const char* message) noexcept
+{
+	// Headless, message has already been written to log output
+}
+
+#endif // RPG_PLATFORM_WINDOWS
+
 
 uint32_t RpgPlatformProcess::GetMainThreadId() noexcept
 {
@@ -511,7 +662,50 @@ bool RpgPlatformFile::File_Write(const char* filePath, const void* data, size_t
 }
 
 
+int64_t RpgPlatformFile::File_GetSize(const char* filePath) noexcept
+{
+	SDL_IOStream* ctx = SDL_IOFromFile(filePath, "rb");
+	if (ctx == nullptr)
+	{
+		return -1;
+	}
+
+	const int64_t sizeBytes = SDL_GetIOSize(ctx);
+	SDL_CloseIO(ctx);
+
+	return sizeBytes;
+}
+
+
+bool RpgPlatformFile::File_Read(const char* filePath, void* out_Data, size_t sizeBytes) noexcept
+{
+	SDL_IOStream* ctx = SDL_IOFromFile(filePath, "rb");
+	if (ctx == nullptr)
+	{
+		RPG_LogError(RpgLogSystem, "Read data from file (%s) failed. Cannot open file!", filePath);
+		return false;
+	}
+
+	const size_t readSizeBytes = SDL_ReadIO(ctx, out_Data, sizeBytes);
+	SDL_CloseIO(ctx);
+
+	if (readSizeBytes != sizeBytes)
+	{
+		RPG_LogError(RpgLogSystem, "Read data from file (%s) failed. Read %zu of %zu bytes!", filePath, readSizeBytes, sizeBytes);
+		return false;
+	}
+
+	return true;
+}
+
+
 bool RpgPlatformFile::File_Delete(const char* filePath) noexcept
 {
 	return SDL_RemovePath(filePath);
 }
+
+
+bool RpgPlatformFile::Directory_Create(const char* directoryPath) noexcept
+{
+	return SDL_CreateDirectory(directoryPath);
+}
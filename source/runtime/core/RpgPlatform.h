@@ -2,8 +2,21 @@
 
 #include "RpgTypes.h"
 
+
+#ifdef _WIN32
+#define RPG_PLATFORM_WINDOWS	1
+#else
+#define RPG_PLATFORM_WINDOWS	0
+#endif // _WIN32
+
+
+// Define RPG_PLATFORM_NO_MIMALLOC to use C runtime allocator (tools and benchmarks built without mimalloc)
+#ifndef RPG_PLATFORM_NO_MIMALLOC
 #include <mimalloc-override.h>
+#endif // !RPG_PLATFORM_NO_MIMALLOC
+
 
+#if RPG_PLATFORM_WINDOWS
 #include <winsdkver.h>
 #ifndef _WIN32_WINNT
 #define _WIN32_WINNT 0x0A00
@@ -23,11 +36,16 @@
 #endif
 
 #include <Windows.h>
+#endif // RPG_PLATFORM_WINDOWS
 
 #include <SDL3/SDL.h>
 
 
+#if RPG_PLATFORM_WINDOWS
 #define RPG_DebugBreak()	if (IsDebuggerPresent()) __debugbreak()
+#else
+#define RPG_DebugBreak()
+#endif // RPG_PLATFORM_WINDOWS
 
 
 
@@ -53,7 +71,7 @@ namespace RpgPlatformMemory
 	extern void CStringToWide(wchar_t* dst, const char* src, size_t maxBufferCount) noexcept;
 	extern void CStringToLower(char* cstr, int len) noexcept;
 	extern int CStringToInt(const char* cstr) noexcept;
-	extern uint64_t CStringHash(const char* cstr) noexcept;
+	extern uint64_t CStringHash(const char* cstr, bool bIgnoreCase = false) noexcept;
 
 }; // RpgPlatformMemory
 
@@ -140,10 +158,10 @@ RpgPlatformLog::FCategory catName{#catName, RpgPlatformLog::defaultVerbosity};
 static_assert(sizeof(#catName) <= RPG_LOG_CATEGORY_NAME_LENGTH, "Exceeds maximum log category name length!");
 
 
-#define RPG_Log(category, format, ...)		RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_LOG, format, __VA_ARGS__)
-#define RPG_LogDebug(category, format, ...)	RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_DEBUG, format, __VA_ARGS__)
-#define RPG_LogWarn(category, format, ...)	RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_WARN, format, __VA_ARGS__)
-#define RPG_LogError(category, format, ...)	RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_ERROR, format, __VA_ARGS__)
+#define RPG_Log(category, format, ...)		RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_LOG, format, ##__VA_ARGS__)
+#define RPG_LogDebug(category, format, ...)	RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_DEBUG, format, ##__VA_ARGS__)
+#define RPG_LogWarn(category, format, ...)	RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_WARN, format, ##__VA_ARGS__)
+#define RPG_LogError(category, format, ...)	RpgPlatformLog::OutputMessageLogCategoryFormat(category, RpgPlatformLog::VERBOSITY_ERROR, format, ##__VA_ARGS__)
 
 
 RPG_LOG_DECLARE_CATEGORY_EXTERN(RpgLogTemp)
@@ -161,8 +179,10 @@ namespace RpgPlatformProcess
 	extern void Shutdown() noexcept;
 	extern void Exit(uint32_t code) noexcept;
 	extern void ShowMessageBoxError(const char* title, const char* message) noexcept;
+#if RPG_PLATFORM_WINDOWS
 	extern void SetMainWindowHandle(HWND handle) noexcept;
 	extern HWND GetMainWindowHandle() noexcept;
+#endif // RPG_PLATFORM_WINDOWS
 	extern uint32_t GetMainThreadId() noexcept;
 
 
@@ -198,7 +218,7 @@ RpgPlatformProcess::Exit(333);
 if (!(cond))																														\
 {																																	\
 	char message[512];																												\
-	snprintf(message, 512, format, __VA_ARGS__);																					\
+	snprintf(message, 512, format, ##__VA_ARGS__);																					\
 	char assertMessage[512];																										\
 	snprintf(assertMessage, 512, "AssertionFailed: (%s)\nMessage: %s\nFile: %s\nLine: %i\n", #cond, message, __FILE__, __LINE__);	\
 	RPG_ASSERT_MESSAGE_EXIT(assertMessage);																				\
@@ -215,7 +235,7 @@ if (!(cond))																									\
 
 
 #if RPG_ASSERT_LEVEL < 1
-#define RPG_AssertV(cond, format, ...)	RPG_AssertMessageV(cond, format, __VA_ARGS__)
+#define RPG_AssertV(cond, format, ...)	RPG_AssertMessageV(cond, format, ##__VA_ARGS__)
 #define RPG_Assert(cond)				RPG_AssertMessage(cond)
 #else
 #define RPG_AssertV(cond, format, ...)
@@ -224,7 +244,7 @@ if (!(cond))																									\
 
 
 #if RPG_ASSERT_LEVEL < 2
-#define RPG_CheckV(cond, format, ...)	RPG_AssertMessageV(cond, format, __VA_ARGS__)
+#define RPG_CheckV(cond, format, ...)	RPG_AssertMessageV(cond, format, ##__VA_ARGS__)
 #define RPG_Check(cond)					RPG_AssertMessage(cond)
 #else
 #define RPG_CheckV(cond, format, ...)
@@ -232,7 +252,7 @@ if (!(cond))																									\
 #endif // RPG_PLATFORM_ASSERT_LEVEL < 2
 
 
-#define RPG_ValidateV(cond, format, ...)	RPG_AssertMessageV(cond, format, __VA_ARGS__)
+#define RPG_ValidateV(cond, format, ...)	RPG_AssertMessageV(cond, format, ##__VA_ARGS__)
 #define RPG_Validate(cond)					RPG_AssertMessage(cond)
 
 
@@ -259,6 +279,18 @@ if (!(cond))																							\
 namespace RpgPlatformFile
 {
 	extern bool File_Write(const char* filePath, const void* data, size_t sizeBytes) noexcept;
+
+	// @returns Size of file in bytes, -1 if file cannot be opened
+	extern int64_t File_GetSize(const char* filePath) noexcept;
+
+	// Read <sizeBytes> from the start of file into <out_Data>
+	// @returns TRUE if <sizeBytes> has been read
+	extern bool File_Read(const char* filePath, void* out_Data, size_t sizeBytes) noexcept;
+
 	extern bool File_Delete(const char* filePath) noexcept;
 
+	// Create directory, including missing parent directories
+	// @returns TRUE if directory has been created or already exists
+	extern bool Directory_Create(const char* directoryPath) noexcept;
+
 };
@@ -0,0 +1,274 @@
+#include "RpgProfiler.h"
+
+
+
+namespace RpgProfiler
+{
+	struct FEvent
+	{
+		const char* Name;
+		uint64_t BeginTicks;
+		uint64_t EndTicks;
+	};
+
+
+	struct FThreadBuffer
+	{
+		char ThreadName[32];
+		FEvent* Events;
+		std::atomic<uint32_t> Count;
+	};
+
+
+	std::atomic<bool> bIsRecording;
+
+	static SDL_Mutex* RegistryMutex;
+	static FThreadBuffer** ThreadBuffers;
+	static int ThreadBufferCount;
+	static int ThreadBufferCapacity;
+
+	static thread_local FThreadBuffer* LocalThreadBuffer = nullptr;
+
+	static char CaptureFilePath[256];
+	static int CaptureRequestFrameCount;
+	static int CaptureRemainingFrameCount;
+	static uint64_t CaptureBeginTicks;
+	static bool bInitialized;
+
+
+
+	static FThreadBuffer* GetThreadBuffer(const char* optThreadName) noexcept
+	{
+		if (LocalThreadBuffer)
+		{
+			return LocalThreadBuffer;
+		}
+
+		RPG_AssertV(bInitialized, "RpgProfiler: Not initialized!");
+
+		FThreadBuffer* buffer = new FThreadBuffer();
+		buffer->Events = reinterpret_cast<FEvent*>(RpgPlatformMemory::MemMalloc(sizeof(FEvent) * RPG_PROFILER_MAX_EVENT_PER_THREAD));
+		buffer->Count.store(0, std::memory_order_relaxed);
+
+		if (optThreadName)
+		{
+			snprintf(buffer->ThreadName, sizeof(buffer->ThreadName), "%s", optThreadName);
+		}
+		else
+		{
+			snprintf(buffer->ThreadName, sizeof(buffer->ThreadName), "Thread-%llu", static_cast<unsigned long long>(SDL_GetCurrentThreadID()));
+		}
+
+		SDL_LockMutex(RegistryMutex);
+		{
+			if (ThreadBufferCount == ThreadBufferCapacity)
+			{
+				ThreadBufferCapacity = (ThreadBufferCapacity > 0) ? ThreadBufferCapacity * 2 : 16;
+				ThreadBuffers = reinterpret_cast<FThreadBuffer**>(RpgPlatformMemory::MemRealloc(ThreadBuffers, sizeof(FThreadBuffer*) * ThreadBufferCapacity));
+			}
+
+			ThreadBuffers[ThreadBufferCount++] = buffer;
+		}
+		SDL_UnlockMutex(RegistryMutex);
+
+		LocalThreadBuffer = buffer;
+
+		return buffer;
+	}
+
+};
+
+
+void RpgProfiler::Initialize() noexcept
+{
+	if (bInitialized)
+	{
+		return;
+	}
+
+	RegistryMutex = SDL_CreateMutex();
+	bIsRecording.store(false, std::memory_order_relaxed);
+	bInitialized = true;
+
+	RegisterThread("Main");
+}
+
+
+void RpgProfiler::Shutdown() noexcept
+{
+	if (!bInitialized)
+	{
+		return;
+	}
+
+	bIsRecording.store(false, std::memory_order_relaxed);
+
+	for (int t = 0; t < ThreadBufferCount; ++t)
+	{
+		RpgPlatformMemory::MemFree(ThreadBuffers[t]->Events);
+		delete ThreadBuffers[t];
+	}
+
+	RpgPlatformMemory::MemFree(ThreadBuffers);
+	ThreadBuffers = nullptr;
+	ThreadBufferCount = 0;
+	ThreadBufferCapacity = 0;
+	LocalThreadBuffer = nullptr;
+
+	SDL_DestroyMutex(RegistryMutex);
+	RegistryMutex = nullptr;
+
+	bInitialized = false;
+}
+
+
+void RpgProfiler::RegisterThread(const char* threadName) noexcept
+{
+	if (!bInitialized)
+	{
+		return;
+	}
+
+	RPG_Assert(threadName);
+	RPG_AssertV(LocalThreadBuffer == nullptr, "RpgProfiler: Thread already registered!");
+
+	GetThreadBuffer(threadName);
+}
+
+
+void RpgProfiler::RequestCapture(int frameCount, const char* filePath) noexcept
+{
+	RPG_Assert(frameCount > 0 && filePath);
+
+	if (CaptureRequestFrameCount > 0 || CaptureRemainingFrameCount > 0)
+	{
+		RPG_LogWarn(RpgLogSystem, "Profiler capture is already in progress!");
+		return;
+	}
+
+	snprintf(CaptureFilePath, sizeof(CaptureFilePath), "%s", filePath);
+	CaptureRequestFrameCount = frameCount;
+}
+
+
+void RpgProfiler::BeginFrame(uint64_t frameCounter) noexcept
+{
+	if (!bInitialized)
+	{
+		return;
+	}
+
+	if (CaptureRemainingFrameCount > 0)
+	{
+		--CaptureRemainingFrameCount;
+
+		if (CaptureRemainingFrameCount == 0)
+		{
+			// Pairs with the check in AddEvent, see ExportChromeTrace
+			bIsRecording.store(false, std::memory_order_seq_cst);
+
+			if (ExportChromeTrace(CaptureFilePath))
+			{
+				RPG_Log(RpgLogSystem, "Profiler capture finished at frame %llu. Exported to %s", static_cast<unsigned long long>(frameCounter), CaptureFilePath);
+			}
+		}
+	}
+
+	if (CaptureRequestFrameCount > 0 && CaptureRemainingFrameCount == 0)
+	{
+		SDL_LockMutex(RegistryMutex);
+		{
+			for (int t = 0; t < ThreadBufferCount; ++t)
+			{
+				ThreadBuffers[t]->Count.store(0, std::memory_order_relaxed);
+			}
+		}
+		SDL_UnlockMutex(RegistryMutex);
+
+		RPG_Log(RpgLogSystem, "Profiler capture %i frames begin at frame %llu", CaptureRequestFrameCount, static_cast<unsigned long long>(frameCounter));
+
+		CaptureRemainingFrameCount = CaptureRequestFrameCount;
+		CaptureRequestFrameCount = 0;
+		CaptureBeginTicks = GetTicks();
+		bIsRecording.store(true, std::memory_order_release);
+	}
+}
+
+
+void RpgProfiler::AddEvent(const char* name, uint64_t beginTicks, uint64_t endTicks) noexcept
+{
+	// Capture stopped, exporter may be reading the buffers. Scope that ends after capture stopped is dropped,
+	// it would be written past the count snapshot of exporter anyway
+	if (!bIsRecording.load(std::memory_order_seq_cst))
+	{
+		return;
+	}
+
+	FThreadBuffer* buffer = GetThreadBuffer(nullptr);
+
+	// Single writer, publish event after written so exporter never reads partially written event.
+	// Sequentially consistent with the capture stop, next AddEvent after the count read by exporter sees capture stopped
+	const uint32_t index = buffer->Count.load(std::memory_order_relaxed);
+	FEvent& evt = buffer->Events[index % RPG_PROFILER_MAX_EVENT_PER_THREAD];
+	evt.Name = name;
+	evt.BeginTicks = beginTicks;
+	evt.EndTicks = endTicks;
+
+	buffer->Count.store(index + 1, std::memory_order_seq_cst);
+}
+
+
+bool RpgProfiler::ExportChromeTrace(const char* filePath) noexcept
+{
+	SDL_IOStream* ctx = SDL_IOFromFile(filePath, "w");
+	if (ctx == nullptr)
+	{
+		RPG_LogError(RpgLogSystem, "Export profiler trace to file (%s) failed. Cannot open file!", filePath);
+		return false;
+	}
+
+	const double ticksToMicroseconds = 1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+	bool bFirstEvent = true;
+
+	SDL_IOprintf(ctx, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	SDL_LockMutex(RegistryMutex);
+	{
+		for (int t = 0; t < ThreadBufferCount; ++t)
+		{
+			const FThreadBuffer* buffer = ThreadBuffers[t];
+
+			SDL_IOprintf(ctx, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%i,\"args\":{\"name\":\"%s\"}}", bFirstEvent ? "" : ",\n", t, buffer->ThreadName);
+			SDL_IOprintf(ctx, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":%i,\"args\":{\"sort_index\":%i}}", t, t);
+			bFirstEvent = false;
+
+			// Worker threads may still be running (background tasks span frames), only events published before this snapshot are exported.
+			// Writer that passed the recording check in AddEvent before capture stopped can still write one event at slot <count>,
+			// skip the oldest slot when the ring wrapped since it's the same slot. Next AddEvent of that writer sees capture stopped.
+			const uint32_t count = buffer->Count.load(std::memory_order_seq_cst);
+			const uint32_t first = (count > RPG_PROFILER_MAX_EVENT_PER_THREAD) ? count - RPG_PROFILER_MAX_EVENT_PER_THREAD + 1 : 0;
+
+			for (uint32_t i = first; i < count; ++i)
+			{
+				const FEvent& evt = buffer->Events[i % RPG_PROFILER_MAX_EVENT_PER_THREAD];
+
+				// Event started before capture
+				if (evt.BeginTicks < CaptureBeginTicks)
+				{
+					continue;
+				}
+
+				const double beginUs = static_cast<double>(evt.BeginTicks - CaptureBeginTicks) * ticksToMicroseconds;
+				const double durationUs = static_cast<double>(evt.EndTicks - evt.BeginTicks) * ticksToMicroseconds;
+
+				SDL_IOprintf(ctx, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f}", evt.Name ? evt.Name : "Unknown", t, beginUs, durationUs);
+			}
+		}
+	}
+	SDL_UnlockMutex(RegistryMutex);
+
+	SDL_IOprintf(ctx, "\n]}\n");
+	SDL_CloseIO(ctx);
+
+	return true;
+}
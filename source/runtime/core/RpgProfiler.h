@@ -0,0 +1,120 @@
+#pragma once
+
+#include "RpgPlatform.h"
+#include <atomic>
+
+
+
+// Maximum number of events recorded per thread during capture. Oldest events are overwritten when full.
+#define RPG_PROFILER_MAX_EVENT_PER_THREAD		16384
+
+
+
+// Lightweight CPU profiler. Each thread records [begin, end] timestamp of tasks and scopes into its own ring buffer,
+// captured events are exported as Chrome trace JSON (chrome://tracing or https://ui.perfetto.dev).
+namespace RpgProfiler
+{
+	// Initialize profiler. Must be called from main thread
+	// @returns None
+	void Initialize() noexcept;
+
+
+	// Shutdown profiler and free all thread buffers
+	// @returns None
+	void Shutdown() noexcept;
+
+
+	// Register calling thread with name shown in trace. Thread that is not registered gets default name on first event
+	// @param threadName - Thread name
+	// @returns None
+	void RegisterThread(const char* threadName) noexcept;
+
+
+	// Request to capture next <frameCount> frames. Capture starts on next BeginFrame and exported to <filePath> once finished
+	// @param frameCount - Number of frames to capture
+	// @param filePath - Output trace file path
+	// @returns None
+	void RequestCapture(int frameCount, const char* filePath) noexcept;
+
+
+	// [Main thread] Called at the beginning of each frame to start/stop requested capture
+	// @param frameCounter - Current frame counter
+	// @returns None
+	void BeginFrame(uint64_t frameCounter) noexcept;
+
+
+	// Record event into calling thread buffer
+	// @param name - Event name, must be string literal or stay valid until exported
+	// @param beginTicks - Begin timestamp from GetTicks()
+	// @param endTicks - End timestamp from GetTicks()
+	// @returns None
+	void AddEvent(const char* name, uint64_t beginTicks, uint64_t endTicks) noexcept;
+
+
+	// Write captured events as Chrome trace JSON. Called by BeginFrame after capture stopped, it does not wait other threads to be idle.
+	// Each thread buffer is exported up to the event count snapshot taken when reading it, events are no longer added once capture stopped.
+	// @param filePath - Output file path
+	// @returns True on success
+	bool ExportChromeTrace(const char* filePath) noexcept;
+
+
+	extern std::atomic<bool> bIsRecording;
+
+	[[nodiscard]] inline bool IsRecording() noexcept
+	{
+		return bIsRecording.load(std::memory_order_relaxed);
+	}
+
+
+	[[nodiscard]] inline uint64_t GetTicks() noexcept
+	{
+		return SDL_GetPerformanceCounter();
+	}
+
+};
+
+
+
+class RpgProfilerScope
+{
+	RPG_NOCOPYMOVE(RpgProfilerScope)
+
+public:
+	RpgProfilerScope(const char* in_Name) noexcept
+		: Name(RpgProfiler::IsRecording() ? in_Name : nullptr)
+		, BeginTicks(Name ? RpgProfiler::GetTicks() : 0)
+	{
+	}
+
+	~RpgProfilerScope() noexcept
+	{
+		End();
+	}
+
+
+	// Record event now instead of at the end of the scope
+	inline void End() noexcept
+	{
+		if (Name)
+		{
+			RpgProfiler::AddEvent(Name, BeginTicks, RpgProfiler::GetTicks());
+			Name = nullptr;
+		}
+	}
+
+
+private:
+	const char* Name;
+	uint64_t BeginTicks;
+
+};
+
+
+#define RPG_PROFILER_CONCAT_INNER(a, b)		a##b
+#define RPG_PROFILER_CONCAT(a, b)			RPG_PROFILER_CONCAT_INNER(a, b)
+
+#ifndef RPG_BUILD_SHIPPING
+#define RPG_PROFILER_Scope(name)			RpgProfilerScope RPG_PROFILER_CONCAT(__rpgProfilerScope, __LINE__)(name)
+#else
+#define RPG_PROFILER_Scope(name)
+#endif // !RPG_BUILD_SHIPPING
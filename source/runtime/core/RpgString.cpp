@@ -0,0 +1,153 @@
+#include "RpgString.h"
+
+
+
+#define RPG_NAME_TABLE_PAGE_ENTRY_COUNT		4096
+#define RPG_NAME_TABLE_MAX_PAGE				1024
+#define RPG_NAME_TABLE_STRING_BLOCK_SIZE	RPG_MEMORY_SIZE_KiB(64)
+
+
+namespace RpgNameTable
+{
+	// Spinlock is zero initialized, table can be used during static initialization
+	static SDL_SpinLock Lock = 0;
+
+	// Entry pages are never reallocated, entries can be read without lock. First page holds the empty name (ID 0).
+	static FEntry FirstPage[RPG_NAME_TABLE_PAGE_ENTRY_COUNT] = { { "", 0, 0 } };
+	static FEntry* Pages[RPG_NAME_TABLE_MAX_PAGE] = { FirstPage };
+	static int EntryCount = 1;
+
+	// String storage
+	static char* StringBlockCursor = nullptr;
+	static char* StringBlockEnd = nullptr;
+
+	// Lookup table of entry IDs (linear probing). 0 means empty slot
+	static uint32_t* LookupSlots = nullptr;
+	static int LookupCapacity = 0;
+
+
+	static char* AllocateString(int sizeBytes) noexcept
+	{
+		// Large string gets its own allocation, keep the rest of current block
+		if (sizeBytes > RPG_NAME_TABLE_STRING_BLOCK_SIZE / 4)
+		{
+			return static_cast<char*>(RpgPlatformMemory::MemMalloc(sizeBytes));
+		}
+
+		if (StringBlockCursor == nullptr || StringBlockCursor + sizeBytes > StringBlockEnd)
+		{
+			StringBlockCursor = static_cast<char*>(RpgPlatformMemory::MemMalloc(RPG_NAME_TABLE_STRING_BLOCK_SIZE));
+			StringBlockEnd = StringBlockCursor + RPG_NAME_TABLE_STRING_BLOCK_SIZE;
+		}
+
+		char* data = StringBlockCursor;
+		StringBlockCursor += sizeBytes;
+
+		return data;
+	}
+
+
+	static void GrowLookup() noexcept
+	{
+		const int newCapacity = LookupCapacity > 0 ? LookupCapacity * 2 : 1024;
+		uint32_t* newSlots = static_cast<uint32_t*>(RpgPlatformMemory::MemMalloc(sizeof(uint32_t) * newCapacity));
+		RpgPlatformMemory::MemZero(newSlots, sizeof(uint32_t) * newCapacity);
+
+		const uint64_t mask = static_cast<uint64_t>(newCapacity - 1);
+
+		for (int id = 1; id < EntryCount; ++id)
+		{
+			uint64_t slot = GetEntry(id).Hash & mask;
+
+			while (newSlots[slot] != 0)
+			{
+				slot = (slot + 1) & mask;
+			}
+
+			newSlots[slot] = static_cast<uint32_t>(id);
+		}
+
+		RpgPlatformMemory::MemFree(LookupSlots);
+		LookupSlots = newSlots;
+		LookupCapacity = newCapacity;
+	}
+
+};
+
+
+uint32_t RpgNameTable::FindOrAdd(const char* cstr) noexcept
+{
+	if (cstr == nullptr || cstr[0] == '\0')
+	{
+		return 0;
+	}
+
+	const uint64_t hash = RpgPlatformMemory::CStringHash(cstr, true);
+
+	SDL_LockSpinlock(&Lock);
+
+	// Keep load factor below 1/2
+	if ((EntryCount + 1) * 2 > LookupCapacity)
+	{
+		GrowLookup();
+	}
+
+	const uint64_t mask = static_cast<uint64_t>(LookupCapacity - 1);
+	uint64_t slot = hash & mask;
+
+	while (LookupSlots[slot] != 0)
+	{
+		const uint32_t id = LookupSlots[slot];
+		const FEntry& entry = GetEntry(id);
+
+		if (entry.Hash == hash && RpgPlatformMemory::CStringCompare(entry.String, cstr, true))
+		{
+			SDL_UnlockSpinlock(&Lock);
+			return id;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	RPG_CheckV(EntryCount < RPG_NAME_TABLE_PAGE_ENTRY_COUNT * RPG_NAME_TABLE_MAX_PAGE, "RpgNameTable: Exceeded maximum name count!");
+
+	const uint32_t id = static_cast<uint32_t>(EntryCount);
+	const int pageIndex = EntryCount / RPG_NAME_TABLE_PAGE_ENTRY_COUNT;
+
+	if (Pages[pageIndex] == nullptr)
+	{
+		Pages[pageIndex] = static_cast<FEntry*>(RpgPlatformMemory::MemMalloc(sizeof(FEntry) * RPG_NAME_TABLE_PAGE_ENTRY_COUNT));
+	}
+
+	const int length = RpgPlatformMemory::CStringLength(cstr);
+	char* string = AllocateString(length + 1);
+	RpgPlatformMemory::MemCopy(string, cstr, length + 1);
+
+	FEntry& entry = Pages[pageIndex][EntryCount % RPG_NAME_TABLE_PAGE_ENTRY_COUNT];
+	entry.String = string;
+	entry.Hash = hash;
+	entry.Length = length;
+
+	LookupSlots[slot] = id;
+	++EntryCount;
+
+	SDL_UnlockSpinlock(&Lock);
+
+	return id;
+}
+
+
+const RpgNameTable::FEntry& RpgNameTable::GetEntry(uint32_t id) noexcept
+{
+	return Pages[id / RPG_NAME_TABLE_PAGE_ENTRY_COUNT][id % RPG_NAME_TABLE_PAGE_ENTRY_COUNT];
+}
+
+
+int RpgNameTable::GetCount() noexcept
+{
+	SDL_LockSpinlock(&Lock);
+	const int count = EntryCount;
+	SDL_UnlockSpinlock(&Lock);
+
+	return count;
+}
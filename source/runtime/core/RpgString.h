@@ -139,6 +139,13 @@ public:
 	}
 
 
+	// Case sensitive, matches Rpg_GetHash(RpgString)
+	inline bool operator==(const RpgString& rhs) const noexcept
+	{
+		return Equals(rhs);
+	}
+
+
 	inline char* operator*() noexcept
 	{
 		return CharArray.GetData();
@@ -340,95 +347,119 @@ inline uint64_t Rpg_GetHash(const RpgString& value) noexcept
 
 #define RPG_NAME_MAX_COUNT			48
 
-class alignas(16) RpgName
+
+
+// ==================================================================================================== //
+// RpgNameTable
+// Global thread-safe table of interned names. Names are compared ignore case, first added casing is kept.
+// Entries are never removed, string pointers are stable for the lifetime of the process.
+// ==================================================================================================== //
+namespace RpgNameTable
+{
+	struct FEntry
+	{
+		const char* String;
+		uint64_t Hash;
+		int Length;
+	};
+
+
+	// Find or add name into the table
+	// @param cstr - Null terminated string. Null or empty string returns 0 (empty name)
+	// @returns Name ID
+	[[nodiscard]] extern uint32_t FindOrAdd(const char* cstr) noexcept;
+
+
+	// Get entry of name ID. Lock free
+	// @param id - Name ID returned by FindOrAdd
+	// @returns Name entry
+	[[nodiscard]] extern const FEntry& GetEntry(uint32_t id) noexcept;
+
+
+	// Get number of interned names (including empty name)
+	[[nodiscard]] extern int GetCount() noexcept;
+
+};
+
+
+
+// ==================================================================================================== //
+// RpgName
+// Handle to interned name in RpgNameTable. Compare and hash are O(1).
+// ==================================================================================================== //
+class RpgName
 {
 
 public:
 	RpgName() noexcept
-		: CharArray()
+		: Id(0)
 	{
 	}
 
 	RpgName(const char* cstr) noexcept
-		: CharArray()
+		: Id(RpgNameTable::FindOrAdd(cstr))
 	{
-		CopyFromCstr(cstr);
 	}
 
 
 public:
 	inline RpgName& operator=(const char* rhs) noexcept
 	{
-		if (CharArray != rhs)
-		{
-			CopyFromCstr(rhs);
-		}
+		Id = RpgNameTable::FindOrAdd(rhs);
 
 		return *this;
 	}
 
-	inline char* operator*() noexcept
-	{
-		return CharArray;
-	}
-
 	inline const char* operator*() const noexcept
 	{
-		return CharArray;
+		return RpgNameTable::GetEntry(Id).String;
 	}
 
 	inline bool operator==(const RpgName& rhs) const noexcept
 	{
-		return RpgPlatformMemory::CStringCompare(CharArray, rhs.CharArray, true);
+		return Id == rhs.Id;
 	}
 
 	inline bool operator==(const char* rhs) const noexcept
 	{
-		return RpgPlatformMemory::CStringCompare(CharArray, rhs, true);
+		return RpgPlatformMemory::CStringCompare(RpgNameTable::GetEntry(Id).String, rhs ? rhs : "", true);
 	}
 
 	inline bool operator!=(const RpgName& rhs) const noexcept
 	{
-		return !RpgPlatformMemory::CStringCompare(CharArray, rhs.CharArray, true);
+		return Id != rhs.Id;
 	}
 
 
 public:
-	inline char* GetData() noexcept
-	{
-		return CharArray;
-	}
-
 	inline const char* GetData() const noexcept
 	{
-		return CharArray;
+		return RpgNameTable::GetEntry(Id).String;
 	}
 
 	inline int GetLength() const noexcept
 	{
-		return RpgPlatformMemory::CStringLength(CharArray);
+		return RpgNameTable::GetEntry(Id).Length;
 	}
 
 	inline bool IsEmpty() const noexcept
 	{
-		return GetLength() == 0;
+		return Id == 0;
 	}
 
-
-private:
-	inline void CopyFromCstr(const char* cstr) noexcept
+	inline uint32_t GetId() const noexcept
 	{
-		RpgPlatformMemory::MemZero(CharArray, RPG_NAME_MAX_COUNT);
+		return Id;
+	}
 
-		if (cstr && RpgPlatformMemory::CStringLength(cstr) > 0)
-		{
-			snprintf(CharArray, RPG_NAME_MAX_COUNT, "%s", cstr);
-		}
+	inline uint64_t GetHash() const noexcept
+	{
+		return RpgNameTable::GetEntry(Id).Hash;
 	}
 
 
 private:
-	char CharArray[RPG_NAME_MAX_COUNT];
+	uint32_t Id;
 
 
 public:
@@ -448,5 +479,5 @@ public:
 
 inline uint64_t Rpg_GetHash(const RpgName& value) noexcept
 {
-	return RpgPlatformMemory::CStringHash(*value);
+	return value.GetHash();
 }
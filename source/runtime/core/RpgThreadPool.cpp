@@ -1,20 +1,165 @@
 #include "RpgThreadPool.h"
+#include "RpgProfiler.h"
 #include "dsa/RpgArray.h"
+#include <atomic>
 
 
 
 namespace RpgThreadPool
 {
+	// Maximum number of tasks that can be queued in single thread deque. Must be power of two.
+	constexpr int64_t TASK_DEQUE_CAPACITY = 4096;
+
+	// Maximum number of worker threads
+	constexpr int MAX_THREAD_WORKER = 32;
+
+	// Number of CPU pause iterations when waiting task before start yielding
+	constexpr int WAIT_SPIN_COUNT = 64;
+
+	// Number of yield iterations when waiting task before start sleeping
+	constexpr int WAIT_YIELD_COUNT = 16;
+
+	// Maximum sleep duration (ms) when waiting task, the waiting thread will look for queued tasks again after timeout
+	constexpr int WAIT_SLEEP_TIMEOUT_MS = 1;
+
+	// Number of frame-critical tasks a thread may execute in a row while background tasks are waiting.
+	// After that the thread takes one background task (if background worker limit allows) so background work never starves.
+	constexpr int BACKGROUND_STARVATION_LIMIT = 64;
+
+	// Number of chunks per thread when ParallelFor grain size is calculated automatically. More chunks give better load balancing.
+	constexpr int PARALLEL_FOR_CHUNK_PER_THREAD = 4;
+
+
+
+	// Work-stealing deque (Chase-Lev).
+	// Only the owner thread can push/pop at the bottom, any other threads can steal from the top.
+	class FTaskDeque
+	{
+		RPG_NOCOPYMOVE(FTaskDeque)
+
+		static_assert(RpgAlgorithm::IsPowerOfTwo(TASK_DEQUE_CAPACITY), "RpgThreadPool: TASK_DEQUE_CAPACITY must be power of two!");
+		static constexpr int64_t MASK = TASK_DEQUE_CAPACITY - 1;
+
+	public:
+		FTaskDeque() noexcept
+			: Top(0)
+			, Bottom(0)
+			, Buffer()
+		{
+		}
+
+
+		// [Owner thread] Push task at the bottom
+		// @returns False if deque is full
+		inline bool Push(RpgThreadTask* task) noexcept
+		{
+			const int64_t b = Bottom.load(std::memory_order_relaxed);
+			const int64_t t = Top.load(std::memory_order_acquire);
+
+			if (b - t >= TASK_DEQUE_CAPACITY)
+			{
+				return false;
+			}
+
+			Buffer[b & MASK].store(task, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			Bottom.store(b + 1, std::memory_order_relaxed);
+
+			return true;
+		}
+
+
+		// [Owner thread] Pop task from the bottom (LIFO)
+		// @returns Task or nullptr if empty
+		inline RpgThreadTask* Pop() noexcept
+		{
+			const int64_t b = Bottom.load(std::memory_order_relaxed) - 1;
+			Bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t t = Top.load(std::memory_order_relaxed);
+
+			RpgThreadTask* task = nullptr;
+
+			if (t <= b)
+			{
+				task = Buffer[b & MASK].load(std::memory_order_relaxed);
+
+				// Last element, race against stealers
+				if (t == b)
+				{
+					if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					{
+						task = nullptr;
+					}
+
+					Bottom.store(b + 1, std::memory_order_relaxed);
+				}
+			}
+			else
+			{
+				Bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			return task;
+		}
+
+
+		// [Any thread] Steal task from the top (FIFO)
+		// @param out_bAborted - Set to true when lost the race against other thread, deque is probably not empty
+		// @returns Task or nullptr
+		inline RpgThreadTask* Steal(bool& out_bAborted) noexcept
+		{
+			int64_t t = Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64_t b = Bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+			{
+				return nullptr;
+			}
+
+			RpgThreadTask* task = Buffer[t & MASK].load(std::memory_order_relaxed);
+
+			if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				out_bAborted = true;
+				return nullptr;
+			}
+
+			return task;
+		}
+
+
+		inline bool IsEmpty() const noexcept
+		{
+			return Bottom.load(std::memory_order_relaxed) <= Top.load(std::memory_order_relaxed);
+		}
+
+
+	private:
+		alignas(RPG_CACHE_LINE_SIZE) std::atomic<int64_t> Top;
+		alignas(RPG_CACHE_LINE_SIZE) std::atomic<int64_t> Bottom;
+		alignas(RPG_CACHE_LINE_SIZE) std::atomic<RpgThreadTask*> Buffer[TASK_DEQUE_CAPACITY];
+
+	};
+
+
+
+	// Shared FIFO queue used when submitting from non-pool thread or when the owner deque is full
 	class FTaskQueue
 	{
 	private:
 		RpgArray<RpgThreadTask*> Pool;
+		int Head;
 		SDL_Mutex* Mutex;
+		std::atomic<int> Count;
 
 
 	public:
 		FTaskQueue() noexcept
-			: Mutex(nullptr)
+			: Head(0)
+			, Mutex(nullptr)
+			, Count(0)
 		{
 		}
 
@@ -23,22 +168,51 @@ namespace RpgThreadPool
 			Mutex = SDL_CreateMutex();
 		}
 
+		inline void Shutdown() noexcept
+		{
+			Pool.Clear(true);
+			Head = 0;
+			Count.store(0, std::memory_order_relaxed);
+
+			SDL_DestroyMutex(Mutex);
+			Mutex = nullptr;
+		}
+
 		inline void PushTasks(RpgThreadTask** tasks, int count) noexcept
 		{
 			SDL_LockMutex(Mutex);
 			Pool.InsertAtRange(tasks, count, RPG_INDEX_LAST);
+			Count.fetch_add(count, std::memory_order_release);
 			SDL_UnlockMutex(Mutex);
 		}
 
+		inline bool IsEmpty() const noexcept
+		{
+			return Count.load(std::memory_order_relaxed) == 0;
+		}
+
 		inline RpgThreadTask* PopTask() noexcept
 		{
+			// Fast path, avoid taking the lock when empty
+			if (Count.load(std::memory_order_acquire) == 0)
+			{
+				return nullptr;
+			}
+
 			SDL_LockMutex(Mutex);
 			RpgThreadTask* task = nullptr;
 
-			if (Pool.GetCount() > 0)
+			if (Head < Pool.GetCount())
 			{
-				task = Pool[0];
-				Pool.RemoveAt(0);
+				task = Pool[Head++];
+				Count.fetch_sub(1, std::memory_order_relaxed);
+
+				// Consumed everything, reuse the memory from the beginning
+				if (Head == Pool.GetCount())
+				{
+					Pool.Clear();
+					Head = 0;
+				}
 			}
 
 			SDL_UnlockMutex(Mutex);
@@ -49,53 +223,386 @@ namespace RpgThreadPool
 	};
 
 
-	static SDL_Semaphore* SignalSemaphore;
-	static FTaskQueue TaskQueue;
-
 
-	struct FThreadWorker
+	// Per-thread scheduling context. Index 0 is the main thread, the rest are worker threads.
+	struct FThreadContext
 	{
+		FTaskDeque Deque;
 		SDL_Thread* Handle{ nullptr };
 		SDL_AtomicInt IsRunning{};
+		int Index{ 0 };
+
+		// Set before the thread is created. Handle may not be assigned yet when the thread starts running
+		char Name[32]{};
 	};
-	static RpgArrayInline<FThreadWorker, 32> ThreadWorkers;
+
+	static FThreadContext* ThreadContexts;
+	static int ThreadContextCount;
+	static int ThreadWorkerCount;
+
+	static SDL_Semaphore* SignalSemaphore;
+
+	// Queue counters and background slot counter are polled by every worker, keep each on its own cache line
+	alignas(RPG_CACHE_LINE_SIZE) static FTaskQueue SharedQueue;
+
+	// Background lane
+	alignas(RPG_CACHE_LINE_SIZE) static FTaskQueue BackgroundQueue;
+	alignas(RPG_CACHE_LINE_SIZE) static SDL_AtomicInt BackgroundActiveCount;
+	static int BackgroundWorkerLimit;
+
+	// Sleeping waiters (RpgThreadTask::Wait) are woken up when any task is done
+	static SDL_Mutex* WaitMutex;
+	static SDL_Condition* WaitCondition;
+	static SDL_AtomicInt WaitSleeperCount;
 
 	static bool bInitialized;
 
+	// Index to ThreadContexts for current thread. Invalid for threads not owned by thread pool
+	static thread_local int LocalThreadIndex = RPG_INDEX_INVALID;
 
-	static int ThreadWorkerMain(void* data) noexcept
+	// Random seed to pick steal victim
+	static thread_local uint32_t LocalRandomSeed = 0x9E3779B9u;
+
+	// Number of frame-critical tasks executed in a row by current thread while background tasks are waiting
+	static thread_local int LocalFrameTaskStreak = 0;
+
+	// Number of queued background tasks being executed by current thread. Greater than 1 when background task helps in Wait.
+	// Thread holds one background slot while this is not 0
+	static thread_local int LocalBackgroundTaskDepth = 0;
+
+
+
+	class FParallelForTask : public RpgThreadTask
 	{
-		RpgThreadPool::FThreadWorker* worker = reinterpret_cast<RpgThreadPool::FThreadWorker*>(data);
-		const char* threadName = SDL_GetThreadName(worker->Handle);
-		
-		while (SDL_GetAtomicInt(&worker->IsRunning))
+	public:
+		FParallelForFunction Function{ nullptr };
+		void* Context{ nullptr };
+		int BeginIndex{ 0 };
+		int EndIndex{ 0 };
+
+
+	public:
+		virtual void Execute() noexcept override
+		{
+			Function(Context, BeginIndex, EndIndex);
+		}
+
+
+		virtual const char* GetTaskName() const noexcept override
+		{
+			return "RpgThreadPool_ParallelFor";
+		}
+
+	};
+
+
+	// Per-thread pool of ParallelFor chunk tasks. Used as a stack since ParallelFor blocks until all chunks are done,
+	// nested ParallelFor (called inside a chunk) takes the tasks above the ones that are still in use.
+	struct FParallelForTaskPool
+	{
+		RpgArray<RpgThreadTask*> Tasks;
+		int UsedCount{ 0 };
+
+
+		~FParallelForTaskPool() noexcept
 		{
-			SDL_WaitSemaphore(SignalSemaphore);
+			RPG_Assert(UsedCount == 0);
 
-			// Check if should exit
-			if (!SDL_GetAtomicInt(&worker->IsRunning))
+			for (int i = 0; i < Tasks.GetCount(); ++i)
 			{
+				delete Tasks[i];
+			}
+		}
+
+	};
+
+	static thread_local FParallelForTaskPool LocalParallelForTaskPool;
+
+
+
+	static inline void PushTasksToCurrentThread(RpgThreadTask** tasks, int taskCount) noexcept
+	{
+		if (LocalThreadIndex == RPG_INDEX_INVALID)
+		{
+			SharedQueue.PushTasks(tasks, taskCount);
+			return;
+		}
+
+		FTaskDeque& deque = ThreadContexts[LocalThreadIndex].Deque;
+
+		for (int i = 0; i < taskCount; ++i)
+		{
+			if (!deque.Push(tasks[i]))
+			{
+				// Deque full, overflow the rest to shared queue
+				SharedQueue.PushTasks(tasks + i, taskCount - i);
 				break;
 			}
+		}
+	}
 
-			RpgThreadTask* task = TaskQueue.PopTask();
 
-			while (task)
+	static inline void QueueTask(RpgThreadTask* task) noexcept
+	{
+		if (task->GetPriority() == RpgThreadTaskPriority::BACKGROUND)
+		{
+			BackgroundQueue.PushTasks(&task, 1);
+		}
+		else
+		{
+			PushTasksToCurrentThread(&task, 1);
+		}
+	}
+
+
+	static inline RpgThreadTask* FindFrameTask(int threadIndex) noexcept
+	{
+		RpgThreadTask* task = nullptr;
+
+		// Own deque first
+		if (threadIndex != RPG_INDEX_INVALID)
+		{
+			task = ThreadContexts[threadIndex].Deque.Pop();
+			if (task)
 			{
-				//RPG_PLATFORM_LogDebug(RpgLogSystem, "%s execute task %s", threadName, task->GetTaskName());
-				task->Execute();
-				task->SetDone();
+				return task;
+			}
+		}
+
+		// Shared queue
+		task = SharedQueue.PopTask();
+		if (task)
+		{
+			return task;
+		}
 
-				// Check if should exit
-				if (!SDL_GetAtomicInt(&worker->IsRunning))
+		// Steal from other threads, start from random victim to spread the contention
+		LocalRandomSeed = LocalRandomSeed * 1664525u + 1013904223u;
+		const int startIndex = static_cast<int>((LocalRandomSeed >> 16) % static_cast<uint32_t>(ThreadContextCount));
+
+		bool bAborted = false;
+
+		do
+		{
+			bAborted = false;
+
+			for (int i = 0; i < ThreadContextCount; ++i)
+			{
+				const int victimIndex = (startIndex + i) % ThreadContextCount;
+				if (victimIndex == threadIndex)
 				{
-					break;
+					continue;
 				}
 
-				task = TaskQueue.PopTask();
+				task = ThreadContexts[victimIndex].Deque.Steal(bAborted);
+				if (task)
+				{
+					return task;
+				}
+			}
+		}
+		while (bAborted);
+
+		return nullptr;
+	}
+
+
+	// Pop background task if number of threads executing background tasks is below the limit.
+	// Thread that is already executing background task (waiting on its subtasks) reuses its slot, otherwise it could never run the subtasks once the limit is reached.
+	// Slot is released by ExecuteQueuedTask.
+	static inline RpgThreadTask* FindBackgroundTask() noexcept
+	{
+		if (BackgroundQueue.IsEmpty())
+		{
+			return nullptr;
+		}
+
+		if (LocalBackgroundTaskDepth > 0)
+		{
+			return BackgroundQueue.PopTask();
+		}
+
+		// Acquire background slot
+		for (;;)
+		{
+			const int activeCount = SDL_GetAtomicInt(&BackgroundActiveCount);
+
+			if (activeCount >= BackgroundWorkerLimit)
+			{
+				return nullptr;
+			}
+
+			if (SDL_CompareAndSwapAtomicInt(&BackgroundActiveCount, activeCount, activeCount + 1))
+			{
+				break;
+			}
+		}
+
+		RpgThreadTask* task = BackgroundQueue.PopTask();
+
+		if (task == nullptr)
+		{
+			SDL_AddAtomicInt(&BackgroundActiveCount, -1);
+		}
+
+		return task;
+	}
+
+
+	// Find task to execute, frame-critical first.
+	// @param threadIndex - Current thread context index
+	// @param bAllowBackground - Allow to take background task
+	static inline RpgThreadTask* FindTask(int threadIndex, bool bAllowBackground) noexcept
+	{
+		RpgThreadTask* task = nullptr;
+
+		if (bAllowBackground && LocalFrameTaskStreak >= BACKGROUND_STARVATION_LIMIT)
+		{
+			task = FindBackgroundTask();
+
+			if (task)
+			{
+				LocalFrameTaskStreak = 0;
+				return task;
+			}
+		}
+
+		task = FindFrameTask(threadIndex);
+
+		if (task)
+		{
+			if (!BackgroundQueue.IsEmpty())
+			{
+				++LocalFrameTaskStreak;
 			}
 
-			//RPG_PLATFORM_LogDebug(RpgLogSystem, "%s back to wait", threadName);
+			return task;
+		}
+
+		if (bAllowBackground)
+		{
+			task = FindBackgroundTask();
+			LocalFrameTaskStreak = 0;
+		}
+
+		return task;
+	}
+
+
+	static inline void SignalWorkers(int taskCount) noexcept
+	{
+		// No need to wake up more workers than the number of tasks
+		const int signalCount = (taskCount < ThreadWorkerCount) ? taskCount : ThreadWorkerCount;
+
+		for (int i = 0; i < signalCount; ++i)
+		{
+			SDL_SignalSemaphore(SignalSemaphore);
+		}
+	}
+
+
+	// Workers that found the slot limit reached went back to sleep, wake one for the queued background tasks.
+	// Slot may be released by a thread that is not a worker (e.g. main thread helping in Wait), nobody else would wake them.
+	static inline void ReleaseBackgroundSlot() noexcept
+	{
+		SDL_AddAtomicInt(&BackgroundActiveCount, -1);
+
+		if (!BackgroundQueue.IsEmpty())
+		{
+			SignalWorkers(1);
+		}
+	}
+
+
+	// Execute task then queue its successors that become ready. Successors are pushed into current thread deque,
+	// so that worker thread picks up the continuation right away.
+	static void ExecuteAndReleaseTask(RpgThreadTask* task) noexcept
+	{
+	#ifndef RPG_BUILD_SHIPPING
+		if (RpgProfiler::IsRecording())
+		{
+			const char* taskName = task->GetTaskName();
+			const uint64_t beginTicks = RpgProfiler::GetTicks();
+			task->Execute();
+			RpgProfiler::AddEvent(taskName ? taskName : "RpgThreadTask", beginTicks, RpgProfiler::GetTicks());
+		}
+		else
+	#endif // !RPG_BUILD_SHIPPING
+		{
+			task->Execute();
+		}
+
+		const RpgArray<RpgThreadTask*>& successors = task->GetSuccessors();
+		int readyCount = 0;
+
+		for (int i = 0; i < successors.GetCount(); ++i)
+		{
+			RpgThreadTask* successor = successors[i];
+
+			if (successor->ReleaseDependency())
+			{
+				QueueTask(successor);
+				++readyCount;
+			}
+		}
+
+		// Must be the last access to the task, owner may reset it once it's done
+		task->SetDone();
+
+		if (SDL_GetAtomicInt(&WaitSleeperCount) > 0)
+		{
+			SDL_LockMutex(WaitMutex);
+			SDL_BroadcastCondition(WaitCondition);
+			SDL_UnlockMutex(WaitMutex);
+		}
+
+		// Current worker will pop one of them, wake others for the rest
+		const bool bIsWorker = LocalThreadIndex > 0;
+		SignalWorkers(bIsWorker ? readyCount - 1 : readyCount);
+	}
+
+
+	// Execute task found by FindTask
+	static inline void ExecuteQueuedTask(RpgThreadTask* task) noexcept
+	{
+		// Read before execute, the task must not be accessed once it's done
+		const bool bBackground = task->GetPriority() == RpgThreadTaskPriority::BACKGROUND;
+
+		if (bBackground)
+		{
+			++LocalBackgroundTaskDepth;
+		}
+
+		ExecuteAndReleaseTask(task);
+
+		// Nested background task shares the slot of the outer one
+		if (bBackground && --LocalBackgroundTaskDepth == 0)
+		{
+			ReleaseBackgroundSlot();
+		}
+	}
+
+
+	static int ThreadWorkerMain(void* data) noexcept
+	{
+		RpgThreadPool::FThreadContext* worker = reinterpret_cast<RpgThreadPool::FThreadContext*>(data);
+		const char* threadName = worker->Name;
+		LocalThreadIndex = worker->Index;
+		RpgProfiler::RegisterThread(threadName);
+		LocalRandomSeed += static_cast<uint32_t>(worker->Index) * 2654435761u;
+
+		while (SDL_GetAtomicInt(&worker->IsRunning))
+		{
+			RpgThreadTask* task = FindTask(worker->Index, true);
+
+			if (task == nullptr)
+			{
+				SDL_WaitSemaphore(SignalSemaphore);
+				continue;
+			}
+
+			//RPG_PLATFORM_LogDebug(RpgLogSystem, "%s execute task %s", threadName, task->GetTaskName());
+			ExecuteQueuedTask(task);
 		}
 
 		RPG_Log(RpgLogSystem, "%s exit", threadName);
@@ -117,24 +624,49 @@ void RpgThreadPool::Initialize(int numOtherDedicatedThreads) noexcept
 	RPG_RuntimeErrorCheck(cpuCount >= 4, "CPU must have at least 4 cores!");
 
 	// Exclude dedicated threads and main thread
-	const int numThreadWorkers = cpuCount - numOtherDedicatedThreads - 1;
+	int numThreadWorkers = cpuCount - numOtherDedicatedThreads - 1;
+	if (numThreadWorkers > MAX_THREAD_WORKER)
+	{
+		numThreadWorkers = MAX_THREAD_WORKER;
+	}
+
 	RPG_Validate(numThreadWorkers > 1);
 
 	RPG_Log(RpgLogSystem, "Initialize threadpool with %i worker threads", numThreadWorkers);
 
 	SignalSemaphore = SDL_CreateSemaphore(0);
-	TaskQueue.Initialize();
-	ThreadWorkers.Resize(numThreadWorkers);
-	char tempName[32];
+	SharedQueue.Initialize();
+
+	// By default half of the workers may execute background tasks
+	BackgroundQueue.Initialize();
+	SDL_SetAtomicInt(&BackgroundActiveCount, 0);
+	BackgroundWorkerLimit = (numThreadWorkers / 2 > 1) ? numThreadWorkers / 2 : 1;
+
+	WaitMutex = SDL_CreateMutex();
+	WaitCondition = SDL_CreateCondition();
+	SDL_SetAtomicInt(&WaitSleeperCount, 0);
 
-	for (int i = 0; i < numThreadWorkers; ++i)
+	// Context for main thread + worker threads
+	ThreadWorkerCount = numThreadWorkers;
+	ThreadContextCount = numThreadWorkers + 1;
+	ThreadContexts = new FThreadContext[ThreadContextCount];
+
+	for (int i = 0; i < ThreadContextCount; ++i)
+	{
+		ThreadContexts[i].Index = i;
+	}
+
+	// Initialize must be called from main thread
+	LocalThreadIndex = 0;
+
+	for (int i = 1; i < ThreadContextCount; ++i)
 	{
-		FThreadWorker& worker = ThreadWorkers[i];
-		snprintf(tempName, 32, "Thread-Worker-%i", i);
+		FThreadContext& worker = ThreadContexts[i];
+		snprintf(worker.Name, sizeof(worker.Name), "Thread-Worker-%i", i - 1);
 		SDL_SetAtomicInt(&worker.IsRunning, 1);
-		worker.Handle = SDL_CreateThread(ThreadWorkerMain, tempName, &worker);
+		worker.Handle = SDL_CreateThread(ThreadWorkerMain, worker.Name, &worker);
 	}
-	
+
 	bInitialized = true;
 }
 
@@ -148,29 +680,42 @@ void RpgThreadPool::Shutdown() noexcept
 
 	RPG_Log(RpgLogSystem, "Shutdown threadpool");
 
-	for (int t = 0; t < ThreadWorkers.GetCount(); ++t)
+	for (int t = 1; t < ThreadContextCount; ++t)
 	{
-		FThreadWorker& worker = ThreadWorkers[t];
-		SDL_SetAtomicInt(&worker.IsRunning, 0);
+		SDL_SetAtomicInt(&ThreadContexts[t].IsRunning, 0);
 	}
 
-	for (int t = 0; t < ThreadWorkers.GetCount(); ++t)
+	for (int t = 1; t < ThreadContextCount; ++t)
 	{
 		SDL_SignalSemaphore(SignalSemaphore);
 	}
 
-	for (int t = 0; t < ThreadWorkers.GetCount(); ++t)
+	for (int t = 1; t < ThreadContextCount; ++t)
 	{
-		FThreadWorker& worker = ThreadWorkers[t];
+		FThreadContext& worker = ThreadContexts[t];
 		SDL_WaitThread(worker.Handle, nullptr);
 		worker.Handle = nullptr;
 	}
 
-	ThreadWorkers.Clear();
+	delete[] ThreadContexts;
+	ThreadContexts = nullptr;
+	ThreadContextCount = 0;
+	ThreadWorkerCount = 0;
+	LocalThreadIndex = RPG_INDEX_INVALID;
+
+	SharedQueue.Shutdown();
+	BackgroundQueue.Shutdown();
+	BackgroundWorkerLimit = 0;
 
 	SDL_DestroySemaphore(SignalSemaphore);
 	SignalSemaphore = nullptr;
 
+	SDL_DestroyCondition(WaitCondition);
+	WaitCondition = nullptr;
+
+	SDL_DestroyMutex(WaitMutex);
+	WaitMutex = nullptr;
+
 	bInitialized = false;
 }
 
@@ -186,10 +731,190 @@ void RpgThreadPool::SubmitTasks(RpgThreadTask** tasks, int taskCount) noexcept
 		task->SetRunning();
 	}
 
-	TaskQueue.PushTasks(tasks, taskCount);
+	int readyCount = 0;
 
 	for (int i = 0; i < taskCount; ++i)
 	{
-		SDL_SignalSemaphore(SignalSemaphore);
+		RpgThreadTask* task = tasks[i];
+
+		if (task->ReleaseDependency())
+		{
+			QueueTask(task);
+			++readyCount;
+		}
+	}
+
+	SignalWorkers(readyCount);
+}
+
+
+void RpgThreadPool::ExecuteTasks(RpgThreadTask** tasks, int taskCount) noexcept
+{
+	for (int i = 0; i < taskCount; ++i)
+	{
+		RpgThreadTask* task = tasks[i];
+		RPG_CheckV(task->IsIdle(), "Task executed must be on idle state!");
+		task->SetRunning();
+		ExecuteAndReleaseTask(task);
+	}
+}
+
+
+int RpgThreadPool::GetWorkerCount() noexcept
+{
+	return ThreadWorkerCount;
+}
+
+
+int RpgThreadPool::GetThreadIndex() noexcept
+{
+	return LocalThreadIndex;
+}
+
+
+void RpgThreadPool::SetBackgroundWorkerLimit(int count) noexcept
+{
+	RPG_Assert(bInitialized);
+
+	if (count < 1)
+	{
+		count = 1;
+	}
+	else if (count > ThreadWorkerCount)
+	{
+		count = ThreadWorkerCount;
 	}
+
+	BackgroundWorkerLimit = count;
+
+	// Wake up workers in case limit has been increased
+	SignalWorkers(count);
+}
+
+
+int RpgThreadPool::GetBackgroundWorkerLimit() noexcept
+{
+	return BackgroundWorkerLimit;
+}
+
+
+void RpgThreadPool::ParallelFor(int count, int grainSize, FParallelForFunction function, void* context) noexcept
+{
+	RPG_Assert(function);
+
+	if (count <= 0)
+	{
+		return;
+	}
+
+	if (grainSize <= 0)
+	{
+		const int targetChunkCount = (ThreadWorkerCount + 1) * PARALLEL_FOR_CHUNK_PER_THREAD;
+		grainSize = (count + targetChunkCount - 1) / targetChunkCount;
+	}
+
+	const int chunkCount = (count + grainSize - 1) / grainSize;
+
+	if (chunkCount == 1 || !bInitialized)
+	{
+		function(context, 0, count);
+		return;
+	}
+
+	// First chunk is executed by calling thread
+	const int taskCount = chunkCount - 1;
+
+	FParallelForTaskPool& pool = LocalParallelForTaskPool;
+	const int taskStartIndex = pool.UsedCount;
+	pool.UsedCount += taskCount;
+
+	for (int i = pool.Tasks.GetCount(); i < pool.UsedCount; ++i)
+	{
+		pool.Tasks.AddValue(new FParallelForTask());
+	}
+
+	RpgThreadTask** tasks = pool.Tasks.GetData(taskStartIndex);
+
+	for (int i = 0; i < taskCount; ++i)
+	{
+		FParallelForTask* task = static_cast<FParallelForTask*>(tasks[i]);
+		task->Reset();
+		task->Function = function;
+		task->Context = context;
+		task->BeginIndex = (i + 1) * grainSize;
+		task->EndIndex = (task->BeginIndex + grainSize < count) ? task->BeginIndex + grainSize : count;
+	}
+
+	SubmitTasks(tasks, taskCount);
+
+	function(context, 0, grainSize);
+
+	// Wait from the last submitted, they are popped first (LIFO) by the calling thread while helping.
+	// Access through pool, nested ParallelFor may grow the pool while this thread is helping.
+	for (int i = taskCount - 1; i >= 0; --i)
+	{
+		pool.Tasks[taskStartIndex + i]->Wait();
+	}
+
+	pool.UsedCount = taskStartIndex;
+}
+
+
+
+void RpgThreadTask::Wait() noexcept
+{
+	using namespace RpgThreadPool;
+
+	int backoffCount = 0;
+
+	while (IsRunning())
+	{
+		// Help execute queued tasks instead of burning the core. This also prevents deadlock when waiting inside a task.
+		if (bInitialized)
+		{
+			// Only help background tasks when waiting for background task, frame-critical waiter must not get stuck in long running task
+			RpgThreadTask* task = FindTask(LocalThreadIndex, Priority == RpgThreadTaskPriority::BACKGROUND);
+
+			if (task)
+			{
+				ExecuteQueuedTask(task);
+				backoffCount = 0;
+				continue;
+			}
+		}
+
+		if (backoffCount < WAIT_SPIN_COUNT)
+		{
+			SDL_CPUPauseInstruction();
+		}
+		else if (backoffCount < WAIT_SPIN_COUNT + WAIT_YIELD_COUNT)
+		{
+			SDL_Delay(0);
+		}
+		else if (bInitialized)
+		{
+			// Nothing to steal, task is being executed by other thread. Sleep until any task is done.
+			SDL_AddAtomicInt(&WaitSleeperCount, 1);
+			SDL_LockMutex(WaitMutex);
+
+			if (IsRunning())
+			{
+				SDL_WaitConditionTimeout(WaitCondition, WaitMutex, WAIT_SLEEP_TIMEOUT_MS);
+			}
+
+			SDL_UnlockMutex(WaitMutex);
+			SDL_AddAtomicInt(&WaitSleeperCount, -1);
+		}
+		else
+		{
+			SDL_Delay(0);
+		}
+
+		if (backoffCount < WAIT_SPIN_COUNT + WAIT_YIELD_COUNT)
+		{
+			++backoffCount;
+		}
+	}
+
+	RPG_Assert(IsDone());
 }
@@ -1,6 +1,19 @@
 #pragma once
 
 #include "RpgPlatform.h"
+#include "dsa/RpgArray.h"
+#include "dsa/RpgFreeList.h"
+
+
+
+enum class RpgThreadTaskPriority : uint8_t
+{
+	// Per-frame work (animation, physics, render passes). Always scheduled first.
+	FRAME_CRITICAL = 0,
+
+	// Long running work that may span multiple frames (asset import, shader compile, PSO compile). Limited number of workers.
+	BACKGROUND
+};
 
 
 
@@ -11,6 +24,8 @@ class RpgThreadTask
 public:
 	RpgThreadTask() noexcept
 		: State()
+		, PendingDependencyCount{ 1 }
+		, Priority(RpgThreadTaskPriority::FRAME_CRITICAL)
 	{
 	}
 
@@ -23,12 +38,63 @@ public:
 	{
 		RPG_AssertV(SDL_GetAtomicInt(&State) != 1, "Cannot reset while it's still running!");
 		SDL_SetAtomicInt(&State, 0);
+		SDL_SetAtomicInt(&PendingDependencyCount, 1);
+		Successors.Clear();
 	}
 
 	virtual void Execute() noexcept = 0;
 	virtual const char* GetTaskName() const noexcept { return nullptr; }
 
 
+	// Declare that this task must be executed after <predecessor> has finished.
+	// Both tasks must be in idle state, call it after Reset() and before submit. Dependencies are cleared on Reset().
+	// The task can be submitted before or after its predecessor, it will be queued once all predecessors are done.
+	// @param predecessor - Task that must finish first
+	// @returns None
+	inline void AddDependency(RpgThreadTask* predecessor) noexcept
+	{
+		RPG_Assert(predecessor && predecessor != this);
+		RPG_AssertV(IsIdle() && predecessor->IsIdle(), "Task dependency must be added before submit!");
+
+		predecessor->Successors.AddValue(this);
+		SDL_AddAtomicInt(&PendingDependencyCount, 1);
+	}
+
+
+	// Called by threadpool to release one dependency (or the submit itself). Do not call this manually!
+	// @returns True if task has no more pending dependencies and ready to be queued
+	inline bool ReleaseDependency() noexcept
+	{
+		const int prevCount = SDL_AddAtomicInt(&PendingDependencyCount, -1);
+		RPG_Assert(prevCount > 0);
+
+		return prevCount == 1;
+	}
+
+
+	// Set scheduling priority. Priority is not cleared on Reset(), usually set once in the constructor of derived task.
+	// @param in_Priority - Task priority
+	// @returns None
+	inline void SetPriority(RpgThreadTaskPriority in_Priority) noexcept
+	{
+		RPG_AssertV(!IsRunning(), "Cannot change priority while it's still running!");
+		Priority = in_Priority;
+	}
+
+
+	inline RpgThreadTaskPriority GetPriority() const noexcept
+	{
+		return Priority;
+	}
+
+
+	// Get tasks that depend on this task
+	inline const RpgArray<RpgThreadTask*>& GetSuccessors() const noexcept
+	{
+		return Successors;
+	}
+
+
 	// Called by threadpool when submit task. Do not call this manually!
 	inline void SetRunning() noexcept
 	{
@@ -42,13 +108,10 @@ public:
 	}
 
 
-	// [Block] Wait until task finished.
+	// [Block] Wait until task finished. Calling thread executes other queued tasks while waiting,
+	// then backs off (pause, yield) and finally sleeps until any task finished.
 	// @returns None
-	inline void Wait() noexcept
-	{
-		while (SDL_GetAtomicInt(&State) == 1);
-		RPG_Assert(SDL_GetAtomicInt(&State) == 2);
-	}
+	void Wait() noexcept;
 
 
 	// Check if task is in idle state
@@ -74,6 +137,15 @@ private:
 	// [0]: Idle, [1]: Running, [2]: Done
 	mutable SDL_AtomicInt State;
 
+	// Number of unfinished predecessors + 1 for the submit itself
+	SDL_AtomicInt PendingDependencyCount;
+
+	// Tasks that will be released when this task finished
+	RpgArray<RpgThreadTask*> Successors;
+
+	// Scheduling lane
+	RpgThreadTaskPriority Priority;
+
 };
 
 
@@ -102,12 +174,201 @@ namespace RpgThreadPool
 	void Shutdown() noexcept;
 
 
-	// Submit task. 
+	// Submit task. Frame-critical tasks are pushed into the calling thread queue and will be stolen by idle worker threads.
+	// Background tasks are pushed into background queue, they are picked up only when there is no frame-critical task
+	// (or after a long run of frame-critical tasks) and by limited number of workers.
+	// Task that still has pending dependencies is queued later by the thread that finished its last predecessor.
 	// @param task - Task to submit
 	// @returns None
 	void SubmitTasks(RpgThreadTask** tasks, int taskCount) noexcept;
 
 
+	// Execute tasks immediately on calling thread in order. Dependent tasks are released into threadpool as usual.
+	// @param tasks - Pointer to task data array
+	// @param taskCount - Number of task count
+	// @returns None
+	void ExecuteTasks(RpgThreadTask** tasks, int taskCount) noexcept;
+
+
+	// Get number of worker threads
+	// @returns Worker thread count
+	[[nodiscard]] int GetWorkerCount() noexcept;
+
+
+	// Get index of calling thread
+	// @returns 0 for main thread, [1, GetWorkerCount()] for worker threads, RPG_INDEX_INVALID for threads not owned by thread pool
+	[[nodiscard]] int GetThreadIndex() noexcept;
+
+
+	// Set maximum number of worker threads that can execute background tasks at the same time.
+	// @param count - Number of workers, clamped to [1, WorkerCount]
+	// @returns None
+	void SetBackgroundWorkerLimit(int count) noexcept;
+
+
+	// Get maximum number of worker threads that can execute background tasks at the same time
+	// @returns Background worker limit
+	[[nodiscard]] int GetBackgroundWorkerLimit() noexcept;
+
+
+	// Function called for each chunk of ParallelFor. Process elements in range [beginIndex, endIndex)
+	typedef void (*FParallelForFunction)(void* context, int beginIndex, int endIndex);
+
+
+	// [Block] Split range [0, count) into chunks of <grainSize> and execute <function> for each chunk in parallel.
+	// Chunk tasks are taken from calling thread task pool, the calling thread executes the first chunk and helps the rest.
+	// @param count - Number of elements
+	// @param grainSize - Number of elements per chunk. If <= 0, it's calculated from the number of worker threads
+	// @param function - Function to call for each chunk
+	// @param context - User data passed to <function>
+	// @returns None
+	void ParallelFor(int count, int grainSize, FParallelForFunction function, void* context) noexcept;
+
+
+	// [Block] Split range [0, count) into chunks and call <function>(beginIndex, endIndex) for each chunk in parallel
+	template<typename TFunction>
+	inline void ParallelFor(int count, int grainSize, TFunction&& function) noexcept
+	{
+		typedef std::remove_reference_t<TFunction> FFunctionType;
+
+		ParallelFor(count, grainSize, 
+			[](void* context, int beginIndex, int endIndex)
+			{
+				(*static_cast<FFunctionType*>(context))(beginIndex, endIndex);
+			},
+			const_cast<void*>(static_cast<const void*>(&function))
+		);
+	}
+
+
+	// [Block] Call <function>(T& value, int index) for each valid element in <freeList> in parallel.
+	// Chunks are split by freelist capacity, elements must not be added or removed while iterating.
+	template<typename T, typename TFunction>
+	inline void ParallelForEach(RpgFreeList<T>& freeList, int grainSize, TFunction&& function) noexcept
+	{
+		ParallelFor(freeList.GetCapacity(), grainSize, 
+			[&freeList, &function](int beginIndex, int endIndex)
+			{
+				for (int i = freeList.FindNextValidIndex(beginIndex); i < endIndex; i = freeList.FindNextValidIndex(i + 1))
+				{
+					function(freeList.GetAt(i), i);
+				}
+			}
+		);
+	}
+
+
+	// [Block] Sort <data> with <compare> using parallel merge sort. Ranges are sorted in parallel, then merged in passes
+	// where each merge is split into independent parts so that every pass runs on all worker threads. Not stable.
+	// Small arrays are sorted on calling thread with RpgAlgorithm::Sort.
+	// @param data - Pointer to element array
+	// @param count - Number of elements
+	// @param compare - Less than comparator, must be safe to call from multiple threads
+	// @returns None
+	template<typename T, typename TCompare>
+	inline void ParallelSort(T* data, int count, TCompare compare) noexcept
+	{
+		constexpr int MIN_PARALLEL_COUNT = 8192;
+		constexpr int MIN_RUN_SIZE = 1024;
+
+		const int threadCount = GetWorkerCount() + 1;
+
+		if (count < MIN_PARALLEL_COUNT || threadCount == 1)
+		{
+			RpgAlgorithm::Sort(data, count, compare);
+			return;
+		}
+
+		// Sort runs
+		int runCount = 1;
+		while (runCount < threadCount * 2 && count / (runCount * 2) >= MIN_RUN_SIZE)
+		{
+			runCount *= 2;
+		}
+
+		const int runSize = (count + runCount - 1) / runCount;
+
+		ParallelFor(runCount, 1, 
+			[&](int beginIndex, int endIndex)
+			{
+				for (int r = beginIndex; r < endIndex; ++r)
+				{
+					const int first = r * runSize;
+					const int last = (first + runSize < count) ? first + runSize : count;
+
+					if (first < last)
+					{
+						RpgAlgorithm::Sort(data + first, last - first, compare);
+					}
+				}
+			}
+		);
+
+		// Merge passes, ping-pong between data and temp
+		RpgArray<T> temp(count);
+		T* src = data;
+		T* dst = temp.GetData();
+
+		for (int width = runSize; width < count; width *= 2)
+		{
+			const int pairCount = (count + width * 2 - 1) / (width * 2);
+			const int partCount = (pairCount < threadCount * 2) ? (threadCount * 2 + pairCount - 1) / pairCount : 1;
+
+			ParallelFor(pairCount * partCount, 1, 
+				[&](int beginIndex, int endIndex)
+				{
+					for (int t = beginIndex; t < endIndex; ++t)
+					{
+						const int pair = t / partCount;
+						const int part = t % partCount;
+
+						const int first = pair * width * 2;
+						const int mid = (first + width < count) ? first + width : count;
+						const int last = (first + width * 2 < count) ? first + width * 2 : count;
+
+						const T* a = src + first;
+						const T* b = src + mid;
+						const int countA = mid - first;
+						const int countB = last - mid;
+						const int total = countA + countB;
+
+						const int outBegin = static_cast<int>(static_cast<int64_t>(total) * part / partCount);
+						const int outEnd = static_cast<int>(static_cast<int64_t>(total) * (part + 1) / partCount);
+						const int aBegin = RpgAlgorithm::Merge_FindSplitIndex(outBegin, a, countA, b, countB, compare);
+						const int aEnd = RpgAlgorithm::Merge_FindSplitIndex(outEnd, a, countA, b, countB, compare);
+						const int bBegin = outBegin - aBegin;
+						const int bEnd = outEnd - aEnd;
+
+						RpgAlgorithm::Merge(a + aBegin, aEnd - aBegin, b + bBegin, bEnd - bBegin, dst + first + outBegin, compare);
+					}
+				}
+			);
+
+			RpgAlgorithm::Swap(src, dst);
+		}
+
+		if (src != data)
+		{
+			ParallelFor(count, 0, 
+				[&](int beginIndex, int endIndex)
+				{
+					for (int i = beginIndex; i < endIndex; ++i)
+					{
+						data[i] = std::move(src[i]);
+					}
+				}
+			);
+		}
+	}
+
+
+	template<typename T>
+	inline void ParallelSort(T* data, int count) noexcept
+	{
+		ParallelSort(data, count, [](const T& a, const T& b) { return a < b; });
+	}
+
+
 	// [Block] Wait all tasks
 	// @param tasks - Pointer to task data array
 	// @param taskCount - Number of task count
@@ -116,7 +377,7 @@ namespace RpgThreadPool
 
 
 	// Submit <tasks> into threadpool or execute in serial based on <bCondition>
-	template<typename bool bCondition = false>
+	template<bool bCondition = false>
 	inline void SubmitOrExecuteTasks(RpgThreadTask** tasks, int taskCount) noexcept
 	{
 		if (tasks == nullptr || taskCount == 0)
@@ -130,13 +391,7 @@ namespace RpgThreadPool
 		}
 		else
 		{
-			for (int i = 0; i < taskCount; ++i)
-			{
-				RpgThreadTask* task = tasks[i];
-				task->SetRunning();
-				task->Execute();
-				task->SetDone();
-			}
+			ExecuteTasks(tasks, taskCount);
 		}
 	}
 
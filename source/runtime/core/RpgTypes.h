@@ -4,6 +4,7 @@
 #include <cstdio>
 #include <cstdarg>
 #include <utility>
+#include <new>
 
 
 #define RPG_INDEX_INVALID			-1
@@ -17,6 +18,8 @@
 
 #define RPG_FRAME_BUFFERING			3
 
+#define RPG_CACHE_LINE_SIZE			64
+
 
 
 #define RPG_NOCOPY(type)					\
@@ -9,9 +9,9 @@ namespace RpgAlgorithm
 	template<typename T>
 	inline void Swap(T& out_A, T& out_B) noexcept
 	{
-		T temp = out_A;
-		out_A = out_B;
-		out_B = temp;
+		T temp = std::move(out_A);
+		out_A = std::move(out_B);
+		out_B = std::move(temp);
 	}
 
 
@@ -66,14 +66,14 @@ namespace RpgAlgorithm
 		const int removeIndex = (index == RPG_INDEX_LAST) ? lastIndex : index;
 		RPG_CheckV(removeIndex >= 0 && (removeIndex + count) <= dataCount, "RpgAlgorithm: Array remove elements range out of bound!");
 
-		if (removeIndex == lastIndex && count == 1)
+		if (removeIndex + count == dataCount)
 		{
 			return;
 		}
 
 		if (count > 1 || bKeepOrder)
 		{
-			Array_ShiftElements(lastIndex - removeIndex, dataArray, dataCount, removeIndex, removeIndex + 1);
+			Array_ShiftElements(dataCount - removeIndex - count, dataArray, dataCount, removeIndex, removeIndex + count);
 		}
 		else
 		{
@@ -179,4 +179,358 @@ namespace RpgAlgorithm
 		return RPG_INDEX_INVALID;
 	}
 
+
+
+	// ============================================================================================================================================================================================== //
+	// Sort
+	// ============================================================================================================================================================================================== //
+	template<typename T, typename TCompare>
+	inline void InsertionSort(T* data, int count, TCompare compare) noexcept
+	{
+		for (int i = 1; i < count; ++i)
+		{
+			T value = std::move(data[i]);
+			int j = i - 1;
+
+			while (j >= 0 && compare(value, data[j]))
+			{
+				data[j + 1] = std::move(data[j]);
+				--j;
+			}
+
+			data[j + 1] = std::move(value);
+		}
+	}
+
+
+	template<typename T, typename TCompare>
+	inline void HeapSort_SiftDown(T* data, int rootIndex, int count, TCompare compare) noexcept
+	{
+		T value = std::move(data[rootIndex]);
+
+		while (true)
+		{
+			int childIndex = rootIndex * 2 + 1;
+			if (childIndex >= count)
+			{
+				break;
+			}
+
+			if (childIndex + 1 < count && compare(data[childIndex], data[childIndex + 1]))
+			{
+				++childIndex;
+			}
+
+			if (!compare(value, data[childIndex]))
+			{
+				break;
+			}
+
+			data[rootIndex] = std::move(data[childIndex]);
+			rootIndex = childIndex;
+		}
+
+		data[rootIndex] = std::move(value);
+	}
+
+
+	template<typename T, typename TCompare>
+	inline void HeapSort(T* data, int count, TCompare compare) noexcept
+	{
+		for (int i = count / 2 - 1; i >= 0; --i)
+		{
+			HeapSort_SiftDown(data, i, count, compare);
+		}
+
+		for (int i = count - 1; i > 0; --i)
+		{
+			Swap(data[0], data[i]);
+			HeapSort_SiftDown(data, 0, i, compare);
+		}
+	}
+
+
+	template<typename T, typename TCompare>
+	inline void IntroSort_Recursive(T* data, int count, int depthLimit, TCompare compare) noexcept
+	{
+		constexpr int INSERTION_SORT_THRESHOLD = 16;
+
+		while (count > INSERTION_SORT_THRESHOLD)
+		{
+			if (depthLimit == 0)
+			{
+				HeapSort(data, count, compare);
+				return;
+			}
+
+			--depthLimit;
+
+			// Median of three into data[0], used as pivot
+			const int mid = count / 2;
+			const int last = count - 1;
+
+			if (compare(data[mid], data[0]))
+			{
+				Swap(data[mid], data[0]);
+			}
+
+			if (compare(data[last], data[mid]))
+			{
+				Swap(data[last], data[mid]);
+
+				if (compare(data[mid], data[0]))
+				{
+					Swap(data[mid], data[0]);
+				}
+			}
+
+			Swap(data[0], data[mid]);
+
+			// Hoare partition around data[0]
+			int left = 0;
+			int right = count;
+
+			while (true)
+			{
+				do { ++left; } while (left < count && compare(data[left], data[0]));
+				do { --right; } while (compare(data[0], data[right]));
+
+				if (left >= right)
+				{
+					break;
+				}
+
+				Swap(data[left], data[right]);
+			}
+
+			Swap(data[0], data[right]);
+
+			// Recurse into smaller partition, loop on the larger one
+			const int leftCount = right;
+			const int rightCount = count - right - 1;
+
+			if (leftCount < rightCount)
+			{
+				IntroSort_Recursive(data, leftCount, depthLimit, compare);
+				data += right + 1;
+				count = rightCount;
+			}
+			else
+			{
+				IntroSort_Recursive(data + right + 1, rightCount, depthLimit, compare);
+				count = leftCount;
+			}
+		}
+
+		InsertionSort(data, count, compare);
+	}
+
+
+	// Sort elements with <compare>(a, b) returning true if a must be placed before b. Not stable.
+	// Quick sort with median of three pivot, falls back to heap sort on bad partitions and insertion sort on small range.
+	// @param data - Pointer to element array
+	// @param count - Number of elements
+	// @param compare - Less than comparator
+	// @returns None
+	template<typename T, typename TCompare>
+	inline void Sort(T* data, int count, TCompare compare) noexcept
+	{
+		if (data == nullptr || count < 2)
+		{
+			return;
+		}
+
+		int depthLimit = 0;
+		for (int n = count; n > 1; n >>= 1)
+		{
+			depthLimit += 2;
+		}
+
+		IntroSort_Recursive(data, count, depthLimit, compare);
+	}
+
+
+	template<typename T>
+	inline void Sort(T* data, int count) noexcept
+	{
+		Sort(data, count, [](const T& a, const T& b) { return a < b; });
+	}
+
+
+	// Merge two sorted ranges [a, a + countA) and [b, b + countB) into <out>. Stable, ties are taken from <a> first.
+	template<typename T, typename TCompare>
+	inline void Merge(const T* a, int countA, const T* b, int countB, T* out, TCompare compare) noexcept
+	{
+		int i = 0;
+		int j = 0;
+		int k = 0;
+
+		while (i < countA && j < countB)
+		{
+			if (compare(b[j], a[i]))
+			{
+				out[k++] = b[j++];
+			}
+			else
+			{
+				out[k++] = a[i++];
+			}
+		}
+
+		while (i < countA)
+		{
+			out[k++] = a[i++];
+		}
+
+		while (j < countB)
+		{
+			out[k++] = b[j++];
+		}
+	}
+
+
+	// Number of elements taken from <a> in the first <outputIndex> elements of Merge(a, b). Used to split one merge into independent parts.
+	// @returns Index into <a>, the matching index into <b> is (outputIndex - returned index)
+	template<typename T, typename TCompare>
+	inline int Merge_FindSplitIndex(int outputIndex, const T* a, int countA, const T* b, int countB, TCompare compare) noexcept
+	{
+		int low = outputIndex > countB ? outputIndex - countB : 0;
+		int high = outputIndex < countA ? outputIndex : countA;
+
+		while (low < high)
+		{
+			const int i = (low + high) / 2;
+			const int j = outputIndex - i;
+
+			// a[i] is merged before b[j - 1], more elements must come from <a>
+			if (j > 0 && i < countA && !compare(b[j - 1], a[i]))
+			{
+				low = i + 1;
+			}
+			else
+			{
+				high = i;
+			}
+		}
+
+		return low;
+	}
+
+
+	// Stable LSD radix sort of unsigned integer keys (8 bits per pass), values are reordered along with the keys.
+	// Passes where every key has the same byte are skipped. Result is written back to <keys> and <values>.
+	// @param keys - Key array (uint32_t or uint64_t)
+	// @param values - Value array with <count> elements, can be nullptr to sort keys only
+	// @param count - Number of elements
+	// @param tempKeys - Scratch key array with <count> elements
+	// @param tempValues - Scratch value array with <count> elements, can be nullptr if <values> is nullptr
+	// @returns None
+	template<typename TKey, typename TValue>
+	inline void RadixSort(TKey* keys, TValue* values, int count, TKey* tempKeys, TValue* tempValues) noexcept
+	{
+		static_assert(std::is_same<TKey, uint32_t>::value || std::is_same<TKey, uint64_t>::value, "RpgAlgorithm::RadixSort type of <TKey> must be uint32_t or uint64_t!");
+		static_assert(std::is_trivially_copyable<TValue>::value, "RpgAlgorithm::RadixSort type of <TValue> must be trivially copyable!");
+
+		constexpr int PASS_COUNT = sizeof(TKey);
+
+		if (count < 2)
+		{
+			return;
+		}
+
+		RPG_Check(keys && tempKeys);
+		RPG_Check(values == nullptr || tempValues);
+
+		// Build histogram of all passes at once
+		int histograms[PASS_COUNT][256] = {};
+
+		for (int i = 0; i < count; ++i)
+		{
+			const TKey key = keys[i];
+
+			for (int p = 0; p < PASS_COUNT; ++p)
+			{
+				++histograms[p][(key >> (p * 8)) & 0xFF];
+			}
+		}
+
+		TKey* srcKeys = keys;
+		TKey* dstKeys = tempKeys;
+		TValue* srcValues = values;
+		TValue* dstValues = tempValues;
+
+		for (int p = 0; p < PASS_COUNT; ++p)
+		{
+			int* histogram = histograms[p];
+
+			// All keys have the same byte, order would not change
+			if (histogram[(srcKeys[0] >> (p * 8)) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			// Exclusive prefix sum into bucket offsets
+			int offset = 0;
+			for (int b = 0; b < 256; ++b)
+			{
+				const int bucketCount = histogram[b];
+				histogram[b] = offset;
+				offset += bucketCount;
+			}
+
+			for (int i = 0; i < count; ++i)
+			{
+				const int dstIndex = histogram[(srcKeys[i] >> (p * 8)) & 0xFF]++;
+				dstKeys[dstIndex] = srcKeys[i];
+
+				if (srcValues)
+				{
+					dstValues[dstIndex] = srcValues[i];
+				}
+			}
+
+			Swap(srcKeys, dstKeys);
+			Swap(srcValues, dstValues);
+		}
+
+		// Odd number of executed passes, result is in scratch arrays
+		if (srcKeys != keys)
+		{
+			RpgPlatformMemory::MemCopy(keys, srcKeys, sizeof(TKey) * count);
+
+			if (values)
+			{
+				RpgPlatformMemory::MemCopy(values, srcValues, sizeof(TValue) * count);
+			}
+		}
+	}
+
+
+	// Radix sort with scratch memory allocated internally
+	template<typename TKey, typename TValue>
+	inline void RadixSort(TKey* keys, TValue* values, int count) noexcept
+	{
+		if (count < 2)
+		{
+			return;
+		}
+
+		TKey* tempKeys = static_cast<TKey*>(RpgPlatformMemory::MemMalloc(sizeof(TKey) * count));
+		TValue* tempValues = values ? static_cast<TValue*>(RpgPlatformMemory::MemMalloc(sizeof(TValue) * count)) : nullptr;
+
+		RadixSort(keys, values, count, tempKeys, tempValues);
+
+		RpgPlatformMemory::MemFree(tempKeys);
+		RpgPlatformMemory::MemFree(tempValues);
+	}
+
+
+	// Radix sort keys only
+	template<typename TKey>
+	inline void RadixSort(TKey* keys, int count) noexcept
+	{
+		RadixSort<TKey, TKey>(keys, nullptr, count);
+	}
+
+
 }; // RpgAlgorithm
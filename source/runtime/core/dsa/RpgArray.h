@@ -1,13 +1,17 @@
 #pragma once
 
 #include "RpgAlgorithm.h"
+#include "../RpgAllocator.h"
 
 
 #define RPG_ARRAY_ValidateIndex(i)		RPG_ValidateV(i >= 0 && i < Count, "RpgArray: Index (%i) out of bound!", i)
 
 
 
-template<typename T, int CAPACITY_ALIGNMENT = 1>
+// @param T - Element type
+// @param CAPACITY_ALIGNMENT - Capacity is rounded up to multiple of this value
+// @param TAllocator - Allocator policy (RpgAllocatorHeap, RpgAllocatorFrame)
+template<typename T, int CAPACITY_ALIGNMENT = 1, typename TAllocator = RpgAllocatorHeap>
 class RpgArray
 {
 	static_assert(RpgAlgorithm::IsPowerOfTwo(CAPACITY_ALIGNMENT), "RpgArray: CAPACITY_ALIGNMENT must be power of two!");
@@ -78,8 +82,8 @@ public:
 	}
 
 
-	template<int N>
-	RpgArray(const RpgArray<T, N>& other) noexcept
+	template<int N, typename TOtherAllocator>
+	RpgArray(const RpgArray<T, N, TOtherAllocator>& other) noexcept
 		: Data(nullptr)
 		, Capacity(0)
 		, Count(0)
@@ -144,8 +148,8 @@ public:
 	}
 
 
-	template<int N>
-	inline RpgArray& operator=(const RpgArray<T, N>& rhs) noexcept
+	template<int N, typename TOtherAllocator>
+	inline RpgArray& operator=(const RpgArray<T, N, TOtherAllocator>& rhs) noexcept
 	{
 		Clear();
 
@@ -302,7 +306,7 @@ public:
 		const int alignedCapacity = RpgType::Align(in_Capacity, CAPACITY_ALIGNMENT);
 		RPG_Check(alignedCapacity >= in_Capacity);
 
-		T* NewData = reinterpret_cast<T*>(RpgPlatformMemory::MemRealloc(Data, sizeof(T) * alignedCapacity));
+		T* NewData = reinterpret_cast<T*>(TAllocator::Reallocate(Data, sizeof(T) * Capacity, sizeof(T) * alignedCapacity));
 		RPG_Check(NewData);
 
 		Data = NewData;
@@ -457,10 +461,10 @@ public:
 	}
 
 
-	template<int N>
-	inline void InsertAtRange(const RpgArray<T, N>& other, int index) noexcept
+	template<int N, typename TOtherAllocator>
+	inline void InsertAtRange(const RpgArray<T, N, TOtherAllocator>& other, int index) noexcept
 	{
-		InsertAtRange(other.Data, other.Count, index);
+		InsertAtRange(other.GetData(), other.GetCount(), index);
 	}
 
 
@@ -484,14 +488,14 @@ public:
 		}
 
 		RPG_ARRAY_ValidateIndex(index);
-		RPG_ARRAY_ValidateIndex(index + count);
-		RpgAlgorithm::Array_RemoveElements(Data, Count, index, count, true);
+		RPG_ARRAY_ValidateIndex(index + count - 1);
 
-		if constexpr (!std::is_pod<T>::value)
+		if constexpr (!std::is_trivially_copyable<T>::value)
 		{
 			DestructElements(index, count);
 		}
 
+		RpgAlgorithm::Array_RemoveElements(Data, Count, index, count, true);
 		Count -= count;
 	}
 
@@ -504,11 +508,21 @@ public:
 		}
 
 		RPG_ARRAY_ValidateIndex(index);
-		RpgAlgorithm::Array_RemoveElements(Data, Count, index, 1, bKeepOrder);
 
-		if constexpr (!std::is_trivially_copyable<T>::value)
+		// Removed element is destructed before it gets overwritten by shift, or the moved-from last element after swap
+		if constexpr (std::is_trivially_copyable<T>::value)
+		{
+			RpgAlgorithm::Array_RemoveElements(Data, Count, index, 1, bKeepOrder);
+		}
+		else if (bKeepOrder)
 		{
 			DestructElements(index, 1);
+			RpgAlgorithm::Array_RemoveElements(Data, Count, index, 1, true);
+		}
+		else
+		{
+			RpgAlgorithm::Array_RemoveElements(Data, Count, index, 1, false);
+			DestructElements(Count - 1, 1);
 		}
 
 		--Count;
@@ -516,7 +530,7 @@ public:
 
 	inline void RemoveAtLast(bool bKeepOrder = true) noexcept
 	{
-		RemoveAt(Count - 1);
+		RemoveAt(Count - 1, bKeepOrder);
 	}
 
 
@@ -585,7 +599,7 @@ public:
 
 		if (Data && bFreeMemory)
 		{
-			RpgPlatformMemory::MemFree(Data);
+			TAllocator::Free(Data, sizeof(T) * Capacity);
 			Data = nullptr;
 			Capacity = 0;
 		}
@@ -644,6 +658,12 @@ private:
 
 
 
+// Transient array allocated from calling thread frame arena. Must not outlive the frame, do not store it as a member.
+template<typename T, int CAPACITY_ALIGNMENT = 1>
+using RpgArrayFrame = RpgArray<T, CAPACITY_ALIGNMENT, RpgAllocatorFrame>;
+
+
+
 template<typename T, int CAPACITY = 2>
 class RpgArrayInline
 {
@@ -880,3 +900,670 @@ private:
 	int Count;
 
 };
+
+
+
+// Array with small buffer optimization. First INLINE_CAPACITY elements are stored inline, grows onto the heap when exceeded.
+// Same interface as RpgArray. Elements are relocated with memcpy when growing (same as RpgArray realloc).
+// @param T - Element type
+// @param INLINE_CAPACITY - Number of elements stored inline
+template<typename T, int INLINE_CAPACITY = 8>
+class RpgArraySmall
+{
+	static_assert(INLINE_CAPACITY >= 1, "RpgArraySmall: INLINE_CAPACITY must be greater than 0!");
+
+public:
+	RpgArraySmall(int in_Count = 0) noexcept
+		: Data(GetInlineData())
+		, Capacity(INLINE_CAPACITY)
+		, Count(0)
+	{
+		if (in_Count > 0)
+		{
+			Resize(in_Count);
+		}
+	}
+
+
+	template<typename...TConstructorArgs>
+	RpgArraySmall(int in_Count, TConstructorArgs&&... args) noexcept
+		: Data(GetInlineData())
+		, Capacity(INLINE_CAPACITY)
+		, Count(0)
+	{
+		if (in_Count > 0)
+		{
+			ResizeConstructs(in_Count, std::forward<TConstructorArgs>(args)...);
+		}
+	}
+
+
+	RpgArraySmall(const T* srcData, int srcCount) noexcept
+		: Data(GetInlineData())
+		, Capacity(INLINE_CAPACITY)
+		, Count(0)
+	{
+		InsertAtRange(srcData, srcCount, RPG_INDEX_LAST);
+	}
+
+
+	RpgArraySmall(const std::initializer_list<T>& initializerList) noexcept
+		: Data(GetInlineData())
+		, Capacity(INLINE_CAPACITY)
+		, Count(0)
+	{
+		InsertAtRange(initializerList.begin(), static_cast<int>(initializerList.size()), RPG_INDEX_LAST);
+	}
+
+
+	RpgArraySmall(const RpgArraySmall& other) noexcept
+		: Data(GetInlineData())
+		, Capacity(INLINE_CAPACITY)
+		, Count(0)
+	{
+		InsertAtRange(other.Data, other.Count, RPG_INDEX_LAST);
+	}
+
+
+	template<int N, typename TOtherAllocator>
+	RpgArraySmall(const RpgArray<T, N, TOtherAllocator>& other) noexcept
+		: Data(GetInlineData())
+		, Capacity(INLINE_CAPACITY)
+		, Count(0)
+	{
+		InsertAtRange(other.GetData(), other.GetCount(), RPG_INDEX_LAST);
+	}
+
+
+	RpgArraySmall(RpgArraySmall&& other) noexcept
+		: Data(GetInlineData())
+		, Capacity(INLINE_CAPACITY)
+		, Count(0)
+	{
+		MoveFromOther(other);
+	}
+
+
+	~RpgArraySmall() noexcept
+	{
+		Clear(true);
+	}
+
+
+public:
+	inline RpgArraySmall& operator=(const RpgArraySmall& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			Clear();
+			InsertAtRange(rhs.Data, rhs.Count, RPG_INDEX_LAST);
+		}
+
+		return *this;
+	}
+
+
+	inline RpgArraySmall& operator=(RpgArraySmall&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			Clear(true);
+			MoveFromOther(rhs);
+		}
+
+		return *this;
+	}
+
+
+	template<int N, typename TOtherAllocator>
+	inline RpgArraySmall& operator=(const RpgArray<T, N, TOtherAllocator>& rhs) noexcept
+	{
+		Clear();
+		InsertAtRange(rhs.GetData(), rhs.GetCount(), RPG_INDEX_LAST);
+
+		return *this;
+	}
+
+
+	inline RpgArraySmall& operator=(const std::initializer_list<T>& rhs) noexcept
+	{
+		Clear();
+		InsertAtRange(rhs.begin(), static_cast<int>(rhs.size()), RPG_INDEX_LAST);
+
+		return *this;
+	}
+
+
+	inline T& operator[](int index) noexcept
+	{
+		RPG_ARRAY_ValidateIndex(index);
+		return Data[index];
+	}
+
+
+	inline const T& operator[](int index) const noexcept
+	{
+		RPG_ARRAY_ValidateIndex(index);
+		return Data[index];
+	}
+
+
+public:
+	inline T* GetData(int index = 0) noexcept
+	{
+		if (Count == 0 && index == 0)
+		{
+			return nullptr;
+		}
+
+		RPG_ARRAY_ValidateIndex(index);
+		return (Data + index);
+	}
+
+	inline const T* GetData(int index = 0) const noexcept
+	{
+		if (Count == 0 && index == 0)
+		{
+			return nullptr;
+		}
+
+		RPG_ARRAY_ValidateIndex(index);
+		return (Data + index);
+	}
+
+
+	inline T& GetAt(int index) noexcept
+	{
+		RPG_ARRAY_ValidateIndex(index);
+		return Data[index];
+	}
+
+	inline const T& GetAt(int index) const noexcept
+	{
+		RPG_ARRAY_ValidateIndex(index);
+		return Data[index];
+	}
+
+	inline T& GetAtFirst() noexcept
+	{
+		return GetAt(0);
+	}
+
+	inline const T& GetAtFirst() const noexcept
+	{
+		return GetAt(0);
+	}
+
+	inline T& GetAtLast() noexcept
+	{
+		return GetAt(Count - 1);
+	}
+
+	inline const T& GetAtLast() const noexcept
+	{
+		return GetAt(Count - 1);
+	}
+
+	inline int GetCapacity() const noexcept
+	{
+		return Capacity;
+	}
+
+	inline int GetCount() const noexcept
+	{
+		return Count;
+	}
+
+	inline bool IsEmpty() const noexcept
+	{
+		return Count == 0;
+	}
+
+	// True if elements are still stored in the inline buffer
+	inline bool IsInline() const noexcept
+	{
+		return Data == GetInlineData();
+	}
+
+	inline size_t GetMemorySizeBytes_Reserved() const noexcept
+	{
+		return sizeof(T) * Capacity;
+	}
+
+	inline size_t GetMemorySizeBytes_Allocated() const noexcept
+	{
+		return sizeof(T) * Count;
+	}
+
+	inline int FindIndexByValue(const T& value) const noexcept
+	{
+		return Count > 0 ? RpgAlgorithm::LinearSearch_FindIndexByValue(Data, Count, value) : RPG_INDEX_INVALID;
+	}
+
+	inline int FindIndexByValueFromLast(const T& value) const noexcept
+	{
+		return Count > 0 ? RpgAlgorithm::LinearSearch_FindIndexByValueFromLast(Data, Count, value) : RPG_INDEX_INVALID;
+	}
+
+	template<typename TCompare>
+	inline int FindIndexByCompare(const TCompare& compare) const noexcept
+	{
+		return Count > 0 ? RpgAlgorithm::LinearSearch_FindIndexByCompare(Data, Count, compare) : RPG_INDEX_INVALID;
+	}
+
+	template<typename TPredicate>
+	inline int FindIndexByPredicate(TPredicate predicate) const noexcept
+	{
+		return Count > 0 ? RpgAlgorithm::LinearSearch_FindIndexByPredicate(Data, Count, predicate) : RPG_INDEX_INVALID;
+	}
+
+
+	inline void Reserve(int in_Capacity) noexcept
+	{
+		if (Capacity >= in_Capacity)
+		{
+			return;
+		}
+
+		T* newData = nullptr;
+
+		if (IsInline())
+		{
+			newData = static_cast<T*>(RpgPlatformMemory::MemMalloc(sizeof(T) * in_Capacity));
+			RPG_Check(newData);
+
+			if (Count > 0)
+			{
+				RpgPlatformMemory::MemCopy(newData, Data, sizeof(T) * Count);
+			}
+		}
+		else
+		{
+			newData = static_cast<T*>(RpgPlatformMemory::MemRealloc(Data, sizeof(T) * in_Capacity));
+			RPG_Check(newData);
+		}
+
+		Data = newData;
+		Capacity = in_Capacity;
+	}
+
+
+	inline void Resize(int in_Count) noexcept
+	{
+		if (Count == in_Count)
+		{
+			return;
+		}
+
+		if (Count < in_Count)
+		{
+			Grow(in_Count);
+
+			const int startIndex = Count;
+			const int addCount = in_Count - Count;
+			Count = in_Count;
+
+			if constexpr (std::is_trivially_copyable<T>::value)
+			{
+				RpgPlatformMemory::MemZero(Data + startIndex, sizeof(T) * addCount);
+			}
+			else
+			{
+				ConstructElements(startIndex, addCount);
+			}
+		}
+		else
+		{
+			if constexpr (!std::is_trivially_copyable<T>::value)
+			{
+				DestructElements(in_Count, Count - in_Count);
+			}
+
+			Count = in_Count;
+		}
+	}
+
+
+	template<typename...TConstructorArgs>
+	inline void ResizeConstructs(int in_Count, TConstructorArgs&&... args) noexcept
+	{
+		if (Count == in_Count)
+		{
+			return;
+		}
+
+		if (Count < in_Count)
+		{
+			Grow(in_Count);
+
+			const int startIndex = Count;
+			const int addCount = in_Count - Count;
+			Count = in_Count;
+			ConstructElements(startIndex, addCount, std::forward<TConstructorArgs>(args)...);
+		}
+		else
+		{
+			if constexpr (!std::is_trivially_copyable<T>::value)
+			{
+				DestructElements(in_Count, Count - in_Count);
+			}
+
+			Count = in_Count;
+		}
+	}
+
+
+	inline T& Add() noexcept
+	{
+		Resize(Count + 1);
+		return Data[Count - 1];
+	}
+
+
+	inline void AddValue(const T& in_Value) noexcept
+	{
+		AddConstruct(in_Value);
+	}
+
+	inline void AddValue(T&& in_MoveValue) noexcept
+	{
+		AddConstruct(std::move(in_MoveValue));
+	}
+
+
+	template<typename...TConstructorArgs>
+	inline void AddConstruct(TConstructorArgs&&... args) noexcept
+	{
+		ResizeConstructs(Count + 1, std::forward<TConstructorArgs>(args)...);
+	}
+
+
+	inline bool AddUnique(const T& in_Value, int* optOut_Index = nullptr) noexcept
+	{
+		int index = FindIndexByValue(in_Value);
+		const bool bShouldAdd = (index == RPG_INDEX_INVALID);
+
+		if (bShouldAdd)
+		{
+			index = Count;
+			AddValue(in_Value);
+		}
+
+		if (optOut_Index)
+		{
+			*optOut_Index = index;
+		}
+
+		return bShouldAdd;
+	}
+
+
+	inline void InsertAtRange(const T* srcData, int srcCount, int index) noexcept
+	{
+		if (srcData == nullptr || srcCount == 0)
+		{
+			return;
+		}
+
+		if (index == RPG_INDEX_LAST)
+		{
+			index = Count;
+		}
+		else
+		{
+			RPG_ARRAY_ValidateIndex(index);
+		}
+
+		// Source must not point into this array, it may be reallocated
+		RPG_Check(srcData + srcCount <= Data || srcData >= Data + Capacity);
+
+		Grow(Count + srcCount);
+
+		// Relocate tail to make a gap, then construct new elements in place
+		if (index < Count)
+		{
+			RpgPlatformMemory::MemMove(Data + index + srcCount, Data + index, sizeof(T) * (Count - index));
+		}
+
+		for (int i = 0; i < srcCount; ++i)
+		{
+			new (Data + index + i)T(srcData[i]);
+		}
+
+		Count += srcCount;
+	}
+
+
+	inline void InsertAtRange(const RpgArraySmall& other, int index) noexcept
+	{
+		InsertAtRange(other.Data, other.Count, index);
+	}
+
+
+	template<int N, typename TOtherAllocator>
+	inline void InsertAtRange(const RpgArray<T, N, TOtherAllocator>& other, int index) noexcept
+	{
+		InsertAtRange(other.GetData(), other.GetCount(), index);
+	}
+
+
+	inline void InsertAtRange(const std::initializer_list<T>& initializerList, int index) noexcept
+	{
+		InsertAtRange(initializerList.begin(), static_cast<int>(initializerList.size()), index);
+	}
+
+
+	inline void InsertAt(const T& value, int index) noexcept
+	{
+		InsertAtRange(&value, 1, index);
+	}
+
+
+	inline void RemoveAtRange(int index, int count) noexcept
+	{
+		if (Count == 0 || count == 0)
+		{
+			return;
+		}
+
+		RPG_ARRAY_ValidateIndex(index);
+		RPG_ARRAY_ValidateIndex(index + count - 1);
+
+		if constexpr (!std::is_trivially_copyable<T>::value)
+		{
+			DestructElements(index, count);
+		}
+
+		RpgAlgorithm::Array_RemoveElements(Data, Count, index, count, true);
+		Count -= count;
+	}
+
+
+	inline void RemoveAt(int index, bool bKeepOrder = true) noexcept
+	{
+		if (Count == 0)
+		{
+			return;
+		}
+
+		RPG_ARRAY_ValidateIndex(index);
+
+		if constexpr (std::is_trivially_copyable<T>::value)
+		{
+			RpgAlgorithm::Array_RemoveElements(Data, Count, index, 1, bKeepOrder);
+		}
+		else if (bKeepOrder)
+		{
+			DestructElements(index, 1);
+			RpgAlgorithm::Array_RemoveElements(Data, Count, index, 1, true);
+		}
+		else
+		{
+			RpgAlgorithm::Array_RemoveElements(Data, Count, index, 1, false);
+			DestructElements(Count - 1, 1);
+		}
+
+		--Count;
+	}
+
+	inline void RemoveAtLast(bool bKeepOrder = true) noexcept
+	{
+		RemoveAt(Count - 1, bKeepOrder);
+	}
+
+
+	inline bool RemoveByValue(const T& value, bool bKeepOrder = true) noexcept
+	{
+		const int index = FindIndexByValue(value);
+		if (index == RPG_INDEX_INVALID)
+		{
+			return false;
+		}
+
+		RemoveAt(index, bKeepOrder);
+
+		return true;
+	}
+
+
+	template<typename TCompare>
+	inline bool RemoveByCompare(const TCompare& compare, bool bKeepOrder = true) noexcept
+	{
+		const int index = FindIndexByCompare(compare);
+		if (index == RPG_INDEX_INVALID)
+		{
+			return false;
+		}
+
+		RemoveAt(index, bKeepOrder);
+
+		return true;
+	}
+
+
+	template<typename TPredicate>
+	inline bool RemoveByPredicate(TPredicate predicate, bool bKeepOrder = true) noexcept
+	{
+		const int index = FindIndexByPredicate(predicate);
+		if (index == RPG_INDEX_INVALID)
+		{
+			return false;
+		}
+
+		RemoveAt(index, bKeepOrder);
+
+		return true;
+	}
+
+
+	// @param bFreeMemory - Free heap memory and go back to inline storage
+	inline void Clear(bool bFreeMemory = false) noexcept
+	{
+		Resize(0);
+
+		if (bFreeMemory && !IsInline())
+		{
+			RpgPlatformMemory::MemFree(Data);
+			Data = GetInlineData();
+			Capacity = INLINE_CAPACITY;
+		}
+	}
+
+
+	inline T* begin() noexcept
+	{
+		return Data;
+	}
+
+	inline const T* begin() const noexcept
+	{
+		return Data;
+	}
+
+	inline T* end() noexcept
+	{
+		return Data + Count;
+	}
+
+	inline const T* end() const noexcept
+	{
+		return Data + Count;
+	}
+
+
+private:
+	inline T* GetInlineData() noexcept
+	{
+		return reinterpret_cast<T*>(InlineData);
+	}
+
+	inline const T* GetInlineData() const noexcept
+	{
+		return reinterpret_cast<const T*>(InlineData);
+	}
+
+
+	// Reserve with geometric growth, elements are added one at a time most of the time
+	inline void Grow(int minCapacity) noexcept
+	{
+		if (Capacity < minCapacity)
+		{
+			Reserve(Capacity * 2 > minCapacity ? Capacity * 2 : minCapacity);
+		}
+	}
+
+
+	inline void MoveFromOther(RpgArraySmall& other) noexcept
+	{
+		RPG_Check(IsInline() && Count == 0);
+
+		if (other.IsInline())
+		{
+			for (int i = 0; i < other.Count; ++i)
+			{
+				new (Data + i)T(std::move(other.Data[i]));
+			}
+
+			Count = other.Count;
+			other.Resize(0);
+		}
+		else
+		{
+			Data = other.Data;
+			Capacity = other.Capacity;
+			Count = other.Count;
+			other.Data = other.GetInlineData();
+			other.Capacity = INLINE_CAPACITY;
+			other.Count = 0;
+		}
+	}
+
+
+	template<typename...TConstructorArgs>
+	inline void ConstructElements(int index, int count, TConstructorArgs&&... args) noexcept
+	{
+		for (int i = index; i < (index + count); ++i)
+		{
+			RPG_ARRAY_ValidateIndex(i);
+			new (Data + i)T(std::forward<TConstructorArgs>(args)...);
+		}
+	}
+
+
+	inline void DestructElements(int index, int count) noexcept
+	{
+		for (int i = index; i < (index + count); ++i)
+		{
+			RPG_ARRAY_ValidateIndex(i);
+			(Data + i)->~T();
+		}
+	}
+
+
+private:
+	T* Data;
+	int Capacity;
+	int Count;
+	alignas(T) uint8_t InlineData[sizeof(T) * INLINE_CAPACITY];
+
+};
@@ -1,8 +1,23 @@
 #pragma once
 
 #include "RpgAlgorithm.h"
+#include <bit>
 
 
+// Number of elements in the first page. Each next page doubles the capacity (16, 32, 64, ...)
+#define RPG_FREELIST_FIRST_PAGE_CAPACITY_SHIFT		4
+#define RPG_FREELIST_FIRST_PAGE_CAPACITY			(1 << RPG_FREELIST_FIRST_PAGE_CAPACITY_SHIFT)
+
+// Enough pages to address RPG_MAX_COUNT elements
+#define RPG_FREELIST_MAX_PAGE						(31 - RPG_FREELIST_FIRST_PAGE_CAPACITY_SHIFT)
+
+
+
+// ============================================================================================================================================================================================== //
+// RpgFreeList
+// Sparse array with free slot reuse. Elements are stored in pages that grow geometrically and are never reallocated,
+// element address is stable until it's removed (or the list is cleared with bFreeMemory).
+// ============================================================================================================================================================================================== //
 template<typename T>
 class RpgFreeList
 {
@@ -13,8 +28,9 @@ public:
 		: Capacity(0)
 		, Count(0)
 		, NextFreeIndex(RPG_INDEX_INVALID)
-		, ValidIndexArray(nullptr)
-		, DataArray(nullptr)
+		, PageCount(0)
+		, ValidBits(nullptr)
+		, DataPages()
 	{
 	}
 
@@ -27,18 +43,9 @@ public:
 
 
 	RpgFreeList(RpgFreeList&& other) noexcept
-		: Capacity(other.Capacity)
-		, Count(other.Count)
-		, NextFreeIndex(other.NextFreeIndex)
-		, ValidIndexArray(other.ValidIndexArray)
-		, DataArray(other.DataArray)
+		: RpgFreeList()
 	{
-		other.Capacity = 0;
-		other.Count = 0;
-		other.NextFreeIndex = RPG_INDEX_INVALID;
-		other.FreeIndexArray = nullptr;
-		other.ValidIndexArray = nullptr;
-		other.DataArray = nullptr;
+		MoveFromOther(other);
 	}
 
 
@@ -73,18 +80,7 @@ public:
 		if (this != &rhs)
 		{
 			Clear(true);
-
-			Capacity = rhs.Capacity;
-			Count = rhs.Count;
-			NextFreeIndex = rhs.NextFreeIndex;
-			ValidIndexArray = rhs.ValidIndexArray;
-			DataArray = rhs.DataArray;
-
-			rhs.Capacity = 0;
-			rhs.Count = 0;
-			rhs.NextFreeIndex = RPG_INDEX_INVALID;
-			rhs.ValidIndexArray = nullptr;
-			rhs.DataArray = nullptr;
+			MoveFromOther(rhs);
 		}
 
 		return *this;
@@ -103,46 +99,135 @@ public:
 	inline T& operator[](int index) noexcept
 	{
 		RPG_ValidateV(IsValid(index), "RpgFreeList: Element at index %i is not valid!", index);
-		return DataArray[index];
+		return *GetElementPointer(index);
 	}
 
 
 	inline const T& operator[](int index) const noexcept
 	{
 		RPG_ValidateV(IsValid(index), "RpgFreeList: Element at index %i is not valid!", index);
-		return DataArray[index];
+		return *GetElementPointer(index);
 	}
 
 
 private:
-	inline void InternalCopyFromOther(int otherCapacity, int otherCount, int otherNextFreeIndex, const bool* otherValidIndexArray, const T* otherDataArray) noexcept
+	// Page index of element index. Page <p> holds elements [FIRST * (2^p - 1), FIRST * (2^(p+1) - 1))
+	static inline int GetPageIndex(int index) noexcept
 	{
-		Reserve(otherCapacity);
-		Count = otherCount;
-		NextFreeIndex = otherNextFreeIndex;
+		const uint32_t firstPageUnits = (static_cast<uint32_t>(index) >> RPG_FREELIST_FIRST_PAGE_CAPACITY_SHIFT) + 1;
+		return 31 - std::countl_zero(firstPageUnits);
+	}
 
-		// Copy valid index array
-		RpgPlatformMemory::MemCopy(ValidIndexArray, otherValidIndexArray, sizeof(bool) * Capacity);
 
-		// Copy to get the value of first 4 bytes (the NextFreeIndex) from each empty element
-		RpgPlatformMemory::MemCopy(DataArray, otherDataArray, sizeof(T) * Capacity);
+	static inline int GetPageStartIndex(int pageIndex) noexcept
+	{
+		return ((1 << pageIndex) - 1) << RPG_FREELIST_FIRST_PAGE_CAPACITY_SHIFT;
+	}
+
 
-		// (Non-POD) actual deep copy for valid element only
-		if constexpr (!std::is_trivially_copyable<T>::value)
+	static inline int GetPageCapacity(int pageIndex) noexcept
+	{
+		return RPG_FREELIST_FIRST_PAGE_CAPACITY << pageIndex;
+	}
+
+
+	// Number of 64-bit words of valid bitset for <capacity>
+	static inline int GetValidWordCount(int capacity) noexcept
+	{
+		return (capacity + 63) >> 6;
+	}
+
+
+	inline void SetValidBit(int index) noexcept
+	{
+		ValidBits[index >> 6] |= (1ull << (index & 63));
+	}
+
+
+	inline void ClearValidBit(int index) noexcept
+	{
+		ValidBits[index >> 6] &= ~(1ull << (index & 63));
+	}
+
+
+	// Count valid elements from bitset
+	inline int CalculateValidCount() const noexcept
+	{
+		int count = 0;
+		const int wordCount = GetValidWordCount(Capacity);
+
+		for (int w = 0; w < wordCount; ++w)
 		{
-			for (int i = 0; i < Capacity; ++i)
+			count += std::popcount(ValidBits[w]);
+		}
+
+		return count;
+	}
+
+
+	inline T* GetElementPointer(int index) const noexcept
+	{
+		const int pageIndex = GetPageIndex(index);
+		return DataPages[pageIndex] + (index - GetPageStartIndex(pageIndex));
+	}
+
+
+	inline void CopyFromOther(const RpgFreeList& other) noexcept
+	{
+		Reserve(other.Capacity);
+		Count = other.Count;
+		NextFreeIndex = other.NextFreeIndex;
+
+		// Copy valid bitset
+		if (other.Capacity > 0)
+		{
+			RpgPlatformMemory::MemCopy(ValidBits, other.ValidBits, sizeof(uint64_t) * GetValidWordCount(other.Capacity));
+		}
+
+		RPG_Assert(CalculateValidCount() == Count);
+
+		for (int p = 0; p < other.PageCount; ++p)
+		{
+			const int pageStartIndex = GetPageStartIndex(p);
+			const int pageCapacity = GetPageCapacity(p);
+
+			// Copy to get the value of first 4 bytes (the NextFreeIndex) from each empty element
+			RpgPlatformMemory::MemCopy(DataPages[p], other.DataPages[p], sizeof(T) * pageCapacity);
+
+			// (Non-POD) actual deep copy for valid element only
+			if constexpr (!std::is_trivially_copyable<T>::value)
 			{
-				if (ValidIndexArray[i])
+				for (int i = 0; i < pageCapacity; ++i)
 				{
-					DataArray[i] = otherDataArray[i];
+					if (IsValid(pageStartIndex + i))
+					{
+						new (DataPages[p] + i)T(other.DataPages[p][i]);
+					}
 				}
 			}
 		}
 	}
 
-	inline void CopyFromOther(const RpgFreeList& other) noexcept
+
+	inline void MoveFromOther(RpgFreeList& other) noexcept
 	{
-		InternalCopyFromOther(other.Capacity, other.Count, other.NextFreeIndex, other.ValidIndexArray, other.DataArray);
+		Capacity = other.Capacity;
+		Count = other.Count;
+		NextFreeIndex = other.NextFreeIndex;
+		PageCount = other.PageCount;
+		ValidBits = other.ValidBits;
+
+		for (int p = 0; p < PageCount; ++p)
+		{
+			DataPages[p] = other.DataPages[p];
+			other.DataPages[p] = nullptr;
+		}
+
+		other.Capacity = 0;
+		other.Count = 0;
+		other.NextFreeIndex = RPG_INDEX_INVALID;
+		other.PageCount = 0;
+		other.ValidBits = nullptr;
 	}
 
 
@@ -157,29 +242,63 @@ private:
 
 		Reserve(initCount);
 		Count = initCount;
-		RpgPlatformMemory::MemSet(ValidIndexArray, 1, sizeof(bool) * Count);
+		for (int i = 0; i < Count; ++i)
+		{
+			SetValidBit(i);
+			new (GetElementPointer(i))T(*(initializerList.begin() + i));
+		}
+	}
 
-		if constexpr (std::is_trivially_copyable<T>::value)
+
+public:
+	inline bool IsValid(int index) const noexcept
+	{
+		return index >= 0 && index < Capacity && (ValidBits[index >> 6] & (1ull << (index & 63)));
+	}
+
+
+	// Find first valid index starting from <index>. Skips 64 empty slots at a time.
+	// @param index - Start index (inclusive)
+	// @returns Valid index or GetCapacity() if there is no more valid element
+	inline int FindNextValidIndex(int index) const noexcept
+	{
+		RPG_Assert(index >= 0);
+
+		if (index >= Capacity)
 		{
-			RpgPlatformMemory::MemCopy(DataArray, initializerList.begin(), sizeof(T) * Count);
+			return Capacity;
 		}
-		else
+
+		const int wordCount = GetValidWordCount(Capacity);
+		int wordIndex = index >> 6;
+		uint64_t word = ValidBits[wordIndex] & (~0ull << (index & 63));
+
+		// Bits beyond capacity are never set
+		while (word == 0)
 		{
-			for (int i = 0; i < Count; ++i)
+			if (++wordIndex == wordCount)
 			{
-				DataArray[i] = *(initializerList.begin() + i);
+				return Capacity;
 			}
+
+			word = ValidBits[wordIndex];
 		}
+
+		return (wordIndex << 6) + std::countr_zero(word);
 	}
 
 
-public:
-	inline bool IsValid(int index) const noexcept
+	// Get valid bits of 64 elements in range [wordIndex * 64, wordIndex * 64 + 64)
+	// @param wordIndex - Word index in range [0, (GetCapacity() + 63) / 64)
+	// @returns Bitmask, bit N is set if element (wordIndex * 64 + N) is valid
+	[[nodiscard]] inline uint64_t GetValidMask(int wordIndex) const noexcept
 	{
-		return Capacity > 0 ? ValidIndexArray[index] : false;
+		RPG_Assert(wordIndex >= 0 && wordIndex < GetValidWordCount(Capacity));
+		return ValidBits[wordIndex];
 	}
 
 
+	// Allocate pages until capacity >= in_Capacity. Existing elements are not moved.
 	inline void Reserve(int in_Capacity) noexcept
 	{
 		if (Capacity >= in_Capacity)
@@ -187,13 +306,28 @@ public:
 			return;
 		}
 
-		const int addedCapacity = in_Capacity - Capacity;
+		int newCapacity = Capacity;
+		int newPageCount = PageCount;
 
-		ValidIndexArray = reinterpret_cast<bool*>(RpgPlatformMemory::MemRealloc(ValidIndexArray, sizeof(bool) * in_Capacity));
-		RpgPlatformMemory::MemZero(ValidIndexArray + Capacity, sizeof(bool) * addedCapacity);
+		while (newCapacity < in_Capacity)
+		{
+			RPG_Check(newPageCount < RPG_FREELIST_MAX_PAGE);
+			DataPages[newPageCount] = reinterpret_cast<T*>(RpgPlatformMemory::MemMallocAligned(sizeof(T) * GetPageCapacity(newPageCount), alignof(T)));
+			newCapacity += GetPageCapacity(newPageCount);
+			++newPageCount;
+		}
+
+		const int wordCount = GetValidWordCount(Capacity);
+		const int newWordCount = GetValidWordCount(newCapacity);
+
+		if (newWordCount > wordCount)
+		{
+			ValidBits = reinterpret_cast<uint64_t*>(RpgPlatformMemory::MemRealloc(ValidBits, sizeof(uint64_t) * newWordCount));
+			RpgPlatformMemory::MemZero(ValidBits + wordCount, sizeof(uint64_t) * (newWordCount - wordCount));
+		}
 
-		DataArray = reinterpret_cast<T*>(RpgPlatformMemory::MemRealloc(DataArray, sizeof(T) * in_Capacity));
-		Capacity = in_Capacity;
+		Capacity = newCapacity;
+		PageCount = newPageCount;
 	}
 
 
@@ -213,13 +347,13 @@ public:
 			index = NextFreeIndex;
 
 			// Set current NextFreeIndex. The value is the first 4 bytes interpreted as int
-			const int* intPtr = reinterpret_cast<const int*>(DataArray + index);
+			const int* intPtr = reinterpret_cast<const int*>(GetElementPointer(index));
 			NextFreeIndex = *intPtr;
 		}
 
 		RPG_Check(index != RPG_INDEX_INVALID);
-		ValidIndexArray[index] = true;
-		new (DataArray + index)T(std::forward<TConstructorArgs>(args)...);
+		SetValidBit(index);
+		new (GetElementPointer(index))T(std::forward<TConstructorArgs>(args)...);
 
 		++Count;
 
@@ -227,28 +361,66 @@ public:
 	}
 
 
+	// Add <count> default constructed elements. Free slots are reused first, the rest is appended with one reserve
+	// @param count - Number of elements to add
+	// @param out_Indices - Receives index of each added element, must have <count> elements
+	// @returns None
+	inline void AddRange(int count, int* out_Indices) noexcept
+	{
+		RPG_Assert(count >= 0 && (count == 0 || out_Indices));
+
+		int addedCount = 0;
+
+		while (addedCount < count && NextFreeIndex != RPG_INDEX_INVALID)
+		{
+			const int index = NextFreeIndex;
+			NextFreeIndex = *reinterpret_cast<const int*>(GetElementPointer(index));
+
+			SetValidBit(index);
+			new (GetElementPointer(index))T();
+			out_Indices[addedCount++] = index;
+		}
+
+		// No free slot left, every index below (Count + addedCount) is in use
+		const int appendIndex = Count + addedCount;
+		Reserve(Count + count);
+
+		for (int i = 0; i < count - addedCount; ++i)
+		{
+			const int index = appendIndex + i;
+			SetValidBit(index);
+			new (GetElementPointer(index))T();
+			out_Indices[addedCount + i] = index;
+		}
+
+		Count += count;
+	}
+
+
 	inline void RemoveAt(int index)
 	{
 		RPG_ValidateV(IsValid(index), "RpgFreeList: Element at index %i is not valid!", index);
 
+		T* element = GetElementPointer(index);
+
 		// Call destructor if not POD
 		if constexpr (!std::is_trivially_copyable<T>::value)
 		{
-			(DataArray + index)->~T();
+			element->~T();
 		}
 
 	#ifdef RPG_BUILD_DEBUG
 		// Fill data with garbage values
-		RpgPlatformMemory::MemSet(DataArray + index, 0x0000DEAD, sizeof(T));
+		RpgPlatformMemory::MemSet(element, 0x0000DEAD, sizeof(T));
 	#endif // !RPG_BUILD_DEBUG
 
 		// Interpret the first 4 bytes of removed element as (int) and set its value from NextFreeIndex
-		int* intPtr = reinterpret_cast<int*>(DataArray + index);
+		int* intPtr = reinterpret_cast<int*>(element);
 		*intPtr = NextFreeIndex;
 
 		// Set the removed index as current NextFreeIndex
 		NextFreeIndex = index;
-		ValidIndexArray[index] = false;
+		ClearValidBit(index);
 
 		--Count;
 	}
@@ -259,34 +431,37 @@ public:
 		Count = 0;
 		NextFreeIndex = RPG_INDEX_INVALID;
 
-		if (DataArray)
+		if (Capacity == 0)
 		{
-			// Call destructor if not POD for valid item only
-			if constexpr (!std::is_trivially_copyable<T>::value)
+			return;
+		}
+
+		// Call destructor if not POD for valid item only
+		if constexpr (!std::is_trivially_copyable<T>::value)
+		{
+			for (int i = FindNextValidIndex(0); i < Capacity; i = FindNextValidIndex(i + 1))
 			{
-				for (int i = 0; i < Capacity; ++i)
-				{
-					if (ValidIndexArray[i])
-					{
-						(DataArray + i)->~T();
-					}
-				}
+				GetElementPointer(i)->~T();
 			}
+		}
 
-			if (bFreeMemory)
+		if (bFreeMemory)
+		{
+			for (int p = 0; p < PageCount; ++p)
 			{
-				Capacity = 0;
+				RpgPlatformMemory::MemFree(DataPages[p]);
+				DataPages[p] = nullptr;
+			}
 
-				RpgPlatformMemory::MemFree(ValidIndexArray);
-				ValidIndexArray = nullptr;
+			Capacity = 0;
+			PageCount = 0;
 
-				RpgPlatformMemory::MemFree(DataArray);
-				DataArray = nullptr;
-			}
-			else
-			{
-				RpgPlatformMemory::MemZero(ValidIndexArray, sizeof(bool) * Capacity);
-			}
+			RpgPlatformMemory::MemFree(ValidBits);
+			ValidBits = nullptr;
+		}
+		else
+		{
+			RpgPlatformMemory::MemZero(ValidBits, sizeof(uint64_t) * GetValidWordCount(Capacity));
 		}
 	}
 
@@ -294,14 +469,14 @@ public:
 	inline T& GetAt(int index) noexcept
 	{
 		RPG_AssertV(IsValid(index), "RpgFreeList: Element at index %i is not valid!", index);
-		return DataArray[index];
+		return *GetElementPointer(index);
 	}
 
 
 	inline const T& GetAt(int index) const noexcept
 	{
 		RPG_AssertV(IsValid(index), "RpgFreeList: Element at index %i is not valid!", index);
-		return DataArray[index];
+		return *GetElementPointer(index);
 	}
 
 
@@ -327,12 +502,13 @@ private:
 	int Capacity;
 	int Count;
 	int NextFreeIndex;
+	int PageCount;
 
-	// For fast checking if index is valid
-	bool* ValidIndexArray;
+	// Bitset of valid elements, 1 bit per element (64 elements per word)
+	uint64_t* ValidBits;
 
-	// Actual data array
-	T* DataArray;
+	// Element pages. Page <p> has capacity (RPG_FREELIST_FIRST_PAGE_CAPACITY << p)
+	T* DataPages[RPG_FREELIST_MAX_PAGE];
 
 
 
@@ -401,16 +577,7 @@ public:
 	private:
 		inline void UpdateValidIndex() noexcept
 		{
-			const int capacity = FreeList->GetCapacity();
-
-			do
-			{
-				if (FreeList->IsValid(++Index))
-				{
-					break;
-				}
-			}
-			while (Index < capacity);
+			Index = FreeList->FindNextValidIndex(Index + 1);
 		}
 
 
@@ -485,16 +652,7 @@ public:
 	private:
 		inline void UpdateValidIndex() noexcept
 		{
-			const int capacity = FreeList->GetCapacity();
-
-			do
-			{
-				if (FreeList->IsValid(++Index))
-				{
-					break;
-				}
-			}
-			while (Index < capacity);
+			Index = FreeList->FindNextValidIndex(Index + 1);
 		}
 
 
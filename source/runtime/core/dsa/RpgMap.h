@@ -1,25 +1,36 @@
 #pragma once
 
 #include "RpgArray.h"
+#include <bit>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define RPG_MAP_SSE2	1
+#else
+#define RPG_MAP_SSE2	0
+#endif // _M_X64 || __SSE2__
 
 
 
 // ============================================================================================================================================================================================== //
 // RpgMap
 // Hash map, key-value pair.
+// Keys and values are stored in dense arrays (iteration by index, GetValueArray()).
+// Lookup uses open-addressing index table with 1 control byte per slot (swiss table), probed 16 slots at a time.
 // ============================================================================================================================================================================================== //
-#define RPG_MAP_CHECK_COLLISION	1
+#define RPG_MAP_GROUP_SIZE		16
 
 template<typename TUniqueKey, typename TValue>
 class RpgMap
 {
+	// Control byte values. Full slot stores 7 bits of hash [0, 127]
+	static constexpr int8_t CONTROL_EMPTY = -128;
+	static constexpr int8_t CONTROL_DELETED = -2;
 
 public:
 	RpgMap() noexcept
+		: TombstoneCount(0)
 	{
-		Hashes.Reserve(8);
-		Keys.Reserve(8);
-		Values.Reserve(8);
 	}
 
 
@@ -27,6 +38,9 @@ public:
 		: Hashes(other.Hashes)
 		, Keys(other.Keys)
 		, Values(other.Values)
+		, Controls(other.Controls)
+		, Slots(other.Slots)
+		, TombstoneCount(other.TombstoneCount)
 	{
 	}
 
@@ -35,7 +49,11 @@ public:
 		: Hashes(std::move(other.Hashes))
 		, Keys(std::move(other.Keys))
 		, Values(std::move(other.Values))
+		, Controls(std::move(other.Controls))
+		, Slots(std::move(other.Slots))
+		, TombstoneCount(other.TombstoneCount)
 	{
+		other.TombstoneCount = 0;
 	}
 
 
@@ -50,6 +68,9 @@ public:
 			Hashes = rhs.Hashes;
 			Keys = rhs.Keys;
 			Values = rhs.Values;
+			Controls = rhs.Controls;
+			Slots = rhs.Slots;
+			TombstoneCount = rhs.TombstoneCount;
 		}
 
 		return *this;
@@ -63,6 +84,10 @@ public:
 			Hashes = std::move(rhs.Hashes);
 			Keys = std::move(rhs.Keys);
 			Values = std::move(rhs.Values);
+			Controls = std::move(rhs.Controls);
+			Slots = std::move(rhs.Slots);
+			TombstoneCount = rhs.TombstoneCount;
+			rhs.TombstoneCount = 0;
 		}
 
 		return *this;
@@ -79,7 +104,7 @@ public:
 
 	inline const TValue& operator[](const TUniqueKey& key) const noexcept
 	{
-		const int index = FindIndex(Rpg_GetHash(key));
+		const int index = FindIndex(key);
 		RPG_ValidateV(index != RPG_INDEX_INVALID, "RpgMap key not found!");
 
 		return Values[index];
@@ -92,28 +117,25 @@ public:
 		Hashes.Reserve(newCapacity);
 		Keys.Reserve(newCapacity);
 		Values.Reserve(newCapacity);
+
+		const int tableCapacity = CalculateTableCapacity(newCapacity);
+		if (tableCapacity > Controls.GetCount())
+		{
+			Rehash(tableCapacity);
+		}
 	}
 
 
 	inline TValue& Add(const TUniqueKey& key, int* outIndex = nullptr) noexcept
 	{
 		const uint64_t hash = Rpg_GetHash(key);
-		int index = FindIndex(hash);
+		int index = FindIndex(hash, key);
 
 		if (index == RPG_INDEX_INVALID)
 		{
-			index = Hashes.GetCount();
-			Hashes.AddValue(hash);
-			Keys.AddValue(key);
+			index = InsertKey(hash, key);
 			Values.Add();
 		}
-		else
-		{
-		#if RPG_MAP_CHECK_COLLISION
-			const int keyIndex = Keys.FindFirstIndexOf(key);
-			RPG_ValidateV(keyIndex != RPG_INDEX_INVALID, "RpgMap collision!");
-		#endif // RPG_MAP_CHECK_COLLISION
-		}
 
 		if (outIndex)
 		{
@@ -128,57 +150,50 @@ public:
 	inline void Add(const TUniqueKey& key, TConstructorArgs&&... args) noexcept
 	{
 		const uint64_t hash = Rpg_GetHash(key);
-		int index = FindIndex(hash);
+		const int index = FindIndex(hash, key);
 
 		if (index == RPG_INDEX_INVALID)
 		{
-			index = Hashes.GetCount();
-			Hashes.AddValue(hash);
-			Keys.AddValue(key);
+			InsertKey(hash, key);
 			Values.AddConstruct(std::forward<TConstructorArgs>(args)...);
 		}
 		else
 		{
-		#if RPG_MAP_CHECK_COLLISION
-			const int keyIndex = Keys.FindIndexByValue(key);
-			RPG_ValidateV(keyIndex != RPG_INDEX_INVALID, "RpgMap collision!");
-		#endif // RPG_MAP_CHECK_COLLISION
-
 			Values[index] = TValue(std::forward<TConstructorArgs>(args)...);
 		}
 	}
 
 
+	// Remove by key. If <bKeepOrder> is false, last element is moved into removed index.
+	// Keeping order has to fix up every index in the table, avoid it on large map.
 	inline void Remove(const TUniqueKey& key, bool bKeepOrder = false) noexcept
 	{
-		const int index = FindIndex(Rpg_GetHash(key));
+		const uint64_t hash = Rpg_GetHash(key);
+		const int slot = FindSlotByKey(hash, key);
 
-		if (index != RPG_INDEX_INVALID)
+		if (slot != RPG_INDEX_INVALID)
 		{
-			Hashes.RemoveAt(index, bKeepOrder);
-			Keys.RemoveAt(index, bKeepOrder);
-			Values.RemoveAt(index, bKeepOrder);
+			RemoveSlot(slot, bKeepOrder);
 		}
 	}
 
 
 	inline void RemoveAt(int index, bool bKeepOrder = false) noexcept
 	{
-		Hashes.RemoveAt(index, bKeepOrder);
-		Keys.RemoveAt(index, bKeepOrder);
-		Values.RemoveAt(index, bKeepOrder);
+		RPG_ValidateV(index >= 0 && index < Keys.GetCount(), "RpgMap: Index (%i) out of bound!", index);
+		RemoveSlot(FindSlotByIndex(index), bKeepOrder);
 	}
 
 
 	inline int FindKeyIndex(const TUniqueKey& key) const noexcept
 	{
-		return FindIndex(Rpg_GetHash(key));
+		return FindIndex(key);
 	}
 
 
 	inline bool Exists(const TUniqueKey& key, int* optOut_Index = nullptr) const noexcept
 	{
-		const int index = FindIndex(Rpg_GetHash(key));
+		const int index = FindIndex(key);
 
 		if (optOut_Index)
 		{
@@ -209,7 +224,7 @@ public:
 
 	inline TValue* GetValueByKey(const TUniqueKey& key) noexcept
 	{
-		const int index = FindIndex(Rpg_GetHash(key));
+		const int index = FindIndex(key);
 
 		if (index == RPG_INDEX_INVALID)
 		{
@@ -222,7 +237,7 @@ public:
 
 	inline const TValue* GetValueByKey(const TUniqueKey& key) const noexcept
 	{
-		const int index = FindIndex(Rpg_GetHash(key));
+		const int index = FindIndex(key);
 
 		if (index == RPG_INDEX_INVALID)
 		{
@@ -262,33 +277,274 @@ public:
 		Hashes.Clear(bFree);
 		Keys.Clear(bFree);
 		Values.Clear(bFree);
+		TombstoneCount = 0;
+
+		if (bFree)
+		{
+			Controls.Clear(true);
+			Slots.Clear(true);
+		}
+		else if (Controls.GetCount() > 0)
+		{
+			RpgPlatformMemory::MemSet(Controls.GetData(), CONTROL_EMPTY, Controls.GetCount());
+		}
 	}
 
 
 	inline int GetCount() const noexcept
 	{
-		return Hashes.GetCount();
+		return Keys.GetCount();
 	}
 
 
 	inline bool IsEmpty() const noexcept
 	{
-		return Hashes.IsEmpty();
+		return Keys.IsEmpty();
 	}
 
 
 private:
-	inline int FindIndex(uint64_t hashValue) const noexcept
+	// Scramble user hash. Rpg_GetHash for integer/pointer is identity, low bits must be well distributed for probing
+	static inline uint64_t MixHash(uint64_t hash) noexcept
+	{
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		hash *= 0xC4CEB9FE1A85EC53ull;
+		hash ^= hash >> 33;
+
+		return hash;
+	}
+
+
+	// Minimum table capacity (power of two, multiple of group size) that can hold <count> elements below max load factor (7/8)
+	static inline int CalculateTableCapacity(int count) noexcept
+	{
+		int tableCapacity = RPG_MAP_GROUP_SIZE;
+
+		while (static_cast<int64_t>(count) * 8 > static_cast<int64_t>(tableCapacity) * 7)
+		{
+			tableCapacity *= 2;
+		}
+
+		return tableCapacity;
+	}
+
+
+	// @returns Bitmask of slots in group whose control byte equals <value>
+	static inline uint32_t MatchControl(const int8_t* group, int8_t value) noexcept
+	{
+	#if RPG_MAP_SSE2
+		const __m128i controls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), controls)));
+	#else
+		uint32_t mask = 0;
+		for (int i = 0; i < RPG_MAP_GROUP_SIZE; ++i)
+		{
+			mask |= static_cast<uint32_t>(group[i] == value) << i;
+		}
+		return mask;
+	#endif // RPG_MAP_SSE2
+	}
+
+
+	// @returns Bitmask of slots in group that are empty or deleted (high bit set)
+	static inline uint32_t MatchEmptyOrDeleted(const int8_t* group) noexcept
+	{
+	#if RPG_MAP_SSE2
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+	#else
+		uint32_t mask = 0;
+		for (int i = 0; i < RPG_MAP_GROUP_SIZE; ++i)
+		{
+			mask |= static_cast<uint32_t>(group[i] < 0) << i;
+		}
+		return mask;
+	#endif // RPG_MAP_SSE2
+	}
+
+
+	// Probe groups for slot matching 7 bits of <hash> and <predicate>(dataIndex). Groups are visited in triangular sequence which covers all groups of power of two table.
+	// @returns Slot index or RPG_INDEX_INVALID
+	template<typename TPredicate>
+	inline int FindSlot(uint64_t hash, TPredicate predicate) const noexcept
+	{
+		if (Controls.IsEmpty())
+		{
+			return RPG_INDEX_INVALID;
+		}
+
+		const uint64_t mixedHash = MixHash(hash);
+		const int8_t hashControl = static_cast<int8_t>(mixedHash & 0x7F);
+		const int groupMask = (Controls.GetCount() / RPG_MAP_GROUP_SIZE) - 1;
+		int group = static_cast<int>(mixedHash >> 7) & groupMask;
+
+		for (int probe = 1; ; ++probe)
+		{
+			const int8_t* groupControls = Controls.GetData(group * RPG_MAP_GROUP_SIZE);
+			uint32_t match = MatchControl(groupControls, hashControl);
+
+			while (match)
+			{
+				const int slot = group * RPG_MAP_GROUP_SIZE + std::countr_zero(match);
+				const int index = Slots[slot];
+
+				if (predicate(index))
+				{
+					return slot;
+				}
+
+				match &= match - 1;
+			}
+
+			if (MatchControl(groupControls, CONTROL_EMPTY))
+			{
+				return RPG_INDEX_INVALID;
+			}
+
+			RPG_Check(probe <= groupMask);
+			group = (group + probe) & groupMask;
+		}
+	}
+
+
+	inline int FindSlotByKey(uint64_t hash, const TUniqueKey& key) const noexcept
+	{
+		return FindSlot(hash, [this, &key](int index) { return Keys[index] == key; });
+	}
+
+
+	inline int FindSlotByIndex(int index) const noexcept
+	{
+		const int slot = FindSlot(Hashes[index], [index](int slotIndex) { return slotIndex == index; });
+		RPG_Check(slot != RPG_INDEX_INVALID);
+
+		return slot;
+	}
+
+
+	inline int FindIndex(uint64_t hash, const TUniqueKey& key) const noexcept
+	{
+		const int slot = FindSlotByKey(hash, key);
+
+		return slot == RPG_INDEX_INVALID ? RPG_INDEX_INVALID : Slots[slot];
+	}
+
+
+	inline int FindIndex(const TUniqueKey& key) const noexcept
+	{
+		return FindIndex(Rpg_GetHash(key), key);
+	}
+
+
+	// Find first empty or deleted slot along the probe sequence of <hash>. Table must have free slot.
+	inline int FindInsertSlot(uint64_t hash) const noexcept
+	{
+		const uint64_t mixedHash = MixHash(hash);
+		const int groupMask = (Controls.GetCount() / RPG_MAP_GROUP_SIZE) - 1;
+		int group = static_cast<int>(mixedHash >> 7) & groupMask;
+
+		for (int probe = 1; ; ++probe)
+		{
+			const uint32_t match = MatchEmptyOrDeleted(Controls.GetData(group * RPG_MAP_GROUP_SIZE));
+
+			if (match)
+			{
+				return group * RPG_MAP_GROUP_SIZE + std::countr_zero(match);
+			}
+
+			RPG_Check(probe <= groupMask);
+			group = (group + probe) & groupMask;
+		}
+	}
+
+
+	inline void SetSlot(int slot, uint64_t hash, int index) noexcept
+	{
+		Controls[slot] = static_cast<int8_t>(MixHash(hash) & 0x7F);
+		Slots[slot] = index;
+	}
+
+
+	// Rebuild index table with <tableCapacity> slots from dense hash array. Also clears all tombstones.
+	inline void Rehash(int tableCapacity) noexcept
 	{
+		RPG_Check(RpgAlgorithm::IsPowerOfTwo(tableCapacity) && tableCapacity >= RPG_MAP_GROUP_SIZE);
+
+		Controls.Resize(tableCapacity);
+		Slots.Resize(tableCapacity);
+		RpgPlatformMemory::MemSet(Controls.GetData(), CONTROL_EMPTY, tableCapacity);
+		TombstoneCount = 0;
+
 		for (int i = 0; i < Hashes.GetCount(); ++i)
 		{
-			if (Hashes[i] == hashValue)
+			SetSlot(FindInsertSlot(Hashes[i]), Hashes[i], i);
+		}
+	}
+
+
+	// Add new key into dense arrays and index table (value is added by caller)
+	// @returns Dense index of the new key
+	inline int InsertKey(uint64_t hash, const TUniqueKey& key) noexcept
+	{
+		const int count = Keys.GetCount();
+
+		// Grow (or purge tombstones) when exceeding max load factor (7/8). Table is at most 7/16 full after rehash.
+		if (static_cast<int64_t>(count + TombstoneCount + 1) * 8 > static_cast<int64_t>(Controls.GetCount()) * 7)
+		{
+			const int tableCapacity = CalculateTableCapacity((count + 1) * 2);
+			Rehash(tableCapacity > Controls.GetCount() ? tableCapacity : Controls.GetCount());
+		}
+
+		const int slot = FindInsertSlot(hash);
+		if (Controls[slot] == CONTROL_DELETED)
+		{
+			--TombstoneCount;
+		}
+
+		SetSlot(slot, hash, count);
+		Hashes.AddValue(hash);
+		Keys.AddValue(key);
+
+		return count;
+	}
+
+
+	inline void RemoveSlot(int slot, bool bKeepOrder) noexcept
+	{
+		const int index = Slots[slot];
+		const int lastIndex = Keys.GetCount() - 1;
+
+		// Probe stops at group that has an empty slot, so the slot can be set to empty if its group still has one
+		const int groupStart = slot & ~(RPG_MAP_GROUP_SIZE - 1);
+		if (MatchControl(Controls.GetData(groupStart), CONTROL_EMPTY))
+		{
+			Controls[slot] = CONTROL_EMPTY;
+		}
+		else
+		{
+			Controls[slot] = CONTROL_DELETED;
+			++TombstoneCount;
+		}
+
+		if (bKeepOrder)
+		{
+			for (int i = 0; i < Controls.GetCount(); ++i)
 			{
-				return i;
+				if (Controls[i] >= 0 && Slots[i] > index)
+				{
+					--Slots[i];
+				}
 			}
 		}
+		else if (index != lastIndex)
+		{
+			Slots[FindSlotByIndex(lastIndex)] = index;
+		}
 
-		return RPG_INDEX_INVALID;
+		Hashes.RemoveAt(index, bKeepOrder);
+		Keys.RemoveAt(index, bKeepOrder);
+		Values.RemoveAt(index, bKeepOrder);
 	}
 
 
@@ -297,4 +553,11 @@ private:
 	RpgArray<TUniqueKey> Keys;
 	RpgArray<TValue> Values;
 
+	// Index table. Control byte and dense index per slot
+	RpgArray<int8_t> Controls;
+	RpgArray<int> Slots;
+
+	// Number of deleted slots in index table
+	int TombstoneCount;
+
 };
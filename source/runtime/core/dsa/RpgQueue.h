@@ -0,0 +1,340 @@
+#pragma once
+
+#include "RpgAlgorithm.h"
+#include <atomic>
+#include <new>
+
+
+
+// ============================================================================================================================================================================================== //
+// RpgQueueSPSC
+// Bounded lock-free queue for single producer thread and single consumer thread.
+// Capacity is rounded up to power of two. Head and tail are on separate cache lines, each side caches the other index
+// and only reloads it when the queue looks full/empty.
+// ============================================================================================================================================================================================== //
+template<typename T>
+class RpgQueueSPSC
+{
+	RPG_NOCOPYMOVE(RpgQueueSPSC)
+
+public:
+	explicit RpgQueueSPSC(int in_Capacity) noexcept
+	{
+		RPG_Check(in_Capacity > 0 && in_Capacity <= (1 << 30));
+
+		Capacity = 1;
+		while (Capacity < in_Capacity)
+		{
+			Capacity *= 2;
+		}
+
+		Mask = static_cast<uint32_t>(Capacity - 1);
+		Data = static_cast<T*>(RpgPlatformMemory::MemMallocAligned(sizeof(T) * Capacity, alignof(T) > RPG_CACHE_LINE_SIZE ? alignof(T) : RPG_CACHE_LINE_SIZE));
+
+		Head.store(0, std::memory_order_relaxed);
+		Tail.store(0, std::memory_order_relaxed);
+		ProducerCachedHead = 0;
+		ConsumerCachedTail = 0;
+	}
+
+
+	~RpgQueueSPSC() noexcept
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			const uint32_t tail = Tail.load(std::memory_order_acquire);
+
+			for (uint32_t i = Head.load(std::memory_order_relaxed); i != tail; ++i)
+			{
+				Data[i & Mask].~T();
+			}
+		}
+
+		RpgPlatformMemory::MemFree(Data);
+	}
+
+
+public:
+	// [Producer] Push value into queue
+	// @returns False if queue is full
+	template<typename... TConstructorArgs>
+	inline bool Push(TConstructorArgs&&... args) noexcept
+	{
+		const uint32_t tail = Tail.load(std::memory_order_relaxed);
+
+		if (tail - ProducerCachedHead == static_cast<uint32_t>(Capacity))
+		{
+			ProducerCachedHead = Head.load(std::memory_order_acquire);
+
+			if (tail - ProducerCachedHead == static_cast<uint32_t>(Capacity))
+			{
+				return false;
+			}
+		}
+
+		new (Data + (tail & Mask))T(std::forward<TConstructorArgs>(args)...);
+		Tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+
+	// [Consumer] Pop value from queue
+	// @param out_Value - Popped value
+	// @returns False if queue is empty
+	inline bool Pop(T& out_Value) noexcept
+	{
+		const uint32_t head = Head.load(std::memory_order_relaxed);
+
+		if (head == ConsumerCachedTail)
+		{
+			ConsumerCachedTail = Tail.load(std::memory_order_acquire);
+
+			if (head == ConsumerCachedTail)
+			{
+				return false;
+			}
+		}
+
+		T* element = Data + (head & Mask);
+		out_Value = std::move(*element);
+
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			element->~T();
+		}
+
+		Head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+
+	// Approximate number of elements. Exact only when called from producer or consumer while the other side is idle.
+	inline int GetCount() const noexcept
+	{
+		const uint32_t head = Head.load(std::memory_order_acquire);
+		const uint32_t tail = Tail.load(std::memory_order_acquire);
+
+		return static_cast<int>(tail - head);
+	}
+
+
+	inline bool IsEmpty() const noexcept
+	{
+		return GetCount() == 0;
+	}
+
+
+	inline int GetCapacity() const noexcept
+	{
+		return Capacity;
+	}
+
+
+private:
+	T* Data;
+	int Capacity;
+	uint32_t Mask;
+
+	// Written by consumer
+	alignas(RPG_CACHE_LINE_SIZE) std::atomic<uint32_t> Head;
+	uint32_t ConsumerCachedTail;
+
+	// Written by producer
+	alignas(RPG_CACHE_LINE_SIZE) std::atomic<uint32_t> Tail;
+	uint32_t ProducerCachedHead;
+
+	// Keep next object off the producer cache line
+	alignas(RPG_CACHE_LINE_SIZE) uint8_t Padding[1];
+
+};
+
+
+
+
+// ============================================================================================================================================================================================== //
+// RpgQueueMPMC
+// Bounded lock-free queue for multiple producer and multiple consumer threads (Dmitry Vyukov's bounded MPMC queue).
+// Each cell has a sequence number that tells whether it's ready to be written or read, producers and consumers only contend on
+// their own position counter. Capacity is rounded up to power of two.
+// ============================================================================================================================================================================================== //
+template<typename T>
+class RpgQueueMPMC
+{
+	RPG_NOCOPYMOVE(RpgQueueMPMC)
+
+	struct FCell
+	{
+		std::atomic<uint32_t> Sequence;
+		alignas(T) uint8_t Storage[sizeof(T)];
+
+		inline T* GetData() noexcept
+		{
+			return reinterpret_cast<T*>(Storage);
+		}
+	};
+
+
+public:
+	explicit RpgQueueMPMC(int in_Capacity) noexcept
+	{
+		RPG_Check(in_Capacity > 0 && in_Capacity <= (1 << 30));
+
+		Capacity = 1;
+		while (Capacity < in_Capacity)
+		{
+			Capacity *= 2;
+		}
+
+		Mask = static_cast<uint32_t>(Capacity - 1);
+		Cells = static_cast<FCell*>(RpgPlatformMemory::MemMallocAligned(sizeof(FCell) * Capacity, alignof(FCell) > RPG_CACHE_LINE_SIZE ? alignof(FCell) : RPG_CACHE_LINE_SIZE));
+
+		for (int i = 0; i < Capacity; ++i)
+		{
+			new (&Cells[i].Sequence) std::atomic<uint32_t>(static_cast<uint32_t>(i));
+		}
+
+		EnqueuePosition.store(0, std::memory_order_relaxed);
+		DequeuePosition.store(0, std::memory_order_relaxed);
+	}
+
+
+	~RpgQueueMPMC() noexcept
+	{
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			const uint32_t enqueuePosition = EnqueuePosition.load(std::memory_order_acquire);
+
+			for (uint32_t i = DequeuePosition.load(std::memory_order_relaxed); i != enqueuePosition; ++i)
+			{
+				Cells[i & Mask].GetData()->~T();
+			}
+		}
+
+		RpgPlatformMemory::MemFree(Cells);
+	}
+
+
+public:
+	// Push value into queue. Thread-safe
+	// @returns False if queue is full
+	template<typename... TConstructorArgs>
+	inline bool Push(TConstructorArgs&&... args) noexcept
+	{
+		uint32_t position = EnqueuePosition.load(std::memory_order_relaxed);
+		FCell* cell = nullptr;
+
+		while (true)
+		{
+			cell = &Cells[position & Mask];
+			const uint32_t sequence = cell->Sequence.load(std::memory_order_acquire);
+			const int32_t diff = static_cast<int32_t>(sequence - position);
+
+			if (diff == 0)
+			{
+				if (EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				// Cell still holds value from previous lap
+				return false;
+			}
+			else
+			{
+				position = EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		new (cell->GetData())T(std::forward<TConstructorArgs>(args)...);
+		cell->Sequence.store(position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+
+	// Pop value from queue. Thread-safe
+	// @param out_Value - Popped value
+	// @returns False if queue is empty
+	inline bool Pop(T& out_Value) noexcept
+	{
+		uint32_t position = DequeuePosition.load(std::memory_order_relaxed);
+		FCell* cell = nullptr;
+
+		while (true)
+		{
+			cell = &Cells[position & Mask];
+			const uint32_t sequence = cell->Sequence.load(std::memory_order_acquire);
+			const int32_t diff = static_cast<int32_t>(sequence - (position + 1));
+
+			if (diff == 0)
+			{
+				if (DequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				// Cell not written yet
+				return false;
+			}
+			else
+			{
+				position = DequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		T* element = cell->GetData();
+		out_Value = std::move(*element);
+
+		if constexpr (!std::is_trivially_destructible<T>::value)
+		{
+			element->~T();
+		}
+
+		// Ready to be written on next lap
+		cell->Sequence.store(position + Mask + 1, std::memory_order_release);
+
+		return true;
+	}
+
+
+	// Approximate number of elements
+	inline int GetCount() const noexcept
+	{
+		const uint32_t dequeuePosition = DequeuePosition.load(std::memory_order_acquire);
+		const uint32_t enqueuePosition = EnqueuePosition.load(std::memory_order_acquire);
+		const int32_t count = static_cast<int32_t>(enqueuePosition - dequeuePosition);
+
+		return count < 0 ? 0 : count;
+	}
+
+
+	inline bool IsEmpty() const noexcept
+	{
+		return GetCount() == 0;
+	}
+
+
+	inline int GetCapacity() const noexcept
+	{
+		return Capacity;
+	}
+
+
+private:
+	FCell* Cells;
+	int Capacity;
+	uint32_t Mask;
+
+	alignas(RPG_CACHE_LINE_SIZE) std::atomic<uint32_t> EnqueuePosition;
+	alignas(RPG_CACHE_LINE_SIZE) std::atomic<uint32_t> DequeuePosition;
+
+	// Keep next object off the dequeue cache line
+	alignas(RPG_CACHE_LINE_SIZE) uint8_t Padding[1];
+
+};
@@ -2,18 +2,47 @@
 
 #include "../dsa/RpgFreeList.h"
 #include "RpgGameObject.h"
+#include "RpgWorldSnapshot.h"
 
 
 class RpgWorld;
+class RpgWorldSubsystem;
 
 
-#define RPG_COMPONENT_ID_INVALID		UINT16_MAX
+#define RPG_COMPONENT_ID_INVALID		RPG_INDEX_INVALID
 #define RPG_COMPONENT_TYPE_MAX_COUNT	16
 
 
 
+// Opt-in binary snapshot of component type, see RpgWorld::Snapshot_Save(). Component types without specialization are not saved.
+// To enable it for a component type, specialize:
+//
+//	template<>
+//	struct RpgComponentSnapshot<TComponent>
+//	{
+//		static constexpr bool bEnabled = true;
+//
+//		// Trivially copyable, written as contiguous array. Bump RPG_WORLD_SNAPSHOT_VERSION when the layout changes
+//		struct FRecord { ... };
+//
+//		// Shared assets are stored as index of RpgWorldSnapshotAssetTable::AddReference()
+//		static void Save(FRecord& out_Record, const TComponent& component, RpgWorldSnapshotAssetTable& assets) noexcept;
+//
+//		// <component> is default constructed and its GameObject is already set
+//		static void Load(TComponent& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept;
+//	};
+template<typename TComponent>
+struct RpgComponentSnapshot
+{
+	static constexpr bool bEnabled = false;
+};
+
+
+
 #define RPG_COMPONENT_TYPE(name)																	\
 friend RpgWorld;																					\
+friend RpgWorldSubsystem;																			\
+template<typename> friend struct RpgComponentSnapshot;												\
 private:																							\
 inline static uint16_t TYPE_ID = UINT16_MAX;														\
 public:																								\
@@ -23,6 +52,117 @@ RpgGameObjectID GameObject;
 
 
 
+// Number of components per SoA chunk. Same as RpgFreeList valid bit word, chunk N covers component indices [N * 64, N * 64 + 64)
+#define RPG_COMPONENT_CHUNK_SIZE		64
+
+
+
+// Opt-in SoA layout for hot fields of component type. The component is still stored as a whole struct in RpgFreeList,
+// selected fields are mirrored into fixed-size chunks so kernels (culling, etc) can stream them without touching the rest of the struct.
+// To enable it for a component type, specialize:
+//
+//	template<>
+//	struct RpgComponentSoA<TComponent>
+//	{
+//		static constexpr bool bEnabled = true;
+//
+//		// Arrays of RPG_COMPONENT_CHUNK_SIZE elements for each mirrored field
+//		struct FChunk { ... };
+//
+//		// Copy mirrored fields of <component> into <lane> of <chunk>
+//		static void Write(FChunk& chunk, int lane, const TComponent& component) noexcept;
+//	};
+//
+// Mirrored fields must be written back with RpgComponentStorage::SoA_Update() after they are modified.
+template<typename TComponent>
+struct RpgComponentSoA
+{
+	static constexpr bool bEnabled = false;
+};
+
+
+
+// Chunks of component type without SoA layout. Nothing to store
+template<typename TComponent, bool bEnabled = RpgComponentSoA<TComponent>::bEnabled>
+class RpgComponentChunkArray
+{
+public:
+	inline void Update(int index, const TComponent& component) noexcept {}
+	inline void Clear() noexcept {}
+};
+
+
+// Chunks of component type with SoA layout. Chunks are allocated on demand and never moved
+template<typename TComponent>
+class RpgComponentChunkArray<TComponent, true>
+{
+	RPG_NOCOPY(RpgComponentChunkArray)
+
+public:
+	typedef typename RpgComponentSoA<TComponent>::FChunk FChunk;
+
+
+public:
+	RpgComponentChunkArray() noexcept = default;
+
+	~RpgComponentChunkArray() noexcept
+	{
+		Clear();
+	}
+
+
+	inline void Update(int index, const TComponent& component) noexcept
+	{
+		const int chunkIndex = index / RPG_COMPONENT_CHUNK_SIZE;
+
+		if (chunkIndex >= Chunks.GetCount())
+		{
+			const int oldCount = Chunks.GetCount();
+			Chunks.Resize(chunkIndex + 1);
+
+			for (int c = oldCount; c < Chunks.GetCount(); ++c)
+			{
+				FChunk* chunk = static_cast<FChunk*>(RpgPlatformMemory::MemMallocAligned(sizeof(FChunk), alignof(FChunk) > RPG_CACHE_LINE_SIZE ? alignof(FChunk) : RPG_CACHE_LINE_SIZE));
+				RpgPlatformMemory::MemZero(chunk, sizeof(FChunk));
+				Chunks[c] = chunk;
+			}
+		}
+
+		RpgComponentSoA<TComponent>::Write(*Chunks[chunkIndex], index % RPG_COMPONENT_CHUNK_SIZE, component);
+	}
+
+
+	inline void Clear() noexcept
+	{
+		for (int c = 0; c < Chunks.GetCount(); ++c)
+		{
+			RpgPlatformMemory::MemFree(Chunks[c]);
+		}
+
+		Chunks.Clear(true);
+	}
+
+
+	[[nodiscard]] inline int GetCount() const noexcept
+	{
+		return Chunks.GetCount();
+	}
+
+
+	[[nodiscard]] inline const FChunk& Get(int chunkIndex) const noexcept
+	{
+		return *Chunks[chunkIndex];
+	}
+
+
+private:
+	RpgArray<FChunk*> Chunks;
+
+};
+
+
+
+
 class RpgComponentStorageInterface
 {
 	RPG_NOCOPY(RpgComponentStorageInterface)
@@ -33,6 +173,34 @@ public:
 
 	virtual void Remove(int index) noexcept = 0;
 
+	[[nodiscard]] virtual const char* GetTypeName() const noexcept = 0;
+
+
+	// TRUE if component type has RpgComponentSnapshot specialization
+	[[nodiscard]] virtual bool Snapshot_IsEnabled() const noexcept = 0;
+
+	// Size of RpgComponentSnapshot<TComponent>::FRecord, 0 if snapshot is not enabled
+	[[nodiscard]] virtual uint32_t Snapshot_GetRecordSize() const noexcept = 0;
+
+
+	// Append record of each component whose game object is part of the snapshot
+	// @param out_GameObjectIndices - Snapshot game object index of each record
+	// @param out_Records - Records, Snapshot_GetRecordSize() bytes each
+	// @param gameObjectRemap - Snapshot game object index of each world game object index, RPG_INDEX_INVALID if not part of the snapshot
+	// @param assets - Asset table to add shared asset references into
+	// @returns None
+	virtual void Snapshot_Save(RpgArray<int>& out_GameObjectIndices, RpgArray<uint8_t>& out_Records, const int* gameObjectRemap, RpgWorldSnapshotAssetTable& assets) const noexcept = 0;
+
+
+	// Add component for each record
+	// @param gameObjects - Owner game object of each record
+	// @param records - <count> records, Snapshot_GetRecordSize() bytes each
+	// @param count - Number of records
+	// @param out_ComponentIndices - Index of added component of each record
+	// @param assets - Asset table to resolve shared asset references
+	// @returns None
+	virtual void Snapshot_Load(const RpgGameObjectID* gameObjects, const void* records, int count, int* out_ComponentIndices, RpgWorldSnapshotAssetTable& assets) noexcept = 0;
+
 };
 
 
@@ -56,7 +224,10 @@ public:
 
 	[[nodiscard]] inline int Add() noexcept 
 	{
-		return Components.Add();
+		const int id = Components.Add();
+		Chunks.Update(id, Components.GetAt(id));
+
+		return id;
 	}
 
 	virtual void Remove(int id) noexcept override
@@ -64,6 +235,11 @@ public:
 		Components.RemoveAt(id);
 	}
 
+	[[nodiscard]] virtual const char* GetTypeName() const noexcept override
+	{
+		return TComponent::TYPE_NAME;
+	}
+
 	inline TComponent& Get(int id) noexcept
 	{
 		return Components.GetAt(id);
@@ -85,7 +261,121 @@ public:
 	}
 
 
+	// Copy mirrored fields of component into its SoA chunk. Call after modifying fields mirrored by RpgComponentSoA<TComponent>.
+	// Components in different lanes can be updated from different threads.
+	// @param id - Component index
+	// @returns None
+	inline void SoA_Update(int id) noexcept
+	{
+		static_assert(RpgComponentSoA<TComponent>::bEnabled, "RpgComponentStorage: SoA layout is not enabled for type of <TComponent>!");
+		Chunks.Update(id, Components.GetAt(id));
+	}
+
+
+	// Get number of SoA chunks. Chunk covers component indices [chunkIndex * RPG_COMPONENT_CHUNK_SIZE, chunkIndex * RPG_COMPONENT_CHUNK_SIZE + RPG_COMPONENT_CHUNK_SIZE)
+	[[nodiscard]] inline int SoA_GetChunkCount() const noexcept
+	{
+		static_assert(RpgComponentSoA<TComponent>::bEnabled, "RpgComponentStorage: SoA layout is not enabled for type of <TComponent>!");
+		return Chunks.GetCount();
+	}
+
+
+	// Get SoA chunk. Lanes of removed components keep stale data, mask them with SoA_GetChunkValidMask()
+	[[nodiscard]] inline const auto& SoA_GetChunk(int chunkIndex) const noexcept
+	{
+		static_assert(RpgComponentSoA<TComponent>::bEnabled, "RpgComponentStorage: SoA layout is not enabled for type of <TComponent>!");
+		return Chunks.Get(chunkIndex);
+	}
+
+
+	// Get valid lanes of SoA chunk. Bit N is set if component (chunkIndex * RPG_COMPONENT_CHUNK_SIZE + N) is valid
+	[[nodiscard]] inline uint64_t SoA_GetChunkValidMask(int chunkIndex) const noexcept
+	{
+		static_assert(RPG_COMPONENT_CHUNK_SIZE == 64, "RpgComponentStorage: SoA chunk must match RpgFreeList valid bit word!");
+		return Components.GetValidMask(chunkIndex);
+	}
+
+
+	[[nodiscard]] virtual bool Snapshot_IsEnabled() const noexcept override
+	{
+		return RpgComponentSnapshot<TComponent>::bEnabled;
+	}
+
+
+	[[nodiscard]] virtual uint32_t Snapshot_GetRecordSize() const noexcept override
+	{
+		if constexpr (RpgComponentSnapshot<TComponent>::bEnabled)
+		{
+			return sizeof(typename RpgComponentSnapshot<TComponent>::FRecord);
+		}
+		else
+		{
+			return 0;
+		}
+	}
+
+
+	virtual void Snapshot_Save(RpgArray<int>& out_GameObjectIndices, RpgArray<uint8_t>& out_Records, const int* gameObjectRemap, RpgWorldSnapshotAssetTable& assets) const noexcept override
+	{
+		if constexpr (RpgComponentSnapshot<TComponent>::bEnabled)
+		{
+			typedef typename RpgComponentSnapshot<TComponent>::FRecord FRecord;
+			static_assert(std::is_trivially_copyable<FRecord>::value, "RpgComponentStorage: Snapshot record of <TComponent> must be trivially copyable!");
+			static_assert(alignof(FRecord) <= RPG_WORLD_SNAPSHOT_ALIGNMENT, "RpgComponentStorage: Snapshot record alignment of <TComponent> exceeds snapshot block alignment!");
+
+			out_GameObjectIndices.Reserve(out_GameObjectIndices.GetCount() + Components.GetCount());
+			out_Records.Reserve(out_Records.GetCount() + Components.GetCount() * static_cast<int>(sizeof(FRecord)));
+
+			for (auto it = Components.CreateConstIterator(); it; ++it)
+			{
+				const TComponent& component = it.GetValue();
+				const int gameObjectIndex = gameObjectRemap[component.GameObject.GetIndex()];
+
+				if (gameObjectIndex == RPG_INDEX_INVALID)
+				{
+					continue;
+				}
+
+				FRecord record{};
+				RpgComponentSnapshot<TComponent>::Save(record, component, assets);
+
+				const int offset = out_Records.GetCount();
+				out_Records.Resize(offset + static_cast<int>(sizeof(FRecord)));
+				RpgPlatformMemory::MemCopy(out_Records.GetData() + offset, &record, sizeof(FRecord));
+
+				out_GameObjectIndices.AddValue(gameObjectIndex);
+			}
+		}
+	}
+
+
+	virtual void Snapshot_Load(const RpgGameObjectID* gameObjects, const void* records, int count, int* out_ComponentIndices, RpgWorldSnapshotAssetTable& assets) noexcept override
+	{
+		if constexpr (RpgComponentSnapshot<TComponent>::bEnabled)
+		{
+			typedef typename RpgComponentSnapshot<TComponent>::FRecord FRecord;
+			const FRecord* typedRecords = static_cast<const FRecord*>(records);
+
+			Components.AddRange(count, out_ComponentIndices);
+
+			for (int i = 0; i < count; ++i)
+			{
+				const int id = out_ComponentIndices[i];
+				TComponent& component = Components.GetAt(id);
+				component.GameObject = gameObjects[i];
+				RpgComponentSnapshot<TComponent>::Load(component, typedRecords[i], assets);
+				Chunks.Update(id, component);
+			}
+		}
+		else
+		{
+			RPG_CheckV(0, "RpgComponentStorage: Snapshot is not enabled for component type (%s)!", TComponent::TYPE_NAME);
+		}
+	}
+
+
 private:
 	RpgFreeList<TComponent> Components;
+	RpgComponentChunkArray<TComponent> Chunks;
 
 };
@@ -1,11 +1,16 @@
 #pragma once
 
 #include "../RpgPlatform.h"
+#include <typeinfo>
 
 
 class RpgWorld;
 
 
+// Generation of game object slot that has never been allocated. Generation of allocated slot is never 0
+#define RPG_GAMEOBJECT_GEN_INVALID		0
+
+
 
 struct RpgGameObjectID
 {
@@ -14,11 +19,11 @@ public:
 	{
 		World = nullptr;
 		Index = -1;
-		Gen = UINT16_MAX;
+		Gen = RPG_GAMEOBJECT_GEN_INVALID;
 	}
 
 private:
-	RpgGameObjectID(RpgWorld* in_World, int in_Index, uint16_t in_Gen) noexcept
+	RpgGameObjectID(RpgWorld* in_World, int in_Index, uint32_t in_Gen) noexcept
 	{
 		World = in_World;
 		Index = in_Index;
@@ -29,7 +34,7 @@ private:
 public:
 	inline bool IsValid() const noexcept
 	{
-		return World && Index != -1 && Gen != UINT16_MAX;
+		return World && Index != -1 && Gen != RPG_GAMEOBJECT_GEN_INVALID;
 	}
 
 	inline int GetIndex() const noexcept
@@ -51,7 +56,7 @@ public:
 private:
 	class RpgWorld* World;
 	int Index;
-	uint16_t Gen;
+	uint32_t Gen;
 
 
 	friend RpgWorld;
@@ -64,10 +69,37 @@ private:
 #define RPG_GAMEOBJECT_MAX_SCRIPT		4
 
 
-#define RPG_GAMEOBJECT_SCRIPT(name)										\
-public:																	\
-static constexpr const char* TYPE_NAME = name;							\
-virtual const char* GetTypeName() const noexcept { return TYPE_NAME; }	\
+// Every concrete script type must use this macro. Scripts are grouped by TYPE_NAME and ticked per group with direct (non-virtual) call to TickUpdate of the type.
+// Batch function must skip nullptr entries, they are scripts detached during the tick.
+// Subclass of a script type that overrides TickUpdate must use the macro too, RpgWorld checks it when the script is attached.
+// To tick scripts of the type in parallel on thread pool, declare in the script class:
+//
+//	static constexpr bool TICK_THREAD_SAFE = true;
+//
+// Thread-safe TickUpdate may only modify its own script and components of its own game object,
+// structural changes and transform must be recorded into RpgWorld::CommandBuffer_Get().
+#define RPG_GAMEOBJECT_SCRIPT(name)																				\
+public:																											\
+static constexpr const char* TYPE_NAME = name;																	\
+virtual const char* GetTypeName() const noexcept { return TYPE_NAME; }											\
+virtual FTickUpdateBatch GetTickUpdateBatch() const noexcept													\
+{																												\
+	typedef std::remove_cvref_t<decltype(*this)> FScriptType;													\
+	FTickUpdateBatch batch;																						\
+	batch.Function = [](RpgGameObjectScript* const* scripts, int count, float deltaTime) noexcept				\
+	{																											\
+		for (int i = 0; i < count; ++i)																			\
+		{																										\
+			if (scripts[i])																						\
+			{																									\
+				static_cast<FScriptType*>(scripts[i])->FScriptType::TickUpdate(deltaTime);						\
+			}																									\
+		}																										\
+	};																											\
+	batch.bThreadSafe = FScriptType::TICK_THREAD_SAFE;															\
+	batch.ScriptType = &typeid(FScriptType);																	\
+	return batch;																								\
+}																												\
 friend RpgWorld;
 
 
@@ -84,6 +116,25 @@ protected:
 		bStartedPlay = false;
 	}
 
+public:
+	// Tick <count> scripts of the same type
+	typedef void (*FTickUpdateBatchFunction)(RpgGameObjectScript* const* scripts, int count, float deltaTime) noexcept;
+
+	struct FTickUpdateBatch
+	{
+		FTickUpdateBatchFunction Function;
+
+		// TRUE if scripts of the type can be ticked in parallel
+		bool bThreadSafe;
+
+		// Type that Function casts scripts to. nullptr if Function calls TickUpdate virtually
+		const std::type_info* ScriptType;
+	};
+
+	// Override in script class to opt in to parallel tick. See RPG_GAMEOBJECT_SCRIPT
+	static constexpr bool TICK_THREAD_SAFE = false;
+
+
 public:
 	virtual ~RpgGameObjectScript() noexcept = default;
 
@@ -94,6 +145,25 @@ public:
 	virtual void TickUpdate(float deltaTime) noexcept {}
 	virtual const char* GetTypeName() const noexcept { return "RpgScript"; }
 
+	// Script type without RPG_GAMEOBJECT_SCRIPT falls back to virtual call
+	virtual FTickUpdateBatch GetTickUpdateBatch() const noexcept
+	{
+		FTickUpdateBatch batch;
+		batch.Function = [](RpgGameObjectScript* const* scripts, int count, float deltaTime) noexcept
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				if (scripts[i])
+				{
+					scripts[i]->TickUpdate(deltaTime);
+				}
+			}
+		};
+		batch.bThreadSafe = false;
+		batch.ScriptType = nullptr;
+		return batch;
+	}
+
 
 protected:
 	RpgGameObjectID GameObject;
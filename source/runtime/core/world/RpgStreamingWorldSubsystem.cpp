@@ -0,0 +1,575 @@
+#include "RpgStreamingWorldSubsystem.h"
+#include "../RpgProfiler.h"
+
+
+
+RpgStreamingTask_LoadCell::RpgStreamingTask_LoadCell() noexcept
+{
+	CellIndex = RPG_INDEX_INVALID;
+	bSucceeded = false;
+	SetPriority(RpgThreadTaskPriority::BACKGROUND);
+}
+
+
+void RpgStreamingTask_LoadCell::Reset() noexcept
+{
+	RpgThreadTask::Reset();
+
+	FilePath.Clear();
+	CellIndex = RPG_INDEX_INVALID;
+	Bytes.Clear();
+	bSucceeded = false;
+}
+
+
+void RpgStreamingTask_LoadCell::Execute() noexcept
+{
+	const int64_t sizeBytes = RpgPlatformFile::File_GetSize(*FilePath);
+
+	if (sizeBytes <= 0 || sizeBytes > INT32_MAX)
+	{
+		return;
+	}
+
+	Bytes.Resize(static_cast<int>(sizeBytes));
+	bSucceeded = RpgPlatformFile::File_Read(*FilePath, Bytes.GetData(), Bytes.GetCount());
+}
+
+
+
+
+RpgStreamingWorldSubsystem::RpgStreamingWorldSubsystem() noexcept
+{
+	Name = "StreamingWorldSubsystem";
+
+	LoadRadius = 3000.0f;
+	UnloadRadius = 3600.0f;
+	MaxActivateCellPerFrame = 1;
+
+	CellSize = 0.0f;
+	MinCellX = 0;
+	MinCellZ = 0;
+	CellCountX = 0;
+	CellCountZ = 0;
+	ActiveCellCount = 0;
+
+	// No component access declared. Cells are activated/destroyed on main thread, never concurrently with other subsystems
+}
+
+
+RpgStreamingWorldSubsystem::~RpgStreamingWorldSubsystem() noexcept
+{
+	WaitLoadTasks();
+}
+
+
+bool RpgStreamingWorldSubsystem::BuildCells(const RpgString& directoryPath, float cellSize) noexcept
+{
+	RPG_IsMainThread();
+	RPG_Check(cellSize > 0.0f);
+
+	RPG_PROFILER_Scope("RpgStreamingWorldSubsystem::BuildCells");
+
+	Reset();
+
+	RpgWorld* world = GetWorld();
+
+	RpgArray<RpgGameObjectID> gameObjects;
+	world->GameObject_GetAll(gameObjects);
+
+	const int gameObjectCount = gameObjects.GetCount();
+
+	if (gameObjectCount == 0)
+	{
+		return true;
+	}
+
+
+	// Index in <gameObjects> of each game object slot. Game objects are in slot order
+	RpgArray<int> slotToIndex(gameObjects[gameObjectCount - 1].GetIndex() + 1);
+
+	for (int i = 0; i < gameObjectCount; ++i)
+	{
+		slotToIndex[gameObjects[i].GetIndex()] = i;
+	}
+
+
+	// Root of each game object. Hierarchy that has any script stays in the world
+	RpgArray<int> rootIndices(gameObjectCount);
+	RpgArray<uint8_t> bKeepRoots(gameObjectCount);
+	RpgPlatformMemory::MemZero(bKeepRoots.GetData(), bKeepRoots.GetCount());
+
+	for (int i = 0; i < gameObjectCount; ++i)
+	{
+		RpgGameObjectID root = gameObjects[i];
+
+		for (RpgGameObjectID parent = world->GameObject_GetParent(root); parent.IsValid(); parent = world->GameObject_GetParent(root))
+		{
+			root = parent;
+		}
+
+		const int rootIndex = slotToIndex[root.GetIndex()];
+		rootIndices[i] = rootIndex;
+
+		if (world->GameObject_HasScript(gameObjects[i]))
+		{
+			bKeepRoots[rootIndex] = 1;
+		}
+	}
+
+
+	// Cell of each streamed root
+	RpgArray<int> rootCellX(gameObjectCount);
+	RpgArray<int> rootCellZ(gameObjectCount);
+	int minCellX = INT32_MAX;
+	int minCellZ = INT32_MAX;
+	int maxCellX = INT32_MIN;
+	int maxCellZ = INT32_MIN;
+
+	for (int i = 0; i < gameObjectCount; ++i)
+	{
+		if (rootIndices[i] != i || bKeepRoots[i])
+		{
+			continue;
+		}
+
+		const RpgVector3 position = world->GameObject_GetWorldTransformMatrix(gameObjects[i]).GetPosition();
+		const int cellX = static_cast<int>(SDL_floorf(position.X / cellSize));
+		const int cellZ = static_cast<int>(SDL_floorf(position.Z / cellSize));
+
+		rootCellX[i] = cellX;
+		rootCellZ[i] = cellZ;
+		minCellX = RpgMath::Min(minCellX, cellX);
+		minCellZ = RpgMath::Min(minCellZ, cellZ);
+		maxCellX = RpgMath::Max(maxCellX, cellX);
+		maxCellZ = RpgMath::Max(maxCellZ, cellZ);
+	}
+
+	if (minCellX > maxCellX)
+	{
+		RPG_Log(RpgLogWorld, "Build streaming cells: No game object to stream");
+		return true;
+	}
+
+	const int64_t cellCountX = static_cast<int64_t>(maxCellX) - minCellX + 1;
+	const int64_t cellCountZ = static_cast<int64_t>(maxCellZ) - minCellZ + 1;
+
+	if (cellCountX * cellCountZ > RPG_WORLD_STREAMING_MAX_CELL)
+	{
+		RPG_LogError(RpgLogWorld, "Build streaming cells failed. Cell count (%i x %i) exceeds maximum (%i). Increase cell size!", static_cast<int>(cellCountX), static_cast<int>(cellCountZ), RPG_WORLD_STREAMING_MAX_CELL);
+		return false;
+	}
+
+	InitializeGrid(cellSize, minCellX, minCellZ, static_cast<int>(cellCountX), static_cast<int>(cellCountZ));
+	DirectoryPath = directoryPath;
+
+
+	// Game objects of each cell, whole hierarchy goes into the cell of its root
+	RpgArray<RpgArray<RpgGameObjectID>> cellGameObjects(Cells.GetCount());
+
+	for (int i = 0; i < gameObjectCount; ++i)
+	{
+		const int rootIndex = rootIndices[i];
+
+		if (bKeepRoots[rootIndex])
+		{
+			continue;
+		}
+
+		const int cellIndex = (rootCellZ[rootIndex] - MinCellZ) * CellCountX + (rootCellX[rootIndex] - MinCellX);
+		cellGameObjects[cellIndex].AddValue(gameObjects[i]);
+	}
+
+
+	// Cell snapshots. Assets are kept by the asset table, cells are loaded back without resolver
+	RpgArray<uint8_t> bytes;
+	RpgArray<uint8_t> manifestBytes(static_cast<int>(sizeof(RpgWorldStreamingManifestHeader)) + Cells.GetCount());
+	uint8_t* hasData = manifestBytes.GetData(sizeof(RpgWorldStreamingManifestHeader));
+	int streamedCount = 0;
+
+	for (int c = 0; c < Cells.GetCount(); ++c)
+	{
+		FCell& cell = Cells[c];
+		const RpgArray<RpgGameObjectID>& cellObjects = cellGameObjects[c];
+		hasData[c] = 0;
+
+		if (cellObjects.IsEmpty())
+		{
+			continue;
+		}
+
+		world->Snapshot_Save(bytes, cellObjects.GetData(), cellObjects.GetCount(), &AssetTable);
+
+		if (!RpgPlatformFile::File_Write(*GetCellFilePath(cell.X, cell.Z), bytes.GetData(), bytes.GetCount()))
+		{
+			RPG_LogError(RpgLogWorld, "Build streaming cells failed. Cannot write cell (%i, %i)!", cell.X, cell.Z);
+			Reset();
+			return false;
+		}
+
+		cell.bHasData = true;
+		hasData[c] = 1;
+		streamedCount += cellObjects.GetCount();
+	}
+
+
+	// Manifest
+	RpgWorldStreamingManifestHeader& header = *reinterpret_cast<RpgWorldStreamingManifestHeader*>(manifestBytes.GetData());
+	header = RpgWorldStreamingManifestHeader();
+	header.Magix = RPG_WORLD_STREAMING_MAGIX;
+	header.Version = RPG_WORLD_STREAMING_VERSION;
+	header.CellSize = CellSize;
+	header.MinCellX = MinCellX;
+	header.MinCellZ = MinCellZ;
+	header.CellCountX = CellCountX;
+	header.CellCountZ = CellCountZ;
+
+	if (!RpgPlatformFile::File_Write(*(DirectoryPath + "/manifest.rpgwm"), manifestBytes.GetData(), manifestBytes.GetCount()))
+	{
+		RPG_LogError(RpgLogWorld, "Build streaming cells failed. Cannot write manifest!");
+		Reset();
+		return false;
+	}
+
+
+	// Streamed game objects are created again when their cells are activated
+	for (int c = 0; c < cellGameObjects.GetCount(); ++c)
+	{
+		RpgArray<RpgGameObjectID>& cellObjects = cellGameObjects[c];
+
+		for (int i = 0; i < cellObjects.GetCount(); ++i)
+		{
+			world->GameObject_Destroy(cellObjects[i]);
+		}
+	}
+
+	RPG_Log(RpgLogWorld, "Build streaming cells (%s): %i game objects into %i x %i cells of size %.2f", *DirectoryPath, streamedCount, CellCountX, CellCountZ, CellSize);
+
+	return true;
+}
+
+
+bool RpgStreamingWorldSubsystem::LoadManifest(const RpgString& directoryPath) noexcept
+{
+	RPG_IsMainThread();
+
+	Reset();
+
+	const RpgString manifestPath = directoryPath + "/manifest.rpgwm";
+	const int64_t sizeBytes = RpgPlatformFile::File_GetSize(*manifestPath);
+
+	if (sizeBytes < static_cast<int64_t>(sizeof(RpgWorldStreamingManifestHeader)) || sizeBytes > static_cast<int64_t>(sizeof(RpgWorldStreamingManifestHeader)) + RPG_WORLD_STREAMING_MAX_CELL)
+	{
+		RPG_LogError(RpgLogWorld, "Load streaming manifest (%s) failed. Invalid file size!", *manifestPath);
+		return false;
+	}
+
+	RpgArray<uint8_t> bytes(static_cast<int>(sizeBytes));
+
+	if (!RpgPlatformFile::File_Read(*manifestPath, bytes.GetData(), bytes.GetCount()))
+	{
+		return false;
+	}
+
+	const RpgWorldStreamingManifestHeader& header = *reinterpret_cast<const RpgWorldStreamingManifestHeader*>(bytes.GetData());
+
+	if (header.Magix != RPG_WORLD_STREAMING_MAGIX || header.Version != RPG_WORLD_STREAMING_VERSION || !(header.CellSize > 0.0f) ||
+		header.CellCountX <= 0 || header.CellCountZ <= 0 || static_cast<int64_t>(header.CellCountX) * header.CellCountZ != sizeBytes - static_cast<int64_t>(sizeof(RpgWorldStreamingManifestHeader)))
+	{
+		RPG_LogError(RpgLogWorld, "Load streaming manifest (%s) failed. Invalid header!", *manifestPath);
+		return false;
+	}
+
+	InitializeGrid(header.CellSize, header.MinCellX, header.MinCellZ, header.CellCountX, header.CellCountZ);
+	DirectoryPath = directoryPath;
+
+	const uint8_t* hasData = bytes.GetData(sizeof(RpgWorldStreamingManifestHeader));
+
+	for (int c = 0; c < Cells.GetCount(); ++c)
+	{
+		Cells[c].bHasData = (hasData[c] != 0);
+	}
+
+	return true;
+}
+
+
+void RpgStreamingWorldSubsystem::Reset() noexcept
+{
+	WaitLoadTasks();
+
+	for (int i = 0; i < ResidentCells.GetCount(); ++i)
+	{
+		UnloadCell(ResidentCells[i]);
+	}
+
+	ResidentCells.Clear();
+	Cells.Clear(true);
+	DirectoryPath.Clear();
+	CellSize = 0.0f;
+	MinCellX = 0;
+	MinCellZ = 0;
+	CellCountX = 0;
+	CellCountZ = 0;
+	ActiveCellCount = 0;
+}
+
+
+void RpgStreamingWorldSubsystem::PreTickUpdate() noexcept
+{
+	RPG_PROFILER_Scope("RpgStreamingWorldSubsystem::PreTickUpdate");
+
+	FinishLoadTasks();
+
+	RpgWorld* world = GetWorld();
+
+	if (Cells.IsEmpty() || !world->GameObject_IsValid(FocusGameObject))
+	{
+		return;
+	}
+
+	const RpgVector3 focusPosition = world->GameObject_GetWorldTransformMatrix(FocusGameObject).GetPosition();
+	const float loadRadius = RpgMath::Max(LoadRadius, 0.0f);
+	const float unloadRadius = RpgMath::Max(UnloadRadius, loadRadius);
+	const float loadRadiusSquared = loadRadius * loadRadius;
+	const float unloadRadiusSquared = unloadRadius * unloadRadius;
+
+
+	// Unload resident cells beyond unload radius. Cell that is loading is dropped when its task finished
+	for (int i = ResidentCells.GetCount() - 1; i >= 0; --i)
+	{
+		const int cellIndex = ResidentCells[i];
+		FCell& cell = Cells[cellIndex];
+		const bool bOutside = GetCellDistanceSquared(cell, focusPosition.X, focusPosition.Z) > unloadRadiusSquared;
+
+		if (cell.State == ECellState::LOADING)
+		{
+			cell.bCancelLoad = bOutside;
+		}
+		else if (bOutside)
+		{
+			UnloadCell(cellIndex);
+			ResidentCells.RemoveAt(i, false);
+		}
+	}
+
+
+	// Activate loaded cells, nearest first
+	CellCandidates.Clear();
+
+	for (int i = 0; i < ResidentCells.GetCount(); ++i)
+	{
+		const int cellIndex = ResidentCells[i];
+
+		if (Cells[cellIndex].State == ECellState::LOADED)
+		{
+			CellCandidates.AddValue({ cellIndex, GetCellDistanceSquared(Cells[cellIndex], focusPosition.X, focusPosition.Z) });
+		}
+	}
+
+	RpgAlgorithm::InsertionSort(CellCandidates.GetData(), CellCandidates.GetCount(), [](const FCellCandidate& a, const FCellCandidate& b)
+	{
+		return a.DistanceSquared < b.DistanceSquared;
+	});
+
+	const int activateCount = RpgMath::Min(CellCandidates.GetCount(), MaxActivateCellPerFrame);
+
+	for (int i = 0; i < activateCount; ++i)
+	{
+		ActivateCell(CellCandidates[i].CellIndex);
+	}
+
+
+	// Load cells within load radius, nearest first. Only cells around the focus are visited
+	int freeTaskCount = 0;
+
+	for (int t = 0; t < RPG_WORLD_STREAMING_MAX_LOAD_TASK; ++t)
+	{
+		freeTaskCount += (LoadTasks[t].CellIndex == RPG_INDEX_INVALID);
+	}
+
+	if (freeTaskCount == 0)
+	{
+		return;
+	}
+
+	const int beginX = RpgMath::Max(static_cast<int>(SDL_floorf((focusPosition.X - loadRadius) / CellSize)) - MinCellX, 0);
+	const int endX = RpgMath::Min(static_cast<int>(SDL_floorf((focusPosition.X + loadRadius) / CellSize)) - MinCellX, CellCountX - 1);
+	const int beginZ = RpgMath::Max(static_cast<int>(SDL_floorf((focusPosition.Z - loadRadius) / CellSize)) - MinCellZ, 0);
+	const int endZ = RpgMath::Min(static_cast<int>(SDL_floorf((focusPosition.Z + loadRadius) / CellSize)) - MinCellZ, CellCountZ - 1);
+
+	CellCandidates.Clear();
+
+	for (int z = beginZ; z <= endZ; ++z)
+	{
+		for (int x = beginX; x <= endX; ++x)
+		{
+			const int cellIndex = z * CellCountX + x;
+			const FCell& cell = Cells[cellIndex];
+
+			if (cell.State != ECellState::UNLOADED || !cell.bHasData)
+			{
+				continue;
+			}
+
+			const float distanceSquared = GetCellDistanceSquared(cell, focusPosition.X, focusPosition.Z);
+
+			if (distanceSquared < loadRadiusSquared)
+			{
+				CellCandidates.AddValue({ cellIndex, distanceSquared });
+			}
+		}
+	}
+
+	RpgAlgorithm::InsertionSort(CellCandidates.GetData(), CellCandidates.GetCount(), [](const FCellCandidate& a, const FCellCandidate& b)
+	{
+		return a.DistanceSquared < b.DistanceSquared;
+	});
+
+	int candidateIndex = 0;
+
+	for (int t = 0; t < RPG_WORLD_STREAMING_MAX_LOAD_TASK && candidateIndex < CellCandidates.GetCount(); ++t)
+	{
+		RpgStreamingTask_LoadCell& task = LoadTasks[t];
+
+		if (task.CellIndex != RPG_INDEX_INVALID)
+		{
+			continue;
+		}
+
+		const int cellIndex = CellCandidates[candidateIndex++].CellIndex;
+		FCell& cell = Cells[cellIndex];
+		cell.State = ECellState::LOADING;
+		cell.bCancelLoad = false;
+		ResidentCells.AddValue(cellIndex);
+
+		task.Reset();
+		task.FilePath = GetCellFilePath(cell.X, cell.Z);
+		task.CellIndex = cellIndex;
+
+		RpgThreadTask* submitTask = &task;
+		RpgThreadPool::SubmitTasks(&submitTask, 1);
+	}
+}
+
+
+void RpgStreamingWorldSubsystem::InitializeGrid(float cellSize, int minCellX, int minCellZ, int cellCountX, int cellCountZ) noexcept
+{
+	CellSize = cellSize;
+	MinCellX = minCellX;
+	MinCellZ = minCellZ;
+	CellCountX = cellCountX;
+	CellCountZ = cellCountZ;
+
+	Cells.Resize(cellCountX * cellCountZ);
+
+	for (int z = 0; z < cellCountZ; ++z)
+	{
+		for (int x = 0; x < cellCountX; ++x)
+		{
+			FCell& cell = Cells[z * cellCountX + x];
+			cell.X = minCellX + x;
+			cell.Z = minCellZ + z;
+			cell.State = ECellState::UNLOADED;
+			cell.bHasData = false;
+			cell.bCancelLoad = false;
+		}
+	}
+}
+
+
+void RpgStreamingWorldSubsystem::WaitLoadTasks() noexcept
+{
+	for (int t = 0; t < RPG_WORLD_STREAMING_MAX_LOAD_TASK; ++t)
+	{
+		if (LoadTasks[t].IsRunning())
+		{
+			LoadTasks[t].Wait();
+		}
+	}
+
+	FinishLoadTasks();
+}
+
+
+void RpgStreamingWorldSubsystem::FinishLoadTasks() noexcept
+{
+	for (int t = 0; t < RPG_WORLD_STREAMING_MAX_LOAD_TASK; ++t)
+	{
+		RpgStreamingTask_LoadCell& task = LoadTasks[t];
+
+		if (task.CellIndex == RPG_INDEX_INVALID || !task.IsDone())
+		{
+			continue;
+		}
+
+		FCell& cell = Cells[task.CellIndex];
+		RPG_Assert(cell.State == ECellState::LOADING);
+
+		if (cell.bCancelLoad || !task.bSucceeded)
+		{
+			if (!cell.bCancelLoad)
+			{
+				RPG_LogWarn(RpgLogWorld, "Load streaming cell (%i, %i) failed!", cell.X, cell.Z);
+			}
+
+			cell.State = cell.bCancelLoad ? ECellState::UNLOADED : ECellState::FAILED;
+			cell.bCancelLoad = false;
+			ResidentCells.RemoveByValue(task.CellIndex, false);
+		}
+		else
+		{
+			cell.Data = std::move(task.Bytes);
+			cell.State = ECellState::LOADED;
+		}
+
+		task.CellIndex = RPG_INDEX_INVALID;
+	}
+}
+
+
+void RpgStreamingWorldSubsystem::UnloadCell(int cellIndex) noexcept
+{
+	FCell& cell = Cells[cellIndex];
+	RPG_Assert(cell.State != ECellState::LOADING);
+
+	if (cell.State == ECellState::ACTIVE)
+	{
+		RpgWorld* world = GetWorld();
+
+		for (int i = 0; i < cell.GameObjects.GetCount(); ++i)
+		{
+			if (world->GameObject_IsValid(cell.GameObjects[i]))
+			{
+				world->GameObject_Destroy(cell.GameObjects[i]);
+			}
+		}
+
+		cell.GameObjects.Clear(true);
+		--ActiveCellCount;
+	}
+
+	cell.Data.Clear(true);
+	cell.State = ECellState::UNLOADED;
+}
+
+
+void RpgStreamingWorldSubsystem::ActivateCell(int cellIndex) noexcept
+{
+	FCell& cell = Cells[cellIndex];
+	RPG_Assert(cell.State == ECellState::LOADED);
+
+	if (GetWorld()->Snapshot_Load(cell.Data.GetData(), cell.Data.GetCount(), AssetTable, &cell.GameObjects))
+	{
+		cell.State = ECellState::ACTIVE;
+		++ActiveCellCount;
+	}
+	else
+	{
+		RPG_LogWarn(RpgLogWorld, "Activate streaming cell (%i, %i) failed!", cell.X, cell.Z);
+		cell.State = ECellState::FAILED;
+		ResidentCells.RemoveByValue(cellIndex, false);
+	}
+
+	cell.Data.Clear(true);
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "RpgWorld.h"
+#include "../RpgThreadPool.h"
+
+
+// Magic number for world streaming manifest header
+#define RPG_WORLD_STREAMING_MAGIX				0x4D535752 // (RWSM)
+
+// World streaming manifest version. Bump when layout of manifest changes
+#define RPG_WORLD_STREAMING_VERSION				1
+
+// Maximum number of cells being read from file at the same time
+#define RPG_WORLD_STREAMING_MAX_LOAD_TASK		4
+
+// Maximum number of cells in the grid
+#define RPG_WORLD_STREAMING_MAX_CELL			(1024 * 1024)
+
+
+
+// Manifest layout: [Header], uint8_t HasData[CellCountX * CellCountZ] (row-major, X first)
+struct RpgWorldStreamingManifestHeader
+{
+	uint32_t Magix{ 0 };
+	uint16_t Version{ 0 };
+	uint16_t Padding{ 0 };
+	float CellSize{ 0.0f };
+	int MinCellX{ 0 };
+	int MinCellZ{ 0 };
+	int CellCountX{ 0 };
+	int CellCountZ{ 0 };
+};
+
+
+
+// Read snapshot file of one cell on background thread
+class RpgStreamingTask_LoadCell : public RpgThreadTask
+{
+public:
+	RpgString FilePath;
+	int CellIndex;
+
+	// Snapshot data of the cell, valid if bSucceeded
+	RpgArray<uint8_t> Bytes;
+	bool bSucceeded;
+
+
+public:
+	RpgStreamingTask_LoadCell() noexcept;
+	virtual void Reset() noexcept override;
+	virtual void Execute() noexcept override;
+
+
+	virtual const char* GetTaskName() const noexcept override
+	{
+		return "RpgStreamingTask_LoadCell";
+	}
+
+};
+
+
+
+// Stream game objects of the world in grid cells (XZ plane) around the focus game object.
+// BuildCells() partitions the game objects into cells, each cell is saved into its own world snapshot file and the game objects are destroyed.
+// Cells within LoadRadius are read on background threads and activated (Snapshot_Load) on main thread, nearest first.
+// Cells beyond UnloadRadius are destroyed. UnloadRadius must be larger than LoadRadius so cells at the border do not load/unload every frame.
+// Each frame only visits the cells around the focus and the resident cells.
+// Cells are activated and unloaded in PreTickUpdate (RpgWorld::BeginFrame), where no world task is running.
+class RpgStreamingWorldSubsystem : public RpgWorldSubsystem
+{
+public:
+	// Distance from focus to the cell bounds (XZ) where the cell is loaded
+	float LoadRadius;
+
+	// Distance from focus to the cell bounds (XZ) where the cell is unloaded
+	float UnloadRadius;
+
+	// Maximum number of loaded cells activated per frame. Limits spike of creating game objects
+	int MaxActivateCellPerFrame;
+
+
+public:
+	RpgStreamingWorldSubsystem() noexcept;
+	virtual ~RpgStreamingWorldSubsystem() noexcept;
+
+
+	// Partition game objects of the world into cells, write cell snapshots and manifest into <directoryPath>, then destroy the partitioned game objects.
+	// Game object is placed with its whole hierarchy into the cell of its root world position. Hierarchy that has any script attached stays in the world
+	// @param directoryPath - Existing directory to write the files into
+	// @param cellSize - Size of cell in world units
+	// @returns TRUE if all files have been written
+	bool BuildCells(const RpgString& directoryPath, float cellSize) noexcept;
+
+
+	// Read manifest written by BuildCells(). Resident cells are unloaded first
+	// @param directoryPath - Directory of manifest and cell snapshots
+	// @returns TRUE if loaded
+	bool LoadManifest(const RpgString& directoryPath) noexcept;
+
+
+	// Unload all cells and clear the grid
+	void Reset() noexcept;
+
+
+	// Set game object whose world position is the center of streaming. Nothing is streamed if it's invalid
+	inline void SetFocusGameObject(RpgGameObjectID gameObject) noexcept
+	{
+		FocusGameObject = gameObject;
+	}
+
+
+	// Asset table used to load cells. Keeps assets referenced by cells built with BuildCells(), set resolvers for cells from LoadManifest()
+	[[nodiscard]] inline RpgWorldSnapshotAssetTable& GetAssetTable() noexcept
+	{
+		return AssetTable;
+	}
+
+
+	[[nodiscard]] inline int GetActiveCellCount() const noexcept
+	{
+		return ActiveCellCount;
+	}
+
+
+protected:
+	virtual void PreTickUpdate() noexcept override;
+
+
+private:
+	enum class ECellState : uint8_t
+	{
+		UNLOADED = 0,
+		LOADING,
+		LOADED,
+		ACTIVE,
+		FAILED
+	};
+
+
+	struct FCell
+	{
+		int X;
+		int Z;
+		ECellState State;
+		bool bHasData;
+
+		// Unload requested while the cell is loading, data is dropped when the task finished
+		bool bCancelLoad;
+
+		// Snapshot data, valid if LOADED
+		RpgArray<uint8_t> Data;
+
+		// Created game objects, valid if ACTIVE
+		RpgArray<RpgGameObjectID> GameObjects;
+	};
+
+
+	struct FCellCandidate
+	{
+		int CellIndex;
+		float DistanceSquared;
+	};
+
+
+	[[nodiscard]] inline RpgString GetCellFilePath(int cellX, int cellZ) const noexcept
+	{
+		return RpgString::Format("%s/cell_%i_%i.rpgws", *DirectoryPath, cellX, cellZ);
+	}
+
+
+	// Squared distance from <point> (XZ) to the bounds of cell
+	[[nodiscard]] inline float GetCellDistanceSquared(const FCell& cell, float pointX, float pointZ) const noexcept
+	{
+		const float minX = static_cast<float>(cell.X) * CellSize;
+		const float minZ = static_cast<float>(cell.Z) * CellSize;
+		const float dx = RpgMath::Max(RpgMath::Max(minX - pointX, pointX - (minX + CellSize)), 0.0f);
+		const float dz = RpgMath::Max(RpgMath::Max(minZ - pointZ, pointZ - (minZ + CellSize)), 0.0f);
+
+		return dx * dx + dz * dz;
+	}
+
+
+	void InitializeGrid(float cellSize, int minCellX, int minCellZ, int cellCountX, int cellCountZ) noexcept;
+	void WaitLoadTasks() noexcept;
+	void FinishLoadTasks() noexcept;
+	void UnloadCell(int cellIndex) noexcept;
+	void ActivateCell(int cellIndex) noexcept;
+
+
+private:
+	RpgString DirectoryPath;
+	RpgWorldSnapshotAssetTable AssetTable;
+	RpgGameObjectID FocusGameObject;
+
+	// Dense grid, index = (Z - MinCellZ) * CellCountX + (X - MinCellX)
+	RpgArray<FCell> Cells;
+	float CellSize;
+	int MinCellX;
+	int MinCellZ;
+	int CellCountX;
+	int CellCountZ;
+
+	// Cells that are LOADING, LOADED or ACTIVE
+	RpgArray<int> ResidentCells;
+	int ActiveCellCount;
+
+	// Cells to activate or load in current frame, nearest first
+	RpgArray<FCellCandidate> CellCandidates;
+
+	RpgStreamingTask_LoadCell LoadTasks[RPG_WORLD_STREAMING_MAX_LOAD_TASK];
+
+};
@@ -1,4 +1,7 @@
 #include "RpgWorld.h"
+#include "RpgWorldCommandBuffer.h"
+#include "../RpgAllocator.h"
+#include "../RpgThreadPool.h"
 
 
 RPG_LOG_DEFINE_CATEGORY(RpgLogWorld, VERBOSITY_DEBUG)
@@ -11,7 +14,26 @@ RpgWorld::RpgWorld(const RpgName& name) noexcept
 
     Name = name;
     bHasStartedPlay = false;
+    bDispatchingScriptTick = false;
     FrameIndex = 0;
+    QueryLock = 0;
+
+    SubsystemScheduleLevelCount = 0;
+    bSubsystemScheduleDirty = true;
+
+    // Main thread + thread pool workers
+    CommandBuffers.Resize(RpgThreadPool::GetWorkerCount() + 1);
+
+    for (int i = 0; i < CommandBuffers.GetCount(); ++i)
+    {
+        CommandBuffers[i] = new RpgWorldCommandBuffer();
+    }
+
+    RpgPlatformMemory::MemZero(ComponentVersions, sizeof(ComponentVersions));
+
+    RpgPlatformMemory::MemZero(HierarchyLevelOffsets, sizeof(HierarchyLevelOffsets));
+    HierarchyMaxDepth = 0;
+    bHierarchyDirty = false;
 }
 
 
@@ -19,6 +41,11 @@ RpgWorld::~RpgWorld() noexcept
 {
     RPG_LogDebug(RpgLogWorld, "Destroy world (%s)", *Name);
 
+    for (int i = 0; i < CommandBuffers.GetCount(); ++i)
+    {
+        delete CommandBuffers[i];
+    }
+
     for (int i = 0; i < ComponentStorages.GetCount(); ++i)
     {
         if (ComponentStorages[i])
@@ -44,29 +71,58 @@ void RpgWorld::BeginFrame(int frameIndex) noexcept
     for (int i = 0; i < frame.PendingDestroyObjects.GetCount(); ++i)
     {
         const int index = frame.PendingDestroyObjects[i];
-        FGameObjectInfo& info = GameObjectInfos[index];
+        const FGameObjectInfo& info = GameObjectInfos[index];
 
         for (int c = 0; c < RPG_COMPONENT_TYPE_MAX_COUNT; ++c)
         {
             if (info.ComponentIndices[c] != RPG_COMPONENT_ID_INVALID)
             {
                 ComponentStorages[c]->Remove(info.ComponentIndices[c]);
-                info.ComponentIndices[c] = RPG_COMPONENT_ID_INVALID;
             }
         }
 
-        info.Flags = 0;
+        // Free the slot, generation is kept in GameObjectStates
+        GameObjectNames.RemoveAt(index);
+        GameObjectInfos.RemoveAt(index);
+        GameObjectTransforms.RemoveAt(index);
+        GameObjectStates[index].Flags = FLAG_None;
+    }
+
+    if (frame.PendingDestroyObjects.GetCount() > 0)
+    {
+        bHierarchyDirty = true;
+    }
+
+    frame.PendingDestroyObjects.Clear();
+
+    for (int i = 0; i < Subsystems.GetCount(); ++i)
+    {
+        Subsystems[i]->PreTickUpdate();
     }
 }
 
 
 void RpgWorld::EndFrame(int frameIndex) noexcept
 {
-    for (auto it = GameObjectInfos.CreateIterator(); it; ++it)
+    // Only game objects that moved this frame have the flag set
+    for (int i = 0; i < TransformUpdatedObjects.GetCount(); ++i)
     {
-        FGameObjectInfo& gameObjectInfo = it.GetValue();
-        gameObjectInfo.Flags &= ~FLAG_TransformUpdated;
+        const RpgGameObjectID gameObject = TransformUpdatedObjects[i];
+        FGameObjectState& state = GameObjectStates[gameObject.Index];
+
+        // Slot may have been freed and reused since
+        if (state.Gen == gameObject.Gen)
+        {
+            state.Flags &= ~FLAG_TransformUpdated;
+        }
     }
+
+    TransformUpdatedObjects.Clear();
+    CreatedObjects.Clear();
+    DestroyedObjects.Clear();
+
+    // Changes recorded during this frame show up in change lists of next frame
+    CommandBuffer_Playback();
 }
 
 
@@ -82,9 +138,9 @@ void RpgWorld::DispatchStartPlay() noexcept
         Subsystems[i]->StartPlay();
     }
 
-    for (int i = 0; i < GameObjectScripts.GetCount(); ++i)
+    for (auto it = GameObjectScripts.CreateIterator(); it; ++it)
     {
-        RpgGameObjectScript* script = GameObjectScripts[i];
+        RpgGameObjectScript* script = it.GetValue();
         RPG_Check(script);
 
         if (!script->bStartedPlay)
@@ -110,9 +166,9 @@ void RpgWorld::DispatchStopPlay() noexcept
         Subsystems[i]->StopPlay();
     }
 
-    for (int i = 0; i < GameObjectScripts.GetCount(); ++i)
+    for (auto it = GameObjectScripts.CreateIterator(); it; ++it)
     {
-        RpgGameObjectScript* script = GameObjectScripts[i];
+        RpgGameObjectScript* script = it.GetValue();
         RPG_Check(script);
 
         if (script->bStartedPlay)
@@ -128,27 +184,80 @@ void RpgWorld::DispatchStopPlay() noexcept
 
 void RpgWorld::DispatchTickUpdate(float deltaTime) noexcept
 {
-    for (int i = 0; i < Subsystems.GetCount(); ++i)
+    Subsystem_DispatchSchedule(false, deltaTime);
+
+    // Scripts attached/detached by TickUpdate must not move the arrays being ticked. See Script_AddToGroup/Script_RemoveFromGroup
+    bDispatchingScriptTick = true;
+
+    // One batch call per script type. Thread-safe types are split into chunks across thread pool
+    for (int g = 0; g < ScriptGroups.GetCount(); ++g)
     {
-        Subsystems[i]->TickUpdate(deltaTime);
+        const FScriptGroup& group = ScriptGroups[g];
+        const int scriptCount = group.Scripts.GetCount();
+
+        if (scriptCount == 0)
+        {
+            continue;
+        }
+
+        RpgGameObjectScript* const* scripts = group.Scripts.GetData();
+        const RpgGameObjectScript::FTickUpdateBatchFunction tickUpdate = group.TickUpdateBatch.Function;
+
+        if (group.TickUpdateBatch.bThreadSafe)
+        {
+            RpgThreadPool::ParallelFor(scriptCount, RPG_WORLD_SCRIPT_TICK_GRAIN_SIZE,
+                [scripts, tickUpdate, deltaTime](int beginIndex, int endIndex)
+                {
+                    tickUpdate(scripts + beginIndex, endIndex - beginIndex, deltaTime);
+                }
+            );
+        }
+        else
+        {
+            tickUpdate(scripts, scriptCount, deltaTime);
+        }
     }
 
-    for (int i = 0; i < GameObjectScripts.GetCount(); ++i)
+    bDispatchingScriptTick = false;
+
+    for (int g = 0; g < ScriptGroups.GetCount(); ++g)
     {
-        RpgGameObjectScript* script = GameObjectScripts[i];
-        RPG_Check(script);
+        FScriptGroup& group = ScriptGroups[g];
 
-        script->TickUpdate(deltaTime);
+        if (!group.bHasRemovedScript)
+        {
+            continue;
+        }
+
+        int count = 0;
+
+        for (int i = 0; i < group.Scripts.GetCount(); ++i)
+        {
+            if (group.Scripts[i])
+            {
+                group.Scripts[count++] = group.Scripts[i];
+            }
+        }
+
+        group.Scripts.Resize(count);
+        group.bHasRemovedScript = false;
     }
+
+    for (int i = 0; i < PendingGroupAddScripts.GetCount(); ++i)
+    {
+        Script_AddToGroup(PendingGroupAddScripts[i]);
+    }
+
+    PendingGroupAddScripts.Clear();
 }
 
 
 void RpgWorld::DispatchPostTickUpdate() noexcept
 {
-    for (int i = 0; i < Subsystems.GetCount(); ++i)
-    {
-        Subsystems[i]->PostTickUpdate();
-    }
+    // Children must have final world transform before subsystems read it
+    GameObject_UpdateHierarchy();
+
+    Subsystem_DispatchSchedule(true, 0.0f);
 }
 
 
@@ -161,15 +270,240 @@ void RpgWorld::DispatchRender(int frameIndex, RpgRenderer* renderer) noexcept
 }
 
 
+void RpgWorld::Subsystem_BuildSchedule() noexcept
+{
+    const int subsystemCount = Subsystems.GetCount();
+
+    // component type bitmask, subsystem without declaration conflicts with everything
+    uint32_t readMasks[16];
+    uint32_t writeMasks[16];
+    int levels[16];
+
+    for (int i = 0; i < subsystemCount; ++i)
+    {
+        const RpgWorldSubsystem* subsystem = Subsystems[i];
+        readMasks[i] = 0;
+        writeMasks[i] = 0;
+
+        if (!subsystem->bDeclaredComponentAccess)
+        {
+            readMasks[i] = UINT32_MAX;
+            writeMasks[i] = UINT32_MAX;
+            continue;
+        }
+
+        for (int t = 0; t < subsystem->ComponentReadTypeIds.GetCount(); ++t)
+        {
+            const uint16_t typeId = *subsystem->ComponentReadTypeIds[t];
+            RPG_CheckV(typeId < RPG_COMPONENT_TYPE_MAX_COUNT, "RpgWorld: Subsystem (%s) declares component type that has not been registered!", *subsystem->Name);
+            readMasks[i] |= (1u << typeId);
+        }
+
+        for (int t = 0; t < subsystem->ComponentWriteTypeIds.GetCount(); ++t)
+        {
+            const uint16_t typeId = *subsystem->ComponentWriteTypeIds[t];
+            RPG_CheckV(typeId < RPG_COMPONENT_TYPE_MAX_COUNT, "RpgWorld: Subsystem (%s) declares component type that has not been registered!", *subsystem->Name);
+            writeMasks[i] |= (1u << typeId);
+        }
+    }
+
+    int levelCounts[16]{};
+    SubsystemScheduleLevelCount = 0;
+
+    for (int i = 0; i < subsystemCount; ++i)
+    {
+        int level = 0;
+
+        for (int j = 0; j < i; ++j)
+        {
+            const bool bConflict = (writeMasks[i] & (readMasks[j] | writeMasks[j])) || (writeMasks[j] & readMasks[i]);
+
+            if (bConflict && levels[j] + 1 > level)
+            {
+                level = levels[j] + 1;
+            }
+        }
+
+        levels[i] = level;
+        ++levelCounts[level];
+
+        if (level + 1 > SubsystemScheduleLevelCount)
+        {
+            SubsystemScheduleLevelCount = level + 1;
+        }
+    }
+
+    SubsystemScheduleLevelOffsets[0] = 0;
+
+    for (int l = 0; l < SubsystemScheduleLevelCount; ++l)
+    {
+        SubsystemScheduleLevelOffsets[l + 1] = SubsystemScheduleLevelOffsets[l] + levelCounts[l];
+    }
+
+    // priority order is kept within each level
+    SubsystemSchedule.Resize(subsystemCount);
+    int writeIndices[16];
+    RpgPlatformMemory::MemCopy(writeIndices, SubsystemScheduleLevelOffsets, sizeof(int) * SubsystemScheduleLevelCount);
+
+    for (int i = 0; i < subsystemCount; ++i)
+    {
+        SubsystemSchedule[writeIndices[levels[i]]++] = Subsystems[i];
+    }
+
+    RPG_LogDebug(RpgLogWorld, "Build subsystem schedule of world (%s): %i subsystems, %i levels", *Name, subsystemCount, SubsystemScheduleLevelCount);
+}
+
+
+void RpgWorld::Subsystem_DispatchSchedule(bool bPostTickUpdate, float deltaTime) noexcept
+{
+    if (bSubsystemScheduleDirty)
+    {
+        Subsystem_BuildSchedule();
+        bSubsystemScheduleDirty = false;
+    }
+
+    for (int l = 0; l < SubsystemScheduleLevelCount; ++l)
+    {
+        RpgWorldSubsystem* const* subsystems = SubsystemSchedule.GetData() + SubsystemScheduleLevelOffsets[l];
+        const int subsystemCount = SubsystemScheduleLevelOffsets[l + 1] - SubsystemScheduleLevelOffsets[l];
+
+        // one subsystem per chunk, first one runs on calling thread
+        RpgThreadPool::ParallelFor(subsystemCount, 1, 
+            [subsystems, bPostTickUpdate, deltaTime](int beginIndex, int endIndex)
+            {
+                for (int i = beginIndex; i < endIndex; ++i)
+                {
+                    if (bPostTickUpdate)
+                    {
+                        subsystems[i]->PostTickUpdate();
+                    }
+                    else
+                    {
+                        subsystems[i]->TickUpdate(deltaTime);
+                    }
+                }
+            }
+        );
+    }
+}
+
+
+RpgWorldCommandBuffer& RpgWorld::CommandBuffer_Get() noexcept
+{
+    int threadIndex = RpgThreadPool::GetThreadIndex();
+
+    // Thread pool not initialized, only main thread can record
+    if (threadIndex == RPG_INDEX_INVALID)
+    {
+        RPG_IsMainThread();
+        threadIndex = 0;
+    }
+
+    RPG_Check(threadIndex < CommandBuffers.GetCount());
+
+    return *CommandBuffers[threadIndex];
+}
+
+
+void RpgWorld::CommandBuffer_Playback() noexcept
+{
+    RPG_IsMainThread();
+
+    struct FPlaybackCommand
+    {
+        uint64_t SortKey;
+        int BufferIndex;
+        int CommandIndex;
+
+        inline bool operator<(const FPlaybackCommand& rhs) const noexcept
+        {
+            if (SortKey != rhs.SortKey)
+            {
+                return SortKey < rhs.SortKey;
+            }
+
+            return (BufferIndex != rhs.BufferIndex) ? BufferIndex < rhs.BufferIndex : CommandIndex < rhs.CommandIndex;
+        }
+    };
+
+    RpgArrayFrame<FPlaybackCommand> playbackCommands;
+
+    // game objects created by each buffer, pending index of buffer B starts at pendingOffsets[B]
+    RpgArrayFrame<int> pendingOffsets;
+    pendingOffsets.Resize(CommandBuffers.GetCount());
+    int pendingCount = 0;
+
+    for (int b = 0; b < CommandBuffers.GetCount(); ++b)
+    {
+        const RpgWorldCommandBuffer* buffer = CommandBuffers[b];
+
+        for (int c = 0; c < buffer->Commands.GetCount(); ++c)
+        {
+            playbackCommands.AddValue(FPlaybackCommand{ buffer->Commands[c].SortKey, b, c });
+        }
+
+        pendingOffsets[b] = pendingCount;
+        pendingCount += buffer->PendingCount;
+    }
+
+    if (playbackCommands.IsEmpty())
+    {
+        return;
+    }
+
+    RpgAlgorithm::Sort(playbackCommands.GetData(), playbackCommands.GetCount());
+
+    RpgArrayFrame<RpgGameObjectID> pendingGameObjects;
+    pendingGameObjects.Resize(pendingCount);
+
+    for (int i = 0; i < playbackCommands.GetCount(); ++i)
+    {
+        const FPlaybackCommand& playback = playbackCommands[i];
+        RpgWorldCommandBuffer::FCommand& command = CommandBuffers[playback.BufferIndex]->Commands[playback.CommandIndex];
+        const int pendingIndex = (command.TargetPendingIndex != RPG_INDEX_INVALID) ? pendingOffsets[playback.BufferIndex] + command.TargetPendingIndex : RPG_INDEX_INVALID;
+
+        if (command.Execute == nullptr)
+        {
+            // create game object always comes before commands that target it, they share sort key and buffer
+            const RpgWorldCommandBuffer::FCreatePayload* create = static_cast<const RpgWorldCommandBuffer::FCreatePayload*>(command.Payload);
+            pendingGameObjects[pendingIndex] = GameObject_Create(create->Name, create->WorldTransform);
+        }
+        else
+        {
+            const RpgGameObjectID target = (pendingIndex != RPG_INDEX_INVALID) ? pendingGameObjects[pendingIndex] : command.TargetGameObject;
+
+            // target may have been destroyed by previous command
+            if (GameObject_IsValid(target))
+            {
+                command.Execute(this, target, command.Payload);
+            }
+        }
+    }
+
+    for (int b = 0; b < CommandBuffers.GetCount(); ++b)
+    {
+        CommandBuffers[b]->Clear();
+    }
+
+    RPG_LogDebug(RpgLogWorld, "Played back %i deferred commands of world (%s)", playbackCommands.GetCount(), *Name);
+}
+
+
 RpgGameObjectID RpgWorld::GameObject_Create(const RpgName& name, const RpgTransform& worldTransform) noexcept
 {
     RPG_IsMainThread();
 
+    RPG_LogDebug(RpgLogWorld, "Create game object (%s)", *name);
+
+    return GameObject_CreateInternal(name, worldTransform.ToMatrixTransform());
+}
+
+
+RpgGameObjectID RpgWorld::GameObject_CreateInternal(const RpgName& name, const RpgMatrixTransform& worldMatrix) noexcept
+{
     RPG_Assert(!name.IsEmpty());
     RPG_Check(GameObjectNames.GetCount() < RPG_WORLD_MAX_GAMEOBJECT);
 
-    RPG_LogDebug(RpgLogWorld, "Create game object (%s)", *name);
-
     const int nameId = GameObjectNames.Add();
     const int infoId = GameObjectInfos.Add();
     const int transformId = GameObjectTransforms.Add();
@@ -178,20 +512,39 @@ RpgGameObjectID RpgWorld::GameObject_Create(const RpgName& name, const RpgTransf
     GameObjectNames[nameId] = name;
     
     FGameObjectInfo& info = GameObjectInfos[infoId];
-    RpgPlatformMemory::MemSet(info.ComponentIndices, RPG_COMPONENT_ID_INVALID, sizeof(uint16_t) * RPG_COMPONENT_TYPE_MAX_COUNT);
+    RpgPlatformMemory::MemSet(info.ComponentIndices, RPG_COMPONENT_ID_INVALID, sizeof(int) * RPG_COMPONENT_TYPE_MAX_COUNT);
 
-    ++info.Gen;
-    info.Flags = FLAG_Allocated | FLAG_TransformUpdated;
-    RPG_Check(info.Gen < UINT16_MAX);
+    // New slots are always appended
+    if (infoId == GameObjectStates.GetCount())
+    {
+        GameObjectStates.AddValue(FGameObjectState());
+    }
 
-    RpgPlatformMemory::MemSet(info.ScriptIndices, RPG_INDEX_INVALID, sizeof(int16_t) * RPG_GAMEOBJECT_MAX_SCRIPT);
+    FGameObjectState& state = GameObjectStates[infoId];
+    RPG_Check(state.Flags == FLAG_None);
+
+    // Skip invalid generation on wrap around
+    if (++state.Gen == RPG_GAMEOBJECT_GEN_INVALID)
+    {
+        ++state.Gen;
+    }
+
+    state.Flags = FLAG_Allocated;
+
+    RpgPlatformMemory::MemSet(state.ScriptIndices, RPG_INDEX_INVALID, sizeof(int) * RPG_GAMEOBJECT_MAX_SCRIPT);
 
     FGameObjectTransform& transform = GameObjectTransforms[transformId];
-    transform.LocalMatrix = RpgMatrixTransform();
-    transform.WorldMatrix = worldTransform.ToMatrixTransform();
-    transform.InverseWorldMatrix = transform.WorldMatrix.GetInverse();
+    transform.WorldMatrix = worldMatrix;
+    transform.LocalMatrix = worldMatrix;
+    transform.Parent = RpgGameObjectID();
 
-    return RpgGameObjectID(this, nameId, info.Gen);
+    // Inverse is computed on demand
+    GameObject_MarkTransformUpdated(infoId);
+
+    const RpgGameObjectID gameObject(this, nameId, state.Gen);
+    CreatedObjects.AddValue(gameObject);
+
+    return gameObject;
 }
 
 
@@ -199,26 +552,272 @@ void RpgWorld::GameObject_Destroy(RpgGameObjectID& gameObject) noexcept
 {
     RPG_IsMainThread();
 
-    if (GameObject_IsValid(gameObject))
+    // <gameObject> may reference RpgGameObjectScript::GameObject, which is reset when the script is removed below
+    const RpgGameObjectID destroyGameObject = gameObject;
+
+    if (GameObject_IsValid(destroyGameObject))
     {
-        FGameObjectInfo& info = GameObjectInfos[gameObject.Index];
-        info.Flags |= FLAG_PendingDestroy;
+        const FGameObjectInfo& info = GameObjectInfos[destroyGameObject.Index];
+        FGameObjectState& state = GameObjectStates[destroyGameObject.Index];
+        state.Flags |= FLAG_PendingDestroy;
+
+        // Invalidate queries that contain this game object
+        for (int c = 0; c < RPG_COMPONENT_TYPE_MAX_COUNT; ++c)
+        {
+            if (info.ComponentIndices[c] != RPG_COMPONENT_ID_INVALID)
+            {
+                ++ComponentVersions[c];
+            }
+        }
 
         // remove scripts
         for (int i = 0; i < RPG_GAMEOBJECT_MAX_SCRIPT; ++i)
         {
-            const int scriptIndex = info.ScriptIndices[i];
+            const int scriptIndex = state.ScriptIndices[i];
             if (scriptIndex != RPG_INDEX_INVALID)
             {
                 GameObject_RemoveScriptAtIndex(scriptIndex);
-                info.ScriptIndices[i] = RPG_INDEX_INVALID;
+                state.ScriptIndices[i] = RPG_INDEX_INVALID;
             }
         }
 
-        FrameDatas[FrameIndex].PendingDestroyObjects.AddValue(gameObject.Index);
+        // Children are detached on next hierarchy rebuild
+        bHierarchyDirty = true;
+
+        DestroyedObjects.AddValue(destroyGameObject);
 
-        RPG_LogDebug(RpgLogWorld, "Mark game object (%s) as pending destroy", *GameObjectNames[gameObject.Index]);
+        FrameDatas[FrameIndex].PendingDestroyObjects.AddValue(destroyGameObject.Index);
+
+        RPG_LogDebug(RpgLogWorld, "Mark game object (%s) as pending destroy", *GameObjectNames[destroyGameObject.Index]);
     }
 
     gameObject = RpgGameObjectID();
 }
+
+
+void RpgWorld::GameObject_AttachToParent(RpgGameObjectID gameObject, RpgGameObjectID parent, bool bKeepWorldTransform) noexcept
+{
+    RPG_IsMainThread();
+
+    RPG_Check(GameObject_IsValid(gameObject));
+    RPG_Check(GameObject_IsValid(parent));
+
+    // parent must not be game object itself or any of its descendants
+    int depth = 0;
+
+    for (RpgGameObjectID ancestor = parent; ancestor.IsValid(); ancestor = GameObjectTransforms[ancestor.Index].Parent)
+    {
+        if (ancestor == gameObject)
+        {
+            RPG_LogWarn(RpgLogWorld, "Cannot attach game object (%s) to its own descendant (%s)!", *GameObjectNames[gameObject.Index], *GameObjectNames[parent.Index]);
+            return;
+        }
+
+        ++depth;
+    }
+
+    RPG_CheckV(depth < RPG_WORLD_MAX_HIERARCHY_DEPTH, "RpgWorld: Exceeds maximum hierarchy depth (%i)!", RPG_WORLD_MAX_HIERARCHY_DEPTH);
+
+    FGameObjectTransform& transform = GameObjectTransforms[gameObject.Index];
+    transform.Parent = parent;
+
+    if (bKeepWorldTransform)
+    {
+        transform.LocalMatrix = transform.WorldMatrix * GameObject_GetInverseWorldTransformMatrix(parent);
+    }
+    else
+    {
+        transform.LocalMatrix = transform.WorldMatrix;
+    }
+
+    GameObject_MarkTransformUpdated(gameObject.Index);
+    bHierarchyDirty = true;
+
+    RPG_LogDebug(RpgLogWorld, "Attached game object (%s) to parent (%s)", *GameObjectNames[gameObject.Index], *GameObjectNames[parent.Index]);
+}
+
+
+void RpgWorld::GameObject_DetachFromParent(RpgGameObjectID gameObject) noexcept
+{
+    RPG_IsMainThread();
+    RPG_Check(GameObject_IsValid(gameObject));
+
+    FGameObjectTransform& transform = GameObjectTransforms[gameObject.Index];
+
+    if (!transform.Parent.IsValid())
+    {
+        return;
+    }
+
+    transform.Parent = RpgGameObjectID();
+    transform.LocalMatrix = transform.WorldMatrix;
+    bHierarchyDirty = true;
+
+    RPG_LogDebug(RpgLogWorld, "Detached game object (%s) from parent", *GameObjectNames[gameObject.Index]);
+}
+
+
+void RpgWorld::GameObject_RebuildHierarchy() noexcept
+{
+    // detach children whose parent has been destroyed, they keep current world transform
+    for (auto it = GameObjectTransforms.CreateIterator(); it; ++it)
+    {
+        FGameObjectTransform& transform = it.GetValue();
+
+        if (transform.Parent.IsValid() && !GameObject_IsValid(transform.Parent))
+        {
+            transform.Parent = RpgGameObjectID();
+            transform.LocalMatrix = transform.WorldMatrix;
+        }
+    }
+
+    // hierarchy depth of each game object, 0 if it has no parent
+    RpgArrayFrame<uint8_t> depths;
+    depths.Resize(GameObjectTransforms.GetCapacity());
+
+    int depthCounts[RPG_WORLD_MAX_HIERARCHY_DEPTH + 1]{};
+    int childCount = 0;
+    HierarchyMaxDepth = 0;
+
+    for (auto it = GameObjectTransforms.CreateIterator(); it; ++it)
+    {
+        const FGameObjectTransform& transform = it.GetValue();
+        const FGameObjectState& state = GameObjectStates[it.GetIndex()];
+
+        if (!transform.Parent.IsValid() || (state.Flags & FLAG_PendingDestroy))
+        {
+            continue;
+        }
+
+        int depth = 0;
+
+        for (RpgGameObjectID ancestor = transform.Parent; ancestor.IsValid(); ancestor = GameObjectTransforms[ancestor.Index].Parent)
+        {
+            ++depth;
+        }
+
+        RPG_CheckV(depth < RPG_WORLD_MAX_HIERARCHY_DEPTH, "RpgWorld: Exceeds maximum hierarchy depth (%i)!", RPG_WORLD_MAX_HIERARCHY_DEPTH);
+
+        depths[it.GetIndex()] = static_cast<uint8_t>(depth);
+        ++depthCounts[depth];
+        ++childCount;
+
+        if (depth > HierarchyMaxDepth)
+        {
+            HierarchyMaxDepth = depth;
+        }
+    }
+
+    // counting sort by depth
+    HierarchyLevelOffsets[0] = 0;
+    HierarchyLevelOffsets[1] = 0;
+
+    for (int d = 1; d < RPG_WORLD_MAX_HIERARCHY_DEPTH; ++d)
+    {
+        HierarchyLevelOffsets[d + 1] = HierarchyLevelOffsets[d] + depthCounts[d];
+    }
+
+    int writeIndices[RPG_WORLD_MAX_HIERARCHY_DEPTH];
+    RpgPlatformMemory::MemCopy(writeIndices, HierarchyLevelOffsets, sizeof(writeIndices));
+
+    HierarchyChildren.Resize(childCount);
+
+    for (int i = 0; i < depths.GetCount(); ++i)
+    {
+        if (depths[i] > 0)
+        {
+            HierarchyChildren[writeIndices[depths[i]]++] = i;
+        }
+    }
+}
+
+
+void RpgWorld::GameObject_UpdateHierarchy() noexcept
+{
+    if (bHierarchyDirty)
+    {
+        GameObject_RebuildHierarchy();
+        bHierarchyDirty = false;
+    }
+
+    if (HierarchyChildren.IsEmpty())
+    {
+        return;
+    }
+
+    // Children moved only by their parent. Written per child in parallel, then added to TransformUpdatedObjects in level order
+    RpgArrayFrame<uint8_t> movedByParent;
+    movedByParent.Resize(HierarchyChildren.GetCount());
+
+    // parents of depth D are final before depth D + 1 is processed, each child only writes its own transform
+    for (int depth = 1; depth <= HierarchyMaxDepth; ++depth)
+    {
+        const int levelBegin = HierarchyLevelOffsets[depth];
+        const int levelEnd = HierarchyLevelOffsets[depth + 1];
+
+        RpgThreadPool::ParallelFor(levelEnd - levelBegin, 256, 
+            [this, levelBegin, &movedByParent](int beginIndex, int endIndex)
+            {
+                for (int i = levelBegin + beginIndex; i < levelBegin + endIndex; ++i)
+                {
+                    const int index = HierarchyChildren[i];
+                    FGameObjectState& state = GameObjectStates[index];
+                    FGameObjectTransform& transform = GameObjectTransforms[index];
+                    const int parentIndex = transform.Parent.Index;
+
+                    if ((state.Flags | GameObjectStates[parentIndex].Flags) & FLAG_TransformUpdated)
+                    {
+                        transform.WorldMatrix = transform.LocalMatrix * GameObjectTransforms[parentIndex].WorldMatrix;
+                        movedByParent[i] = !(state.Flags & FLAG_TransformUpdated);
+                        state.Flags |= (FLAG_TransformUpdated | FLAG_InverseWorldDirty);
+                    }
+                }
+            }
+        );
+
+        for (int i = levelBegin; i < levelEnd; ++i)
+        {
+            if (movedByParent[i])
+            {
+                const int index = HierarchyChildren[i];
+                TransformUpdatedObjects.AddValue(RpgGameObjectID(this, index, GameObjectStates[index].Gen));
+            }
+        }
+    }
+}
+
+
+RpgWorld::FQueryCache& RpgWorld::Query_FindOrAddCache(const uint16_t* typeIds, int typeCount) noexcept
+{
+    for (auto it = QueryCaches.CreateIterator(); it; ++it)
+    {
+        FQueryCache& cache = it.GetValue();
+
+        if (cache.TypeCount != typeCount)
+        {
+            continue;
+        }
+
+        bool bSameTypes = true;
+
+        for (int t = 0; t < typeCount && bSameTypes; ++t)
+        {
+            bSameTypes = (cache.TypeIds[t] == typeIds[t]);
+        }
+
+        if (bSameTypes)
+        {
+            return cache;
+        }
+    }
+
+    FQueryCache& cache = QueryCaches[QueryCaches.Add()];
+    RpgPlatformMemory::MemCopy(cache.TypeIds, typeIds, sizeof(uint16_t) * typeCount);
+    cache.TypeCount = typeCount;
+    cache.Count = 0;
+
+    // Force build on first query
+    cache.Version = UINT64_MAX;
+
+    return cache;
+}
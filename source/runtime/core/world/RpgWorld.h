@@ -2,16 +2,26 @@
 
 #include "../RpgMath.h"
 #include "../RpgString.h"
+#include "../RpgFilePath.h"
 #include "RpgComponent.h"
+#include "RpgWorldQuery.h"
 
 
-#define RPG_WORLD_MAX_GAMEOBJECT	65536
+// Maximum number of live game objects. Slots of destroyed game objects are reused
+#define RPG_WORLD_MAX_GAMEOBJECT	(1 << 24)
+
+// Maximum depth of game object hierarchy (root game object is depth 0)
+#define RPG_WORLD_MAX_HIERARCHY_DEPTH	32
+
+// Number of scripts per thread pool chunk when ticking thread-safe script type
+#define RPG_WORLD_SCRIPT_TICK_GRAIN_SIZE	32
 
 
 RPG_LOG_DECLARE_CATEGORY_EXTERN(RpgLogWorld)
 
 
 class RpgWorld;
+class RpgWorldCommandBuffer;
 class RpgRenderer;
 
 
@@ -24,7 +34,9 @@ public:
 	RpgWorldSubsystem() noexcept
 	{
 		World = nullptr;
+		TypeKey = nullptr;
 		UpdatePriority = 0;
+		bDeclaredComponentAccess = false;
 	}
 
 	virtual ~RpgWorldSubsystem() noexcept = default;
@@ -32,7 +44,11 @@ public:
 protected:
 	virtual void StartPlay() noexcept {}
 	virtual void StopPlay() noexcept {}
+
+	// Called on main thread at the end of RpgWorld::BeginFrame, before any subsystem submits tasks of the frame.
+	// No world task is running, structural changes (create/destroy game objects, add/remove components) are safe
 	virtual void PreTickUpdate() noexcept {}
+
 	virtual void TickUpdate(float deltaTime) noexcept {}
 	virtual void PostTickUpdate() noexcept {}
 	virtual void Render(int frameIndex, RpgRenderer* renderer) noexcept {}
@@ -49,13 +65,38 @@ protected:
 	}
 
 
+	// Declare component type read by TickUpdate/PostTickUpdate, including tasks they submit. Call in constructor.
+	// Subsystem that declares nothing never runs concurrently with other subsystems
+	template<typename TComponent>
+	inline void DeclareComponentRead() noexcept
+	{
+		ComponentReadTypeIds.AddValue(&TComponent::TYPE_ID);
+		bDeclaredComponentAccess = true;
+	}
+
+
+	// Declare component type written by TickUpdate/PostTickUpdate, including tasks they submit. Call in constructor
+	template<typename TComponent>
+	inline void DeclareComponentWrite() noexcept
+	{
+		ComponentWriteTypeIds.AddValue(&TComponent::TYPE_ID);
+		bDeclaredComponentAccess = true;
+	}
+
+
 protected:
 	RpgName Name;
 
 private:
 	RpgWorld* World;
+	const void* TypeKey;
 	uint8_t UpdatePriority;
 
+	// Pointers to TComponent::TYPE_ID, type IDs are assigned when component types are registered
+	RpgArrayInline<const uint16_t*, RPG_COMPONENT_TYPE_MAX_COUNT> ComponentReadTypeIds;
+	RpgArrayInline<const uint16_t*, RPG_COMPONENT_TYPE_MAX_COUNT> ComponentWriteTypeIds;
+	bool bDeclaredComponentAccess;
+
 
 	friend RpgWorld;
 
@@ -100,7 +141,7 @@ private:
 
 	struct FFrameData
 	{
-		RpgArray<int> PendingDestroyObjects;
+		RpgArraySmall<int, 32> PendingDestroyObjects;
 	};
 
 	FFrameData FrameDatas[RPG_FRAME_BUFFERING];
@@ -112,38 +153,51 @@ private:
 // 	Subsystem interface
 // --------------------------------------------------------------------------------------------------------------------------------------------- //
 public:
+	// Add subsystem. Subsystems are updated in ascending <updatePriority> (insertion order for equal priority).
+	// TickUpdate/PostTickUpdate of subsystems whose declared component access does not conflict run concurrently on thread pool
 	template<typename TWorldSubsystem>
 	inline void Subsystem_Add(uint8_t updatePriority = 0) noexcept
 	{
 		static_assert(std::is_base_of<RpgWorldSubsystem, TWorldSubsystem>::value, "RpgWorld: Add subsystem type of <TWorldSubsystem> must be derived from type <RpgWorldSubsystem>!");
 		
-		for (int i = 0; i < Subsystems.GetCount(); ++i)
+		if (TWorldSubsystem* check = Subsystem_Get<TWorldSubsystem>())
 		{
-			if (TWorldSubsystem* check = dynamic_cast<TWorldSubsystem*>(Subsystems[i]))
-			{
-				RPG_LogWarn(RpgLogWorld, "World subsystem type (%s) already exists!", *check->GetName());
-				return;
-			}
+			RPG_LogWarn(RpgLogWorld, "World subsystem type (%s) already exists!", *check->GetName());
+			return;
 		}
 
 		RpgWorldSubsystem* subsystem = new TWorldSubsystem();
 		subsystem->World = this;
+		subsystem->TypeKey = Subsystem_GetTypeKey<TWorldSubsystem>();
 		subsystem->UpdatePriority = updatePriority;
 
+		// keep sorted by priority
+		int index = Subsystems.GetCount();
 		Subsystems.AddValue(subsystem);
+
+		while (index > 0 && Subsystems[index - 1]->UpdatePriority > updatePriority)
+		{
+			Subsystems[index] = Subsystems[index - 1];
+			--index;
+		}
+
+		Subsystems[index] = subsystem;
+		bSubsystemScheduleDirty = true;
 	}
 
 
+	// Get subsystem of exact type <TWorldSubsystem>
 	template<typename TWorldSubsystem>
 	inline TWorldSubsystem* Subsystem_Get() const noexcept
 	{
 		static_assert(std::is_base_of<RpgWorldSubsystem, TWorldSubsystem>::value, "RpgWorld: Get subsystem type of <TWorldSubsystem> must be derived from type <RpgWorldSubsystem>!");
+		const void* typeKey = Subsystem_GetTypeKey<TWorldSubsystem>();
 
 		for (int i = 0; i < Subsystems.GetCount(); ++i)
 		{
-			if (TWorldSubsystem* check = dynamic_cast<TWorldSubsystem*>(Subsystems[i]))
+			if (Subsystems[i]->TypeKey == typeKey)
 			{
-				return check;
+				return static_cast<TWorldSubsystem*>(Subsystems[i]);
 			}
 		}
 
@@ -152,8 +206,34 @@ public:
 
 
 private:
+	// Unique address per subsystem type, replaces dynamic_cast lookup
+	template<typename TWorldSubsystem>
+	static inline const void* Subsystem_GetTypeKey() noexcept
+	{
+		static const char key = 0;
+		return &key;
+	}
+
+
+	// Group subsystems into levels. Subsystem goes one level after the last higher priority subsystem it conflicts with
+	void Subsystem_BuildSchedule() noexcept;
+
+	// Run TickUpdate (or PostTickUpdate) level by level. Subsystems in the same level run concurrently
+	void Subsystem_DispatchSchedule(bool bPostTickUpdate, float deltaTime) noexcept;
+
+
+private:
+	// Sorted by update priority
 	RpgArrayInline<RpgWorldSubsystem*, 16> Subsystems;
 
+	// Subsystems ordered by level, level L is in range [SubsystemScheduleLevelOffsets[L], SubsystemScheduleLevelOffsets[L + 1])
+	RpgArrayInline<RpgWorldSubsystem*, 16> SubsystemSchedule;
+	int SubsystemScheduleLevelOffsets[16 + 1];
+	int SubsystemScheduleLevelCount;
+
+	// TRUE if subsystem added or component type registered since last schedule build
+	bool bSubsystemScheduleDirty;
+
 
 
 // --------------------------------------------------------------------------------------------------------------------------------------------- //
@@ -166,6 +246,7 @@ public:
 		TComponent::TYPE_ID = ComponentStorages.GetCount();
 		RPG_CheckV(TComponent::TYPE_ID >= 0 && TComponent::TYPE_ID < RPG_COMPONENT_TYPE_MAX_COUNT, "RpgWorld: Exceeds maximum component type count!");
 		ComponentStorages.AddValue(new RpgComponentStorage<TComponent>());
+		bSubsystemScheduleDirty = true;
 	}
 
 	template<typename TComponent>
@@ -196,6 +277,193 @@ public:
 private:
 	RpgArrayInline<RpgComponentStorageInterface*, RPG_COMPONENT_TYPE_MAX_COUNT> ComponentStorages;
 
+	// Incremented when component of the type is added/removed or its game object is destroyed
+	uint32_t ComponentVersions[RPG_COMPONENT_TYPE_MAX_COUNT];
+
+
+
+// --------------------------------------------------------------------------------------------------------------------------------------------- //
+// 	Query interface
+// --------------------------------------------------------------------------------------------------------------------------------------------- //
+public:
+	// Get components of all game objects that have every type of <TComponents...>. Rows are in storage order of the first type,
+	// put the rarest component type first. Matches are cached per type list and rebuilt on the next query after any of the types
+	// is added/removed. Game objects pending destroy are excluded. Thread-safe as long as no component is added/removed meanwhile.
+	template<typename... TComponents>
+	[[nodiscard]] inline RpgWorldQuery<TComponents...> Query() noexcept
+	{
+		return Query_Internal<TComponents...>();
+	}
+
+	template<typename... TComponents>
+	[[nodiscard]] inline RpgWorldQuery<TComponents...> Query() const noexcept
+	{
+		static_assert((std::is_const<TComponents>::value && ...), "RpgWorld: Query on const world requires const component types!");
+		return const_cast<RpgWorld*>(this)->Query_Internal<TComponents...>();
+	}
+
+
+private:
+	struct FQueryCache
+	{
+		// Component type IDs in query order
+		uint16_t TypeIds[RPG_COMPONENT_TYPE_MAX_COUNT];
+		int TypeCount;
+
+		// Sum of ComponentVersions of all types when the cache was built
+		uint64_t Version;
+
+		// Number of rows
+		int Count;
+
+		// Row-major component indices, TypeCount per row
+		RpgArray<int> ComponentIndices;
+	};
+
+
+	[[nodiscard]] FQueryCache& Query_FindOrAddCache(const uint16_t* typeIds, int typeCount) noexcept;
+
+
+	[[nodiscard]] inline uint64_t Query_GetVersion(const uint16_t* typeIds, int typeCount) const noexcept
+	{
+		uint64_t version = 0;
+
+		for (int t = 0; t < typeCount; ++t)
+		{
+			version += ComponentVersions[typeIds[t]];
+		}
+
+		return version;
+	}
+
+
+	template<typename TPrimaryComponent, typename... TOtherComponents>
+	inline RpgWorldQuery<TPrimaryComponent, TOtherComponents...> Query_Internal() noexcept
+	{
+		typedef std::remove_const_t<TPrimaryComponent> FPrimaryComponent;
+		constexpr int TYPE_COUNT = 1 + static_cast<int>(sizeof...(TOtherComponents));
+
+		const uint16_t typeIds[TYPE_COUNT] = { FPrimaryComponent::TYPE_ID, std::remove_const_t<TOtherComponents>::TYPE_ID... };
+		RpgComponentStorageInterface* storages[TYPE_COUNT];
+
+		for (int t = 0; t < TYPE_COUNT; ++t)
+		{
+			RPG_CheckV(typeIds[t] < ComponentStorages.GetCount(), "RpgWorld: Query component type has not been registered!");
+			storages[t] = ComponentStorages[typeIds[t]];
+		}
+
+		SDL_LockSpinlock(&QueryLock);
+
+		FQueryCache& cache = Query_FindOrAddCache(typeIds, TYPE_COUNT);
+		const uint64_t version = Query_GetVersion(typeIds, TYPE_COUNT);
+
+		if (cache.Version != version)
+		{
+			cache.Version = version;
+			cache.Count = 0;
+			cache.ComponentIndices.Clear();
+
+			for (auto it = Component_GetStorage<FPrimaryComponent>()->GetComponents().CreateConstIterator(); it; ++it)
+			{
+				const int gameObjectIndex = it.GetValue().GameObject.Index;
+
+				if (GameObjectStates[gameObjectIndex].Flags & FLAG_PendingDestroy)
+				{
+					continue;
+				}
+
+				const FGameObjectInfo& info = GameObjectInfos[gameObjectIndex];
+
+				bool bMatch = true;
+
+				for (int t = 1; t < TYPE_COUNT && bMatch; ++t)
+				{
+					bMatch = (info.ComponentIndices[typeIds[t]] != RPG_COMPONENT_ID_INVALID);
+				}
+
+				if (bMatch)
+				{
+					for (int t = 0; t < TYPE_COUNT; ++t)
+					{
+						cache.ComponentIndices.AddValue(info.ComponentIndices[typeIds[t]]);
+					}
+
+					++cache.Count;
+				}
+			}
+		}
+
+		SDL_UnlockSpinlock(&QueryLock);
+
+		return RpgWorldQuery<TPrimaryComponent, TOtherComponents...>(cache.ComponentIndices.GetData(), cache.Count, storages);
+	}
+
+
+private:
+	// Caches are never removed, addresses are stable
+	RpgFreeList<FQueryCache> QueryCaches;
+	SDL_SpinLock QueryLock;
+
+
+
+// --------------------------------------------------------------------------------------------------------------------------------------------- //
+// 	Command buffer interface
+// --------------------------------------------------------------------------------------------------------------------------------------------- //
+public:
+	// Get command buffer of calling thread to record deferred structural changes (see RpgWorldCommandBuffer.h).
+	// Can be called from main thread and thread pool worker threads. Recorded commands are played back in EndFrame
+	[[nodiscard]] RpgWorldCommandBuffer& CommandBuffer_Get() noexcept;
+
+
+private:
+	// [Main thread] Execute commands of all thread buffers ordered by (sort key, thread index, record order), then clear buffers
+	void CommandBuffer_Playback() noexcept;
+
+
+private:
+	// One per thread pool thread, indexed by RpgThreadPool::GetThreadIndex()
+	RpgArray<RpgWorldCommandBuffer*> CommandBuffers;
+
+
+
+// --------------------------------------------------------------------------------------------------------------------------------------------- //
+// 	Snapshot interface
+// --------------------------------------------------------------------------------------------------------------------------------------------- //
+public:
+	// Write game objects (except pending destroy) with their names, transforms, hierarchy and components into binary snapshot (see RpgWorldSnapshot.h).
+	// Only component types that specialize RpgComponentSnapshot are saved. Scripts are not saved
+	// @param out_Bytes - Snapshot data, previous content is replaced
+	// @param gameObjects - (Optional) Game objects to save, invalid ones are ignored. Parent that is not in the list is dropped. nullptr to save all game objects
+	// @param gameObjectCount - Number of <gameObjects>
+	// @param optOut_Assets - (Optional) Asset table that keeps the saved assets, so the snapshot can be loaded back with it without resolver
+	// @returns None
+	void Snapshot_Save(RpgArray<uint8_t>& out_Bytes, const RpgGameObjectID* gameObjects = nullptr, int gameObjectCount = 0, RpgWorldSnapshotAssetTable* optOut_Assets = nullptr) const noexcept;
+
+
+	// Snapshot_Save() into file
+	// @returns TRUE if file has been written
+	bool Snapshot_SaveToFile(const RpgFilePath& filePath) const noexcept;
+
+
+	// Create game objects and components from snapshot data. The data is validated first, nothing is created if it's invalid.
+	// Component blocks of types that are not registered or whose record size changed are skipped
+	// @param data - Snapshot data written by Snapshot_Save(), must be aligned to RPG_WORLD_SNAPSHOT_ALIGNMENT
+	// @param sizeBytes - Size of <data> in bytes
+	// @param assets - Asset table with resolvers set. Assets it already keeps are not resolved again
+	// @param optOut_GameObjects - (Optional) Created game objects in snapshot order
+	// @returns TRUE if loaded
+	bool Snapshot_Load(const uint8_t* data, size_t sizeBytes, RpgWorldSnapshotAssetTable& assets, RpgArray<RpgGameObjectID>* optOut_GameObjects = nullptr) noexcept;
+
+
+	// Read file and Snapshot_Load()
+	// @returns TRUE if loaded
+	bool Snapshot_LoadFromFile(const RpgFilePath& filePath, RpgWorldSnapshotAssetTable& assets, RpgArray<RpgGameObjectID>* optOut_GameObjects = nullptr) noexcept;
+
+
+private:
+	// Check header, block offsets and sizes, name and asset tables of snapshot data before anything is created
+	[[nodiscard]] bool Snapshot_Validate(const uint8_t* data, size_t sizeBytes) const noexcept;
+
 
 
 // --------------------------------------------------------------------------------------------------------------------------------------------- //
@@ -208,24 +476,45 @@ public:
 
 	[[nodiscard]] inline bool GameObject_IsValid(RpgGameObjectID gameObject) const noexcept
 	{
-		if (!gameObject.IsValid() || gameObject.World != this || !GameObjectInfos.IsValid(gameObject.Index))
+		if (!gameObject.IsValid() || gameObject.World != this || gameObject.Index >= GameObjectStates.GetCount())
 		{
 			return false;
 		}
 
-		const FGameObjectInfo& info = GameObjectInfos[gameObject.Index];
-		return info.Gen == gameObject.Gen && !(info.Flags & FLAG_PendingDestroy);
+		const FGameObjectState& state = GameObjectStates[gameObject.Index];
+		return state.Gen == gameObject.Gen && (state.Flags & (FLAG_Allocated | FLAG_PendingDestroy)) == FLAG_Allocated;
 	}
 
 
+	// Set world transform. If game object has parent, local transform is recomputed relative to current parent world transform.
+	// Children follow on the next hierarchy update (DispatchPostTickUpdate)
 	inline void GameObject_SetWorldTransform(RpgGameObjectID gameObject, const RpgTransform& worldTransform) noexcept
 	{
 		RPG_Check(GameObject_IsValid(gameObject));
 
 		FGameObjectTransform& transform = GameObjectTransforms[gameObject.Index];
 		transform.WorldMatrix = worldTransform.ToMatrixTransform();
+		transform.LocalMatrix = transform.Parent.IsValid() ? transform.WorldMatrix * GameObject_GetInverseWorldTransformMatrix(transform.Parent) : transform.WorldMatrix;
 
-		GameObjectInfos[gameObject.Index].Flags |= FLAG_TransformUpdated;
+		GameObject_MarkTransformUpdated(gameObject.Index);
+	}
+
+
+	// Set transform relative to parent (relative to world if game object has no parent).
+	// World transform of child game object is updated on the next hierarchy update (DispatchPostTickUpdate)
+	inline void GameObject_SetLocalTransform(RpgGameObjectID gameObject, const RpgTransform& localTransform) noexcept
+	{
+		RPG_Check(GameObject_IsValid(gameObject));
+
+		FGameObjectTransform& transform = GameObjectTransforms[gameObject.Index];
+		transform.LocalMatrix = localTransform.ToMatrixTransform();
+
+		if (!transform.Parent.IsValid())
+		{
+			transform.WorldMatrix = transform.LocalMatrix;
+		}
+
+		GameObject_MarkTransformUpdated(gameObject.Index);
 	}
 
 
@@ -254,6 +543,50 @@ public:
 	}
 
 
+	[[nodiscard]] inline const RpgMatrixTransform& GameObject_GetLocalTransformMatrix(RpgGameObjectID gameObject) const noexcept
+	{
+		RPG_Check(GameObject_IsValid(gameObject));
+		return GameObjectTransforms[gameObject.Index].LocalMatrix;
+	}
+
+
+	// Get inverse of world transform matrix. Computed on demand after world transform changed, do not call for the same game object from multiple threads
+	[[nodiscard]] inline const RpgMatrixTransform& GameObject_GetInverseWorldTransformMatrix(RpgGameObjectID gameObject) noexcept
+	{
+		RPG_Check(GameObject_IsValid(gameObject));
+
+		FGameObjectState& state = GameObjectStates[gameObject.Index];
+		FGameObjectTransform& transform = GameObjectTransforms[gameObject.Index];
+
+		if (state.Flags & FLAG_InverseWorldDirty)
+		{
+			transform.InverseWorldMatrix = transform.WorldMatrix.GetInverse();
+			state.Flags &= ~FLAG_InverseWorldDirty;
+		}
+
+		return transform.InverseWorldMatrix;
+	}
+
+
+	// Attach game object to parent. World transform of game object follows parent on each hierarchy update
+	// @param gameObject - Child game object
+	// @param parent - Parent game object. Must not be <gameObject> or any of its descendants
+	// @param bKeepWorldTransform - TRUE to keep current world transform (local transform is computed from it), FALSE to use current world transform as local transform
+	// @returns None
+	void GameObject_AttachToParent(RpgGameObjectID gameObject, RpgGameObjectID parent, bool bKeepWorldTransform = true) noexcept;
+
+
+	// Detach game object from its parent. Current world transform is kept
+	void GameObject_DetachFromParent(RpgGameObjectID gameObject) noexcept;
+
+
+	[[nodiscard]] inline RpgGameObjectID GameObject_GetParent(RpgGameObjectID gameObject) const noexcept
+	{
+		RPG_Check(GameObject_IsValid(gameObject));
+		return GameObjectTransforms[gameObject.Index].Parent;
+	}
+
+
 	template<typename TComponent>
 	inline TComponent* GameObject_AddComponent(RpgGameObjectID gameObject) noexcept
 	{
@@ -273,6 +606,7 @@ public:
 		auto storage = Component_GetStorage<TComponent>();
 		index = storage->Add();
 		info.ComponentIndices[TComponent::TYPE_ID] = index;
+		++ComponentVersions[TComponent::TYPE_ID];
 
 		TComponent& data = storage->Get(index);
 		data.GameObject = gameObject;
@@ -281,6 +615,16 @@ public:
 	}
 
 
+	// Get index of component in its storage
+	// @returns Component index or RPG_COMPONENT_ID_INVALID if game object does not have component type of <TComponent>
+	template<typename TComponent>
+	[[nodiscard]] inline int GameObject_GetComponentIndex(RpgGameObjectID gameObject) const noexcept
+	{
+		RPG_Check(GameObject_IsValid(gameObject));
+		return GameObjectInfos[gameObject.Index].ComponentIndices[TComponent::TYPE_ID];
+	}
+
+
 	template<typename TComponent>
 	inline void GameObject_RemoveComponent(RpgGameObjectID gameObject) noexcept
 	{
@@ -298,6 +642,7 @@ public:
 		storage->Remove(index);
 
 		info.ComponentIndices[TComponent::TYPE_ID] = RPG_COMPONENT_ID_INVALID;
+		++ComponentVersions[TComponent::TYPE_ID];
 	}
 
 
@@ -348,13 +693,13 @@ public:
 		RPG_Check(script);
 		const char* scriptTypeName = script->GetTypeName();
 
-		FGameObjectInfo& info = GameObjectInfos[gameObject.Index];
+		FGameObjectState& state = GameObjectStates[gameObject.Index];
 
 		int emptyIndex = RPG_INDEX_INVALID;
 
 		for (int i = 0; i < RPG_GAMEOBJECT_MAX_SCRIPT; ++i)
 		{
-			const int scriptIndex = info.ScriptIndices[i];
+			const int scriptIndex = state.ScriptIndices[i];
 
 			if (scriptIndex != RPG_INDEX_INVALID)
 			{
@@ -373,8 +718,9 @@ public:
 			scriptTypeName, RPG_GAMEOBJECT_MAX_SCRIPT
 		);
 
-		info.ScriptIndices[emptyIndex] = GameObjectScripts.GetCount();
-		GameObjectScripts.AddValue(script);
+		const int scriptIndex = GameObjectScripts.Add(script);
+		state.ScriptIndices[emptyIndex] = scriptIndex;
+		Script_AddToGroup(script);
 
 		script->World = this;
 		script->GameObject = gameObject;
@@ -385,7 +731,7 @@ public:
 		if (bHasStartedPlay && !script->bStartedPlay)
 		{
 			script->StartPlay();
-			script->bStartedPlay;
+			script->bStartedPlay = true;
 		}
 	}
 
@@ -398,11 +744,11 @@ public:
 		const char* scriptTypeName = script->GetTypeName();
 
 		RPG_Check(GameObject_IsValid(gameObject));
-		FGameObjectInfo& info = GameObjectInfos[gameObject.Index];
+		FGameObjectState& state = GameObjectStates[gameObject.Index];
 
 		for (int i = 0; i < RPG_GAMEOBJECT_MAX_SCRIPT; ++i)
 		{
-			const int scriptIndex = info.ScriptIndices[i];
+			const int scriptIndex = state.ScriptIndices[i];
 			if (scriptIndex == RPG_INDEX_INVALID)
 			{
 				continue;
@@ -412,7 +758,7 @@ public:
 			{
 				RPG_Check(GameObjectScripts[scriptIndex]->GetTypeName() == scriptTypeName);
 				GameObject_RemoveScriptAtIndex(scriptIndex);
-				info.ScriptIndices[i] = RPG_INDEX_INVALID;
+				state.ScriptIndices[i] = RPG_INDEX_INVALID;
 				RPG_Log(RpgLogWorld, "Detached script of type (%s) from game object (%s)", scriptTypeName, *GameObjectNames[gameObject.Index]);
 
 				return;
@@ -429,14 +775,98 @@ public:
 	}
 
 
+	// Get all game objects except pending destroy
+	// @param out_GameObjects - Game objects in slot order, previous content is replaced
+	// @returns None
+	inline void GameObject_GetAll(RpgArray<RpgGameObjectID>& out_GameObjects) const noexcept
+	{
+		out_GameObjects.Clear();
+		out_GameObjects.Reserve(GameObjectInfos.GetCount());
+
+		for (int i = 0; i < GameObjectStates.GetCount(); ++i)
+		{
+			const FGameObjectState& state = GameObjectStates[i];
+
+			if ((state.Flags & (FLAG_Allocated | FLAG_PendingDestroy)) == FLAG_Allocated)
+			{
+				out_GameObjects.AddValue(RpgGameObjectID(const_cast<RpgWorld*>(this), i, state.Gen));
+			}
+		}
+	}
+
+
+	[[nodiscard]] inline bool GameObject_HasScript(RpgGameObjectID gameObject) const noexcept
+	{
+		RPG_Check(GameObject_IsValid(gameObject));
+
+		const FGameObjectState& state = GameObjectStates[gameObject.Index];
+
+		for (int i = 0; i < RPG_GAMEOBJECT_MAX_SCRIPT; ++i)
+		{
+			if (state.ScriptIndices[i] != RPG_INDEX_INVALID)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+
 	[[nodiscard]] inline bool GameObject_IsTransformUpdated(RpgGameObjectID gameObject) const noexcept
 	{
 		RPG_Check(GameObject_IsValid(gameObject));
-		return GameObjectInfos[gameObject.Index].Flags & FLAG_TransformUpdated;
+		return GameObjectStates[gameObject.Index].Flags & FLAG_TransformUpdated;
+	}
+
+
+	// Game objects whose world transform changed this frame (created, moved, attached or moved by parent), each listed once.
+	// Complete after hierarchy update in DispatchPostTickUpdate, cleared on EndFrame. May contain game objects destroyed later in the frame, check GameObject_IsValid()
+	[[nodiscard]] inline const RpgArray<RpgGameObjectID>& GameObject_GetTransformUpdatedList() const noexcept
+	{
+		return TransformUpdatedObjects;
+	}
+
+
+	// Game objects created this frame. Cleared on EndFrame. May contain game objects destroyed later in the frame, check GameObject_IsValid()
+	[[nodiscard]] inline const RpgArray<RpgGameObjectID>& GameObject_GetCreatedList() const noexcept
+	{
+		return CreatedObjects;
+	}
+
+
+	// Game objects destroyed this frame. Their components are still alive until pending destroy is processed. Cleared on EndFrame
+	[[nodiscard]] inline const RpgArray<RpgGameObjectID>& GameObject_GetDestroyedList() const noexcept
+	{
+		return DestroyedObjects;
 	}
 
 
 private:
+	// Allocate game object slot with world transform. Caller logs and sets parent
+	[[nodiscard]] RpgGameObjectID GameObject_CreateInternal(const RpgName& name, const RpgMatrixTransform& worldMatrix) noexcept;
+
+	// Sort child game objects by hierarchy depth into HierarchyChildren. Detaches children of destroyed parents
+	void GameObject_RebuildHierarchy() noexcept;
+
+	// Propagate world transform from parents to children, one hierarchy level at a time. Children of the same level are updated in parallel
+	void GameObject_UpdateHierarchy() noexcept;
+
+
+	// Set FLAG_TransformUpdated and add game object to TransformUpdatedObjects if it's not there yet
+	inline void GameObject_MarkTransformUpdated(int index) noexcept
+	{
+		FGameObjectState& state = GameObjectStates[index];
+
+		if (!(state.Flags & FLAG_TransformUpdated))
+		{
+			TransformUpdatedObjects.AddValue(RpgGameObjectID(this, index, state.Gen));
+		}
+
+		state.Flags |= (FLAG_TransformUpdated | FLAG_InverseWorldDirty);
+	}
+
+
 	inline void GameObject_RemoveScriptAtIndex(int index) noexcept
 	{
 		RpgGameObjectScript* script = GameObjectScripts[index];
@@ -451,10 +881,85 @@ private:
 			script->StopPlay();
 		}
 
+		Script_RemoveFromGroup(script);
 		GameObjectScripts.RemoveAt(index);
 	}
 
 
+	// Add script to the group of its type. Creates the group on first script of the type.
+	// Queued while groups are being ticked, applied after the tick
+	inline void Script_AddToGroup(RpgGameObjectScript* script) noexcept
+	{
+		if (bDispatchingScriptTick)
+		{
+			PendingGroupAddScripts.AddValue(script);
+			return;
+		}
+
+		const char* scriptTypeName = script->GetTypeName();
+
+		// Batch function calls TickUpdate of the type that declared RPG_GAMEOBJECT_SCRIPT, override in subclass without the macro would never be called
+		const RpgGameObjectScript::FTickUpdateBatch tickUpdateBatch = script->GetTickUpdateBatch();
+		RPG_CheckV(tickUpdateBatch.ScriptType == nullptr || *tickUpdateBatch.ScriptType == typeid(*script),
+			"Script class (%s) derives from script type (%s) without RPG_GAMEOBJECT_SCRIPT!", typeid(*script).name(), scriptTypeName
+		);
+
+		for (int g = 0; g < ScriptGroups.GetCount(); ++g)
+		{
+			if (ScriptGroups[g].TypeName == scriptTypeName)
+			{
+				ScriptGroups[g].Scripts.AddValue(script);
+				return;
+			}
+		}
+
+		FScriptGroup& group = ScriptGroups.Add();
+		group.TypeName = scriptTypeName;
+		group.TickUpdateBatch = tickUpdateBatch;
+		group.Scripts.AddValue(script);
+
+		RPG_LogDebug(RpgLogWorld, "Create script group (%s), thread-safe: %i", scriptTypeName, group.TickUpdateBatch.bThreadSafe);
+	}
+
+
+	// Remove script from the group of its type.
+	// While groups are being ticked the slot is set to nullptr so the array being ticked is not shifted, the group is compacted after the tick
+	inline void Script_RemoveFromGroup(RpgGameObjectScript* script) noexcept
+	{
+		if (bDispatchingScriptTick && PendingGroupAddScripts.RemoveByValue(script))
+		{
+			return;
+		}
+
+		const char* scriptTypeName = script->GetTypeName();
+
+		for (int g = 0; g < ScriptGroups.GetCount(); ++g)
+		{
+			FScriptGroup& group = ScriptGroups[g];
+
+			if (group.TypeName == scriptTypeName)
+			{
+				if (bDispatchingScriptTick)
+				{
+					const int index = group.Scripts.FindIndexByValue(script);
+					RPG_Check(index != RPG_INDEX_INVALID);
+					group.Scripts[index] = nullptr;
+					group.bHasRemovedScript = true;
+				}
+				else
+				{
+					const bool bRemoved = group.Scripts.RemoveByValue(script);
+					RPG_Check(bRemoved);
+				}
+
+				return;
+			}
+		}
+
+		RPG_CheckV(0, "Script group (%s) not found!", scriptTypeName);
+	}
+
+
 private:
 	enum EGameObjectFlag : uint16_t
 	{
@@ -464,35 +969,93 @@ private:
 		FLAG_Loaded				= (1 << 2),
 		FLAG_PendingDestroy		= (1 << 3),
 		FLAG_TransformUpdated	= (1 << 4),
+		FLAG_InverseWorldDirty	= (1 << 5),
 	};
 
-	struct FGameObjectInfo
+	// Component table of game object, exactly one cache line. Only touched when components are looked up
+	struct alignas(RPG_CACHE_LINE_SIZE) FGameObjectInfo
 	{
 		// Component index for each type
-		uint16_t ComponentIndices[RPG_COMPONENT_TYPE_MAX_COUNT]{};
+		int ComponentIndices[RPG_COMPONENT_TYPE_MAX_COUNT]{};
+	};
+	static_assert(sizeof(FGameObjectInfo) == RPG_CACHE_LINE_SIZE, "RpgWorld: FGameObjectInfo must fit one cache line!");
 
-		// Generation number
-		uint16_t Gen{ 0 };
+	// Validation data of game object slot. Kept after the slot is freed so generation keeps counting up when the slot is reused
+	struct FGameObjectState
+	{
+		// Generation number, never RPG_GAMEOBJECT_GEN_INVALID once allocated
+		uint32_t Gen{ RPG_GAMEOBJECT_GEN_INVALID };
 
 		// Flags
 		uint16_t Flags{ 0 };
 
 		// Script indices
-		int16_t ScriptIndices[RPG_GAMEOBJECT_MAX_SCRIPT]{};
+		int ScriptIndices[RPG_GAMEOBJECT_MAX_SCRIPT]{};
 	};
 
 	struct FGameObjectTransform
 	{
+		// Relative to parent. Same as WorldMatrix if game object has no parent
 		RpgMatrixTransform LocalMatrix;
+
+		// LocalMatrix * parent WorldMatrix
 		RpgMatrixTransform WorldMatrix;
+
+		// Valid if FLAG_InverseWorldDirty is not set
 		RpgMatrixTransform InverseWorldMatrix;
+
 		RpgGameObjectID Parent;
 	};
 
 	RpgFreeList<RpgName> GameObjectNames;
 	RpgFreeList<FGameObjectInfo> GameObjectInfos;
+
+	// Indexed by game object index, never shrinks
+	RpgArray<FGameObjectState> GameObjectStates;
 	RpgFreeList<FGameObjectTransform> GameObjectTransforms;
 
-	RpgArray<RpgGameObjectScript*> GameObjectScripts;
+	// Indexed by FGameObjectState::ScriptIndices
+	RpgFreeList<RpgGameObjectScript*> GameObjectScripts;
+
+	// Scripts of the same type, ticked together
+	struct FScriptGroup
+	{
+		// Address of TYPE_NAME of the script type
+		const char* TypeName;
+
+		RpgGameObjectScript::FTickUpdateBatch TickUpdateBatch;
+
+		// In attach order. Removed script is nullptr until the group is compacted after tick
+		RpgArray<RpgGameObjectScript*> Scripts;
+
+		// TRUE if any script has been removed while ticking
+		bool bHasRemovedScript{ false };
+	};
+
+	// In order of first attached script of each type
+	RpgArray<FScriptGroup> ScriptGroups;
+
+	// Scripts attached while groups are being ticked, added to their groups after the tick
+	RpgArray<RpgGameObjectScript*> PendingGroupAddScripts;
+
+	// TRUE while DispatchTickUpdate is ticking script groups
+	bool bDispatchingScriptTick;
+
+	// Indices of game objects that have parent, sorted by hierarchy depth
+	RpgArray<int> HierarchyChildren;
+
+	// Range of HierarchyChildren for each depth. Depth D is in range [HierarchyLevelOffsets[D], HierarchyLevelOffsets[D + 1])
+	int HierarchyLevelOffsets[RPG_WORLD_MAX_HIERARCHY_DEPTH + 1];
+
+	// Deepest hierarchy depth
+	int HierarchyMaxDepth;
+
+	// TRUE if any parent has been attached/detached/destroyed since last rebuild
+	bool bHierarchyDirty;
+
+	// Per-frame change lists, cleared on EndFrame
+	RpgArray<RpgGameObjectID> TransformUpdatedObjects;
+	RpgArray<RpgGameObjectID> CreatedObjects;
+	RpgArray<RpgGameObjectID> DestroyedObjects;
 
 };
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "RpgWorld.h"
+#include "../RpgAllocator.h"
+
+
+
+// Deferred structural changes of RpgWorld (create/destroy game object, add/remove component, set world transform) recorded from worker threads.
+// Each thread owned by thread pool records into its own buffer, get it with RpgWorld::CommandBuffer_Get(). Recording does not lock.
+// Commands are played back on main thread in RpgWorld::EndFrame, ordered by sort key, then by thread index and record order.
+// Set unique sort key per source (e.g. index of game object that issues the commands) so playback order does not depend on which thread ran the task.
+// Payloads are allocated from frame arena, commands must be recorded and played back in the same frame.
+class RpgWorldCommandBuffer
+{
+	RPG_NOCOPY(RpgWorldCommandBuffer)
+
+public:
+	// Command target. Either existing game object or game object created by CreateGameObject() of the same buffer
+	struct FGameObjectRef
+	{
+	public:
+		FGameObjectRef(RpgGameObjectID in_GameObject) noexcept
+			: GameObject(in_GameObject)
+			, PendingIndex(RPG_INDEX_INVALID)
+		{
+		}
+
+	private:
+		FGameObjectRef(int in_PendingIndex) noexcept
+			: PendingIndex(in_PendingIndex)
+		{
+		}
+
+	private:
+		RpgGameObjectID GameObject;
+		int PendingIndex;
+
+		friend RpgWorldCommandBuffer;
+	};
+
+
+public:
+	RpgWorldCommandBuffer() noexcept
+	{
+		SortKey = 0;
+		PendingCount = 0;
+	}
+
+	~RpgWorldCommandBuffer() noexcept
+	{
+		Clear();
+	}
+
+
+	// Set sort key of commands recorded after this call. Commands that target pending game object always use sort key of its create command
+	inline void SetSortKey(uint64_t in_SortKey) noexcept
+	{
+		SortKey = in_SortKey;
+	}
+
+
+	// Record create game object
+	// @returns Reference to pending game object, can be used as target of subsequent commands of this buffer
+	inline FGameObjectRef CreateGameObject(const RpgName& name, const RpgTransform& worldTransform = RpgTransform()) noexcept
+	{
+		RPG_Assert(!name.IsEmpty());
+
+		const FGameObjectRef pending(PendingCount++);
+		PendingSortKeys.AddValue(SortKey);
+		AddCommand(pending, nullptr, AllocatePayload<FCreatePayload>(name, worldTransform));
+
+		return pending;
+	}
+
+
+	inline void DestroyGameObject(FGameObjectRef gameObject) noexcept
+	{
+		AddCommand(gameObject,
+			[](RpgWorld* world, RpgGameObjectID target, void* payload) noexcept
+			{
+				world->GameObject_Destroy(target);
+			},
+			nullptr
+		);
+	}
+
+
+	inline void SetWorldTransform(FGameObjectRef gameObject, const RpgTransform& worldTransform) noexcept
+	{
+		AddCommand(gameObject,
+			[](RpgWorld* world, RpgGameObjectID target, void* payload) noexcept
+			{
+				world->GameObject_SetWorldTransform(target, *static_cast<const RpgTransform*>(payload));
+			},
+			AllocatePayload<RpgTransform>(worldTransform)
+		);
+	}
+
+
+	template<typename TComponent>
+	inline void AddComponent(FGameObjectRef gameObject) noexcept
+	{
+		AddCommand(gameObject,
+			[](RpgWorld* world, RpgGameObjectID target, void* payload) noexcept
+			{
+				(void)world->GameObject_AddComponent<TComponent>(target);
+			},
+			nullptr
+		);
+	}
+
+
+	// Record add component, then call <initialize>(TComponent&) on playback. <initialize> is copied into the buffer
+	template<typename TComponent, typename TFunction>
+	inline void AddComponent(FGameObjectRef gameObject, TFunction&& initialize) noexcept
+	{
+		typedef std::remove_cvref_t<TFunction> FFunctionType;
+
+		AddCommand(gameObject,
+			[](RpgWorld* world, RpgGameObjectID target, void* payload) noexcept
+			{
+				TComponent* component = world->GameObject_AddComponent<TComponent>(target);
+				(*static_cast<FFunctionType*>(payload))(*component);
+			},
+			AllocatePayload<FFunctionType>(std::forward<TFunction>(initialize))
+		);
+	}
+
+
+	// Record remove component. Ignored on playback if game object does not have the component
+	template<typename TComponent>
+	inline void RemoveComponent(FGameObjectRef gameObject) noexcept
+	{
+		AddCommand(gameObject,
+			[](RpgWorld* world, RpgGameObjectID target, void* payload) noexcept
+			{
+				if (world->GameObject_GetComponentIndex<TComponent>(target) != RPG_COMPONENT_ID_INVALID)
+				{
+					world->GameObject_RemoveComponent<TComponent>(target);
+				}
+			},
+			nullptr
+		);
+	}
+
+
+	[[nodiscard]] inline int GetCommandCount() const noexcept
+	{
+		return Commands.GetCount();
+	}
+
+
+private:
+	// Execute command on <target>. Payload is released by the caller
+	typedef void (*FExecuteFunction)(RpgWorld* world, RpgGameObjectID target, void* payload) noexcept;
+	typedef void (*FReleaseFunction)(void* payload) noexcept;
+
+	struct FCreatePayload
+	{
+		RpgName Name;
+		RpgTransform WorldTransform;
+
+		FCreatePayload(const RpgName& in_Name, const RpgTransform& in_WorldTransform) noexcept
+			: Name(in_Name)
+			, WorldTransform(in_WorldTransform)
+		{
+		}
+	};
+
+	struct FCommand
+	{
+		uint64_t SortKey;
+
+		// Existing game object if TargetPendingIndex is RPG_INDEX_INVALID
+		RpgGameObjectID TargetGameObject;
+		int TargetPendingIndex;
+
+		// nullptr for create game object
+		FExecuteFunction Execute;
+
+		// nullptr if payload is trivially destructible
+		FReleaseFunction Release;
+
+		void* Payload;
+	};
+
+
+	template<typename TPayload, typename... TArgs>
+	inline TPayload* AllocatePayload(TArgs&&... args) noexcept
+	{
+		static_assert(alignof(TPayload) <= RPG_FRAME_ARENA_ALIGNMENT, "RpgWorldCommandBuffer: Payload alignment exceeds frame arena alignment!");
+		return new (RpgFrameArena::Allocate(sizeof(TPayload))) TPayload(std::forward<TArgs>(args)...);
+	}
+
+
+	template<typename TPayload>
+	inline void AddCommand(FGameObjectRef target, FExecuteFunction execute, TPayload* payload) noexcept
+	{
+		FCommand& command = AddCommand(target, execute, nullptr);
+		command.Payload = payload;
+
+		if constexpr (!std::is_trivially_destructible<TPayload>::value)
+		{
+			command.Release = [](void* data) noexcept
+			{
+				static_cast<TPayload*>(data)->~TPayload();
+			};
+		}
+	}
+
+
+	inline FCommand& AddCommand(FGameObjectRef target, FExecuteFunction execute, std::nullptr_t) noexcept
+	{
+		FCommand& command = Commands.Add();
+		command.SortKey = (target.PendingIndex != RPG_INDEX_INVALID) ? PendingSortKeys[target.PendingIndex] : SortKey;
+		command.TargetGameObject = target.GameObject;
+		command.TargetPendingIndex = target.PendingIndex;
+		command.Execute = execute;
+		command.Release = nullptr;
+		command.Payload = nullptr;
+
+		return command;
+	}
+
+
+	// Release payloads of commands that have not been played back
+	inline void Clear() noexcept
+	{
+		for (int i = 0; i < Commands.GetCount(); ++i)
+		{
+			if (Commands[i].Release)
+			{
+				Commands[i].Release(Commands[i].Payload);
+			}
+		}
+
+		Commands.Clear();
+		PendingSortKeys.Clear();
+		PendingCount = 0;
+	}
+
+
+private:
+	RpgArray<FCommand> Commands;
+
+	// Sort key of each pending game object
+	RpgArray<uint64_t> PendingSortKeys;
+	int PendingCount;
+
+	uint64_t SortKey;
+
+
+	friend RpgWorld;
+
+};
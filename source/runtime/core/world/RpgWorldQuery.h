@@ -0,0 +1,139 @@
+#pragma once
+
+#include "RpgComponent.h"
+#include <tuple>
+
+
+
+// Result of RpgWorld::Query<TComponents...>(). Each row holds the components of one game object that has all of <TComponents...>,
+// rows are in storage order of the first component type. Component indices of each row are resolved when the query cache is built,
+// iterating the rows does not touch game object infos.
+// Valid until any of <TComponents...> is added/removed or the owning game object is destroyed. Use const component types to query const world.
+template<typename... TComponents>
+class RpgWorldQuery
+{
+	static constexpr int TYPE_COUNT = static_cast<int>(sizeof...(TComponents));
+	static_assert(TYPE_COUNT > 0 && TYPE_COUNT <= RPG_COMPONENT_TYPE_MAX_COUNT, "RpgWorldQuery: Invalid number of component types!");
+
+	template<int TYPE_INDEX>
+	using TComponentAt = std::tuple_element_t<TYPE_INDEX, std::tuple<TComponents...>>;
+
+	template<int TYPE_INDEX>
+	using TStorageAt = RpgComponentStorage<std::remove_const_t<TComponentAt<TYPE_INDEX>>>;
+
+
+public:
+	RpgWorldQuery(const int* in_ComponentIndices, int in_Count, RpgComponentStorageInterface* const* in_Storages) noexcept
+		: ComponentIndices(in_ComponentIndices)
+		, Count(in_Count)
+	{
+		for (int t = 0; t < TYPE_COUNT; ++t)
+		{
+			Storages[t] = in_Storages[t];
+		}
+	}
+
+
+public:
+	[[nodiscard]] inline int GetCount() const noexcept
+	{
+		return Count;
+	}
+
+	[[nodiscard]] inline bool IsEmpty() const noexcept
+	{
+		return Count == 0;
+	}
+
+
+	// Get component of row
+	// @param index - Row index in range [0, GetCount())
+	// @returns Component reference
+	template<typename TComponent>
+	[[nodiscard]] inline TComponent& Get(int index) const noexcept
+	{
+		constexpr int typeIndex = FindTypeIndex<TComponent>();
+		static_assert(typeIndex != RPG_INDEX_INVALID, "RpgWorldQuery: Type of <TComponent> is not part of the query!");
+		RPG_Validate(index >= 0 && index < Count);
+
+		return GetStorage<typeIndex>()->Get(ComponentIndices[index * TYPE_COUNT + typeIndex]);
+	}
+
+
+	// Get index of component in its storage
+	// @param index - Row index in range [0, GetCount())
+	// @returns Component index
+	template<typename TComponent>
+	[[nodiscard]] inline int GetComponentIndex(int index) const noexcept
+	{
+		constexpr int typeIndex = FindTypeIndex<TComponent>();
+		static_assert(typeIndex != RPG_INDEX_INVALID, "RpgWorldQuery: Type of <TComponent> is not part of the query!");
+		RPG_Validate(index >= 0 && index < Count);
+
+		return ComponentIndices[index * TYPE_COUNT + typeIndex];
+	}
+
+
+	// Call <function>(TComponents&...) for each row in range [beginIndex, endIndex). Can be used as RpgThreadPool::ParallelFor chunk.
+	template<typename TFunction>
+	inline void ForEachRange(int beginIndex, int endIndex, TFunction&& function) const noexcept
+	{
+		RPG_Validate(beginIndex >= 0 && beginIndex <= endIndex && endIndex <= Count);
+		ForEachRangeInternal(beginIndex, endIndex, function, std::make_integer_sequence<int, TYPE_COUNT>());
+	}
+
+
+	// Call <function>(TComponents&...) for each row
+	template<typename TFunction>
+	inline void ForEach(TFunction&& function) const noexcept
+	{
+		ForEachRange(0, Count, function);
+	}
+
+
+private:
+	template<typename TComponent>
+	static constexpr int FindTypeIndex() noexcept
+	{
+		constexpr bool matches[] = { std::is_same<TComponent, TComponents>::value... };
+
+		for (int t = 0; t < TYPE_COUNT; ++t)
+		{
+			if (matches[t])
+			{
+				return t;
+			}
+		}
+
+		return RPG_INDEX_INVALID;
+	}
+
+
+	template<int TYPE_INDEX>
+	inline TStorageAt<TYPE_INDEX>* GetStorage() const noexcept
+	{
+		return static_cast<TStorageAt<TYPE_INDEX>*>(Storages[TYPE_INDEX]);
+	}
+
+
+	template<typename TFunction, int... TYPE_INDEX>
+	inline void ForEachRangeInternal(int beginIndex, int endIndex, TFunction& function, std::integer_sequence<int, TYPE_INDEX...>) const noexcept
+	{
+		const int* row = ComponentIndices + beginIndex * TYPE_COUNT;
+
+		for (int i = beginIndex; i < endIndex; ++i)
+		{
+			function(static_cast<TComponentAt<TYPE_INDEX>&>(GetStorage<TYPE_INDEX>()->Get(row[TYPE_INDEX]))...);
+			row += TYPE_COUNT;
+		}
+	}
+
+
+private:
+	// Row-major component indices, TYPE_COUNT per row in order of <TComponents...>
+	const int* ComponentIndices;
+	int Count;
+
+	RpgComponentStorageInterface* Storages[TYPE_COUNT];
+
+};
@@ -0,0 +1,695 @@
+#include "RpgWorld.h"
+#include "../RpgProfiler.h"
+
+
+
+namespace RpgWorldSnapshot
+{
+	// @returns TRUE if range [offset, offset + sizeBytes) is inside snapshot data of <dataSizeBytes>
+	static inline bool IsRangeValid(uint64_t offset, uint64_t sizeBytes, uint64_t dataSizeBytes) noexcept
+	{
+		return offset <= dataSizeBytes && sizeBytes <= dataSizeBytes - offset;
+	}
+
+
+	// @returns TRUE if block at <offset> of <sizeBytes> is aligned and inside snapshot data of <dataSizeBytes>
+	static inline bool IsBlockValid(uint64_t offset, uint64_t sizeBytes, uint64_t dataSizeBytes) noexcept
+	{
+		return (offset % RPG_WORLD_SNAPSHOT_ALIGNMENT) == 0 && IsRangeValid(offset, sizeBytes, dataSizeBytes);
+	}
+
+
+	static inline uint64_t AlignOffset(uint64_t offset) noexcept
+	{
+		return (offset + RPG_WORLD_SNAPSHOT_ALIGNMENT - 1) & ~static_cast<uint64_t>(RPG_WORLD_SNAPSHOT_ALIGNMENT - 1);
+	}
+
+
+	// Component records of one component type, collected before the data is laid out
+	struct FComponentBlock
+	{
+		RpgComponentStorageInterface* Storage;
+		uint32_t RecordSizeBytes;
+		RpgArray<int> GameObjectIndices;
+		RpgArray<uint8_t> Records;
+	};
+
+};
+
+
+
+void RpgWorld::Snapshot_Save(RpgArray<uint8_t>& out_Bytes, const RpgGameObjectID* gameObjects, int gameObjectCount, RpgWorldSnapshotAssetTable* optOut_Assets) const noexcept
+{
+	RPG_IsMainThread();
+
+	RPG_PROFILER_Scope("RpgWorld::Snapshot_Save");
+
+
+	// Snapshot index of each game object slot, game objects pending destroy are not saved
+	const int slotCount = GameObjectStates.GetCount();
+	RpgArray<int> gameObjectRemap(slotCount);
+
+	for (int i = 0; i < slotCount; ++i)
+	{
+		gameObjectRemap[i] = RPG_INDEX_INVALID;
+	}
+
+	RpgArray<int> gameObjectIndices;
+
+	if (gameObjects)
+	{
+		gameObjectIndices.Reserve(gameObjectCount);
+
+		for (int i = 0; i < gameObjectCount; ++i)
+		{
+			const RpgGameObjectID gameObject = gameObjects[i];
+
+			if (GameObject_IsValid(gameObject) && gameObjectRemap[gameObject.Index] == RPG_INDEX_INVALID)
+			{
+				gameObjectRemap[gameObject.Index] = gameObjectIndices.GetCount();
+				gameObjectIndices.AddValue(gameObject.Index);
+			}
+		}
+	}
+	else
+	{
+		gameObjectIndices.Reserve(GameObjectInfos.GetCount());
+
+		for (int i = 0; i < slotCount; ++i)
+		{
+			if ((GameObjectStates[i].Flags & (FLAG_Allocated | FLAG_PendingDestroy)) == FLAG_Allocated)
+			{
+				gameObjectRemap[i] = gameObjectIndices.GetCount();
+				gameObjectIndices.AddValue(i);
+			}
+		}
+	}
+
+	const int snapshotGameObjectCount = gameObjectIndices.GetCount();
+
+
+	// Names, each unique name is stored once
+	RpgMap<RpgName, int> nameIndices;
+	RpgArray<int> nameOffsets;
+	RpgArray<int> gameObjectNameIndices(snapshotGameObjectCount);
+	RpgArray<char> nameChars;
+
+	for (int i = 0; i < snapshotGameObjectCount; ++i)
+	{
+		const RpgName& name = GameObjectNames[gameObjectIndices[i]];
+
+		if (const int* existingIndex = nameIndices.GetValueByKey(name))
+		{
+			gameObjectNameIndices[i] = *existingIndex;
+			continue;
+		}
+
+		const int nameIndex = nameOffsets.GetCount();
+		nameIndices.Add(name) = nameIndex;
+		nameOffsets.AddValue(nameChars.GetCount());
+		gameObjectNameIndices[i] = nameIndex;
+
+		const int length = name.GetLength();
+		const int charOffset = nameChars.GetCount();
+		nameChars.Resize(charOffset + length + 1);
+		RpgPlatformMemory::MemCopy(nameChars.GetData(charOffset), name.GetData(), length);
+	}
+
+
+	// Components. Asset references are collected while records are written
+	RpgWorldSnapshotAssetTable localAssets;
+	RpgWorldSnapshotAssetTable& assets = optOut_Assets ? *optOut_Assets : localAssets;
+	assets.BeginSnapshot();
+
+	RpgArray<RpgWorldSnapshot::FComponentBlock> componentBlocks;
+
+	for (int t = 0; t < ComponentStorages.GetCount(); ++t)
+	{
+		RpgComponentStorageInterface* storage = ComponentStorages[t];
+
+		if (!storage->Snapshot_IsEnabled())
+		{
+			continue;
+		}
+
+		RpgWorldSnapshot::FComponentBlock& block = componentBlocks.Add();
+		block.Storage = storage;
+		block.RecordSizeBytes = storage->Snapshot_GetRecordSize();
+		storage->Snapshot_Save(block.GameObjectIndices, block.Records, gameObjectRemap.GetData(), assets);
+
+		if (block.GameObjectIndices.GetCount() == 0)
+		{
+			componentBlocks.RemoveAt(componentBlocks.GetCount() - 1);
+		}
+	}
+
+
+	// Layout
+	RpgWorldSnapshotHeader header;
+	header.Magix = RPG_WORLD_SNAPSHOT_MAGIX;
+	header.Version = RPG_WORLD_SNAPSHOT_VERSION;
+	header.ComponentBlockCount = static_cast<uint16_t>(componentBlocks.GetCount());
+	header.GameObjectCount = snapshotGameObjectCount;
+	header.AssetReferenceCount = assets.GetSnapshotReferenceCount();
+
+	uint64_t sizeBytes = sizeof(RpgWorldSnapshotHeader);
+
+	header.NameBlockOffset = RpgWorldSnapshot::AlignOffset(sizeBytes);
+	sizeBytes = header.NameBlockOffset + sizeof(int) * (2 + nameOffsets.GetCount() + snapshotGameObjectCount) + nameChars.GetCount();
+
+	header.TransformBlockOffset = RpgWorldSnapshot::AlignOffset(sizeBytes);
+	sizeBytes = header.TransformBlockOffset + (sizeof(RpgMatrixTransform) * 2 + sizeof(int)) * snapshotGameObjectCount;
+
+	header.ComponentBlockOffset = RpgWorldSnapshot::AlignOffset(sizeBytes);
+	sizeBytes = header.ComponentBlockOffset;
+
+	RpgArray<uint64_t> componentBlockOffsets(componentBlocks.GetCount());
+	RpgArray<uint64_t> componentRecordOffsets(componentBlocks.GetCount());
+
+	for (int b = 0; b < componentBlocks.GetCount(); ++b)
+	{
+		componentBlockOffsets[b] = RpgWorldSnapshot::AlignOffset(sizeBytes);
+		componentRecordOffsets[b] = RpgWorldSnapshot::AlignOffset(componentBlockOffsets[b] + sizeof(RpgWorldSnapshotComponentBlockHeader) + sizeof(int) * componentBlocks[b].GameObjectIndices.GetCount());
+		sizeBytes = componentRecordOffsets[b] + componentBlocks[b].Records.GetCount();
+	}
+
+	header.AssetTableOffset = RpgWorldSnapshot::AlignOffset(sizeBytes);
+	sizeBytes = header.AssetTableOffset;
+
+	for (int a = 0; a < header.AssetReferenceCount; ++a)
+	{
+		sizeBytes += sizeof(uint16_t) * 2 + assets.GetSnapshotReference(a).Name.GetLength() + 1;
+	}
+
+	header.SizeBytes = sizeBytes;
+
+	RPG_CheckV(sizeBytes <= static_cast<uint64_t>(INT32_MAX), "RpgWorld: Snapshot exceeds maximum size!");
+
+
+	// Write. Padding is zeroed by Resize
+	out_Bytes.Clear();
+	out_Bytes.Resize(static_cast<int>(sizeBytes));
+	uint8_t* data = out_Bytes.GetData();
+
+	auto WriteData = [data](uint64_t offset, const void* src, size_t srcSizeBytes) noexcept
+	{
+		if (srcSizeBytes > 0)
+		{
+			RpgPlatformMemory::MemCopy(data + offset, src, srcSizeBytes);
+		}
+
+		return offset + srcSizeBytes;
+	};
+
+	WriteData(0, &header, sizeof(RpgWorldSnapshotHeader));
+
+	{
+		const int nameCount = nameOffsets.GetCount();
+		const int nameCharsSizeBytes = nameChars.GetCount();
+
+		uint64_t offset = header.NameBlockOffset;
+		offset = WriteData(offset, &nameCount, sizeof(int));
+		offset = WriteData(offset, &nameCharsSizeBytes, sizeof(int));
+		offset = WriteData(offset, nameOffsets.GetData(), sizeof(int) * nameCount);
+		offset = WriteData(offset, gameObjectNameIndices.GetData(), sizeof(int) * snapshotGameObjectCount);
+		WriteData(offset, nameChars.GetData(), nameCharsSizeBytes);
+	}
+
+	{
+		RpgMatrixTransform* localMatrices = reinterpret_cast<RpgMatrixTransform*>(data + header.TransformBlockOffset);
+		RpgMatrixTransform* worldMatrices = localMatrices + snapshotGameObjectCount;
+		int* parentIndices = reinterpret_cast<int*>(worldMatrices + snapshotGameObjectCount);
+
+		for (int i = 0; i < snapshotGameObjectCount; ++i)
+		{
+			const FGameObjectTransform& transform = GameObjectTransforms[gameObjectIndices[i]];
+			const int parentIndex = GameObject_IsValid(transform.Parent) ? gameObjectRemap[transform.Parent.Index] : RPG_INDEX_INVALID;
+
+			// Parent that is not part of the snapshot is dropped, game object keeps its world transform
+			localMatrices[i] = (parentIndex != RPG_INDEX_INVALID) ? transform.LocalMatrix : transform.WorldMatrix;
+			worldMatrices[i] = transform.WorldMatrix;
+			parentIndices[i] = parentIndex;
+		}
+	}
+
+	for (int b = 0; b < componentBlocks.GetCount(); ++b)
+	{
+		const RpgWorldSnapshot::FComponentBlock& block = componentBlocks[b];
+
+		RpgWorldSnapshotComponentBlockHeader blockHeader;
+		const char* typeName = block.Storage->GetTypeName();
+		const int typeNameLength = RpgPlatformMemory::CStringLength(typeName);
+		RPG_CheckV(typeNameLength < RPG_WORLD_SNAPSHOT_TYPE_NAME_LENGTH, "RpgWorld: Component type name (%s) exceeds snapshot type name length!", typeName);
+		RpgPlatformMemory::MemCopy(blockHeader.TypeName, typeName, typeNameLength);
+		blockHeader.RecordSizeBytes = block.RecordSizeBytes;
+		blockHeader.Count = block.GameObjectIndices.GetCount();
+		blockHeader.RecordOffset = componentRecordOffsets[b];
+		blockHeader.NextBlockOffset = (b + 1 < componentBlocks.GetCount()) ? componentBlockOffsets[b + 1] : 0;
+
+		uint64_t offset = componentBlockOffsets[b];
+		offset = WriteData(offset, &blockHeader, sizeof(RpgWorldSnapshotComponentBlockHeader));
+		WriteData(offset, block.GameObjectIndices.GetData(), sizeof(int) * blockHeader.Count);
+		WriteData(blockHeader.RecordOffset, block.Records.GetData(), block.Records.GetCount());
+	}
+
+	{
+		uint64_t offset = header.AssetTableOffset;
+
+		for (int a = 0; a < header.AssetReferenceCount; ++a)
+		{
+			const RpgName& name = assets.GetSnapshotReference(a).Name;
+			const uint16_t type = static_cast<uint16_t>(assets.GetSnapshotReference(a).Type);
+			const uint16_t nameLength = static_cast<uint16_t>(name.GetLength());
+
+			offset = WriteData(offset, &type, sizeof(uint16_t));
+			offset = WriteData(offset, &nameLength, sizeof(uint16_t));
+			offset = WriteData(offset, name.GetData(), nameLength + 1);
+		}
+
+		RPG_Check(offset == sizeBytes);
+	}
+
+	RPG_Log(RpgLogWorld, "Saved world (%s) snapshot. GameObjects: %i, ComponentBlocks: %i, AssetReferences: %i, SizeBytes: %llu",
+		*Name, snapshotGameObjectCount, componentBlocks.GetCount(), header.AssetReferenceCount, sizeBytes
+	);
+}
+
+
+bool RpgWorld::Snapshot_SaveToFile(const RpgFilePath& filePath) const noexcept
+{
+	RpgArray<uint8_t> bytes;
+	Snapshot_Save(bytes);
+
+	return RpgPlatformFile::File_Write(*filePath, bytes.GetData(), bytes.GetCount());
+}
+
+
+bool RpgWorld::Snapshot_Validate(const uint8_t* data, size_t sizeBytes) const noexcept
+{
+	if (data == nullptr || (reinterpret_cast<uintptr_t>(data) % RPG_WORLD_SNAPSHOT_ALIGNMENT) != 0)
+	{
+		RPG_LogError(RpgLogWorld, "Invalid snapshot. Data must be aligned to %i bytes!", RPG_WORLD_SNAPSHOT_ALIGNMENT);
+		return false;
+	}
+
+	if (sizeBytes < sizeof(RpgWorldSnapshotHeader))
+	{
+		RPG_LogError(RpgLogWorld, "Invalid snapshot. Data is smaller than header!");
+		return false;
+	}
+
+	const RpgWorldSnapshotHeader& header = *reinterpret_cast<const RpgWorldSnapshotHeader*>(data);
+
+	if (header.Magix != RPG_WORLD_SNAPSHOT_MAGIX || header.SizeBytes != sizeBytes)
+	{
+		RPG_LogError(RpgLogWorld, "Invalid snapshot. Magic number or size does not match!");
+		return false;
+	}
+
+	if (header.Version != RPG_WORLD_SNAPSHOT_VERSION)
+	{
+		RPG_LogError(RpgLogWorld, "Invalid snapshot. Version %u does not match current version %u!", header.Version, RPG_WORLD_SNAPSHOT_VERSION);
+		return false;
+	}
+
+	const int gameObjectCount = header.GameObjectCount;
+
+	if (gameObjectCount < 0 || header.AssetReferenceCount < 0 || GameObjectNames.GetCount() + static_cast<int64_t>(gameObjectCount) > RPG_WORLD_MAX_GAMEOBJECT)
+	{
+		RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid game object count %i!", gameObjectCount);
+		return false;
+	}
+
+
+	// Names
+	{
+		if (!RpgWorldSnapshot::IsBlockValid(header.NameBlockOffset, sizeof(int) * 2, sizeBytes))
+		{
+			RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid name block!");
+			return false;
+		}
+
+		const int* nameBlock = reinterpret_cast<const int*>(data + header.NameBlockOffset);
+		const int nameCount = nameBlock[0];
+		const int nameCharsSizeBytes = nameBlock[1];
+
+		if (nameCount < 0 || nameCharsSizeBytes < 0 || (gameObjectCount > 0 && (nameCount == 0 || nameCharsSizeBytes == 0)) ||
+			!RpgWorldSnapshot::IsRangeValid(header.NameBlockOffset, sizeof(int) * (2 + static_cast<uint64_t>(nameCount) + gameObjectCount) + nameCharsSizeBytes, sizeBytes))
+		{
+			RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid name block!");
+			return false;
+		}
+
+		const int* nameOffsets = nameBlock + 2;
+		const int* gameObjectNameIndices = nameOffsets + nameCount;
+		const char* nameChars = reinterpret_cast<const char*>(gameObjectNameIndices + gameObjectCount);
+
+		if (nameCharsSizeBytes > 0 && nameChars[nameCharsSizeBytes - 1] != '\0')
+		{
+			RPG_LogError(RpgLogWorld, "Invalid snapshot. Name is not null terminated!");
+			return false;
+		}
+
+		for (int n = 0; n < nameCount; ++n)
+		{
+			if (nameOffsets[n] < 0 || nameOffsets[n] >= nameCharsSizeBytes || nameChars[nameOffsets[n]] == '\0')
+			{
+				RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid name at index %i!", n);
+				return false;
+			}
+		}
+
+		for (int i = 0; i < gameObjectCount; ++i)
+		{
+			if (gameObjectNameIndices[i] < 0 || gameObjectNameIndices[i] >= nameCount)
+			{
+				RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid name index of game object %i!", i);
+				return false;
+			}
+		}
+	}
+
+
+	// Transforms and hierarchy
+	{
+		if (!RpgWorldSnapshot::IsBlockValid(header.TransformBlockOffset, (sizeof(RpgMatrixTransform) * 2 + sizeof(int)) * static_cast<uint64_t>(gameObjectCount), sizeBytes))
+		{
+			RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid transform block!");
+			return false;
+		}
+
+		const int* parentIndices = reinterpret_cast<const int*>(data + header.TransformBlockOffset + sizeof(RpgMatrixTransform) * 2 * gameObjectCount);
+
+		for (int i = 0; i < gameObjectCount; ++i)
+		{
+			// Walk up the parent chain, detects out of range index and cycles
+			int parentIndex = parentIndices[i];
+			int depth = 0;
+
+			while (parentIndex != RPG_INDEX_INVALID)
+			{
+				if (parentIndex < 0 || parentIndex >= gameObjectCount || parentIndex == i || ++depth >= RPG_WORLD_MAX_HIERARCHY_DEPTH)
+				{
+					RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid parent of game object %i!", i);
+					return false;
+				}
+
+				parentIndex = parentIndices[parentIndex];
+			}
+		}
+	}
+
+
+	// Components
+	{
+		RpgArray<uint8_t> hasComponent(gameObjectCount);
+		uint64_t blockOffset = header.ComponentBlockOffset;
+
+		for (int b = 0; b < header.ComponentBlockCount; ++b)
+		{
+			if (!RpgWorldSnapshot::IsBlockValid(blockOffset, sizeof(RpgWorldSnapshotComponentBlockHeader), sizeBytes))
+			{
+				RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid component block %i!", b);
+				return false;
+			}
+
+			const RpgWorldSnapshotComponentBlockHeader& blockHeader = *reinterpret_cast<const RpgWorldSnapshotComponentBlockHeader*>(data + blockOffset);
+
+			if (blockHeader.TypeName[RPG_WORLD_SNAPSHOT_TYPE_NAME_LENGTH - 1] != '\0' || blockHeader.Count < 0 || blockHeader.RecordSizeBytes == 0 ||
+				!RpgWorldSnapshot::IsRangeValid(blockOffset + sizeof(RpgWorldSnapshotComponentBlockHeader), sizeof(int) * static_cast<uint64_t>(blockHeader.Count), sizeBytes) ||
+				!RpgWorldSnapshot::IsBlockValid(blockHeader.RecordOffset, static_cast<uint64_t>(blockHeader.RecordSizeBytes) * blockHeader.Count, sizeBytes))
+			{
+				RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid component block %i!", b);
+				return false;
+			}
+
+			const int* recordGameObjectIndices = reinterpret_cast<const int*>(data + blockOffset + sizeof(RpgWorldSnapshotComponentBlockHeader));
+			RpgPlatformMemory::MemZero(hasComponent.GetData(), hasComponent.GetCount());
+
+			for (int r = 0; r < blockHeader.Count; ++r)
+			{
+				const int gameObjectIndex = recordGameObjectIndices[r];
+
+				if (gameObjectIndex < 0 || gameObjectIndex >= gameObjectCount || hasComponent[gameObjectIndex])
+				{
+					RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid game object index of component (%s) record %i!", blockHeader.TypeName, r);
+					return false;
+				}
+
+				hasComponent[gameObjectIndex] = 1;
+			}
+
+			blockOffset = blockHeader.NextBlockOffset;
+		}
+	}
+
+
+	// Asset table
+	{
+		uint64_t offset = header.AssetTableOffset;
+
+		for (int a = 0; a < header.AssetReferenceCount; ++a)
+		{
+			uint16_t assetType = 0;
+			uint16_t nameLength = 0;
+
+			if (RpgWorldSnapshot::IsRangeValid(offset, sizeof(uint16_t) * 2, sizeBytes))
+			{
+				RpgPlatformMemory::MemCopy(&assetType, data + offset, sizeof(uint16_t));
+				RpgPlatformMemory::MemCopy(&nameLength, data + offset + sizeof(uint16_t), sizeof(uint16_t));
+				offset += sizeof(uint16_t) * 2;
+			}
+
+			if (assetType >= static_cast<uint16_t>(RpgAssetFileType::MAX_COUNT) || nameLength == 0 ||
+				!RpgWorldSnapshot::IsRangeValid(offset, nameLength + 1, sizeBytes) || data[offset + nameLength] != '\0')
+			{
+				RPG_LogError(RpgLogWorld, "Invalid snapshot. Invalid asset reference %i!", a);
+				return false;
+			}
+
+			offset += nameLength + 1;
+		}
+	}
+
+	return true;
+}
+
+
+bool RpgWorld::Snapshot_Load(const uint8_t* data, size_t sizeBytes, RpgWorldSnapshotAssetTable& assets, RpgArray<RpgGameObjectID>* optOut_GameObjects) noexcept
+{
+	RPG_IsMainThread();
+
+	RPG_PROFILER_Scope("RpgWorld::Snapshot_Load");
+
+	if (!Snapshot_Validate(data, sizeBytes))
+	{
+		return false;
+	}
+
+	const RpgWorldSnapshotHeader& header = *reinterpret_cast<const RpgWorldSnapshotHeader*>(data);
+	const int gameObjectCount = header.GameObjectCount;
+
+
+	// Asset table. Reference index is the index in the table of the snapshot
+	assets.BeginSnapshot();
+	{
+		uint64_t offset = header.AssetTableOffset;
+
+		for (int a = 0; a < header.AssetReferenceCount; ++a)
+		{
+			uint16_t assetType;
+			uint16_t nameLength;
+			RpgPlatformMemory::MemCopy(&assetType, data + offset, sizeof(uint16_t));
+			RpgPlatformMemory::MemCopy(&nameLength, data + offset + sizeof(uint16_t), sizeof(uint16_t));
+			offset += sizeof(uint16_t) * 2;
+
+			assets.AddSnapshotReference(static_cast<RpgAssetFileType>(assetType), RpgName(reinterpret_cast<const char*>(data + offset)));
+			offset += nameLength + 1;
+		}
+	}
+
+
+	// Names. Each unique name is interned once
+	const int* nameBlock = reinterpret_cast<const int*>(data + header.NameBlockOffset);
+	const int nameCount = nameBlock[0];
+	const int* nameOffsets = nameBlock + 2;
+	const int* gameObjectNameIndices = nameOffsets + nameCount;
+	const char* nameChars = reinterpret_cast<const char*>(gameObjectNameIndices + gameObjectCount);
+
+	RpgArray<RpgName> names(nameCount);
+
+	for (int n = 0; n < nameCount; ++n)
+	{
+		names[n] = nameChars + nameOffsets[n];
+	}
+
+
+	// Game objects. Slots of all game objects are allocated at once, then names, transforms and states are written in one pass.
+	// Snapshot stores local and world matrices as separate blocks while runtime interleaves them per game object, so the blocks are not copied with MemCopy
+	const RpgMatrixTransform* localMatrices = reinterpret_cast<const RpgMatrixTransform*>(data + header.TransformBlockOffset);
+	const RpgMatrixTransform* worldMatrices = localMatrices + gameObjectCount;
+	const int* parentIndices = reinterpret_cast<const int*>(worldMatrices + gameObjectCount);
+
+	RPG_Check(GameObjectNames.GetCount() + gameObjectCount <= RPG_WORLD_MAX_GAMEOBJECT);
+
+	RpgArray<int> slotIndices(gameObjectCount);
+	RpgArray<int> infoSlotIndices(gameObjectCount);
+	RpgArray<int> transformSlotIndices(gameObjectCount);
+	GameObjectNames.AddRange(gameObjectCount, slotIndices.GetData());
+	GameObjectInfos.AddRange(gameObjectCount, infoSlotIndices.GetData());
+	GameObjectTransforms.AddRange(gameObjectCount, transformSlotIndices.GetData());
+
+	GameObjectStates.Reserve(GameObjectNames.GetCapacity());
+	TransformUpdatedObjects.Reserve(TransformUpdatedObjects.GetCount() + gameObjectCount);
+	CreatedObjects.Reserve(CreatedObjects.GetCount() + gameObjectCount);
+
+	RpgArray<RpgGameObjectID> gameObjects(gameObjectCount);
+
+	for (int i = 0; i < gameObjectCount; ++i)
+	{
+		const int index = slotIndices[i];
+		RPG_Check(infoSlotIndices[i] == index && transformSlotIndices[i] == index);
+
+		GameObjectNames[index] = names[gameObjectNameIndices[i]];
+		RpgPlatformMemory::MemSet(GameObjectInfos[index].ComponentIndices, RPG_COMPONENT_ID_INVALID, sizeof(int) * RPG_COMPONENT_TYPE_MAX_COUNT);
+
+		// Reused free slots already have a state, appended slots come in ascending order
+		if (index == GameObjectStates.GetCount())
+		{
+			GameObjectStates.AddValue(FGameObjectState());
+		}
+
+		FGameObjectState& state = GameObjectStates[index];
+		RPG_Check(state.Flags == FLAG_None);
+
+		if (++state.Gen == RPG_GAMEOBJECT_GEN_INVALID)
+		{
+			++state.Gen;
+		}
+
+		// Inverse is computed on demand
+		state.Flags = (FLAG_Allocated | FLAG_TransformUpdated | FLAG_InverseWorldDirty);
+		RpgPlatformMemory::MemSet(state.ScriptIndices, RPG_INDEX_INVALID, sizeof(int) * RPG_GAMEOBJECT_MAX_SCRIPT);
+
+		FGameObjectTransform& transform = GameObjectTransforms[index];
+		transform.WorldMatrix = worldMatrices[i];
+		transform.LocalMatrix = (parentIndices[i] != RPG_INDEX_INVALID) ? localMatrices[i] : worldMatrices[i];
+		transform.Parent = RpgGameObjectID();
+
+		gameObjects[i] = RpgGameObjectID(this, index, state.Gen);
+	}
+
+	TransformUpdatedObjects.InsertAtRange(gameObjects.GetData(), gameObjectCount, RPG_INDEX_LAST);
+	CreatedObjects.InsertAtRange(gameObjects.GetData(), gameObjectCount, RPG_INDEX_LAST);
+
+	// Parent may be stored after its child
+	for (int i = 0; i < gameObjectCount; ++i)
+	{
+		if (parentIndices[i] != RPG_INDEX_INVALID)
+		{
+			GameObjectTransforms[gameObjects[i].Index].Parent = gameObjects[parentIndices[i]];
+			bHierarchyDirty = true;
+		}
+	}
+
+
+	// Components. Records are read in place from <data>
+	RpgArray<RpgGameObjectID> componentGameObjects;
+	RpgArray<int> componentIndices;
+	uint64_t blockOffset = header.ComponentBlockOffset;
+
+	for (int b = 0; b < header.ComponentBlockCount; ++b)
+	{
+		const RpgWorldSnapshotComponentBlockHeader& blockHeader = *reinterpret_cast<const RpgWorldSnapshotComponentBlockHeader*>(data + blockOffset);
+		const int* recordGameObjectIndices = reinterpret_cast<const int*>(data + blockOffset + sizeof(RpgWorldSnapshotComponentBlockHeader));
+		blockOffset = blockHeader.NextBlockOffset;
+
+		int typeId = RPG_INDEX_INVALID;
+
+		for (int t = 0; t < ComponentStorages.GetCount(); ++t)
+		{
+			if (RpgPlatformMemory::CStringCompare(ComponentStorages[t]->GetTypeName(), blockHeader.TypeName, false))
+			{
+				typeId = t;
+				break;
+			}
+		}
+
+		if (typeId == RPG_INDEX_INVALID)
+		{
+			RPG_LogWarn(RpgLogWorld, "Skip snapshot component block (%s). Component type is not registered!", blockHeader.TypeName);
+			continue;
+		}
+
+		RpgComponentStorageInterface* storage = ComponentStorages[typeId];
+
+		if (!storage->Snapshot_IsEnabled() || storage->Snapshot_GetRecordSize() != blockHeader.RecordSizeBytes)
+		{
+			RPG_LogWarn(RpgLogWorld, "Skip snapshot component block (%s). Record size %u does not match current record size %u!",
+				blockHeader.TypeName, blockHeader.RecordSizeBytes, storage->Snapshot_GetRecordSize()
+			);
+			continue;
+		}
+
+		const int count = blockHeader.Count;
+		componentGameObjects.Resize(count);
+		componentIndices.Resize(count);
+
+		for (int r = 0; r < count; ++r)
+		{
+			componentGameObjects[r] = gameObjects[recordGameObjectIndices[r]];
+		}
+
+		storage->Snapshot_Load(componentGameObjects.GetData(), data + blockHeader.RecordOffset, count, componentIndices.GetData(), assets);
+
+		for (int r = 0; r < count; ++r)
+		{
+			GameObjectInfos[componentGameObjects[r].Index].ComponentIndices[typeId] = componentIndices[r];
+		}
+
+		++ComponentVersions[typeId];
+	}
+
+
+	for (int a = 0; a < assets.GetSnapshotReferenceCount(); ++a)
+	{
+		const RpgWorldSnapshotAssetTable::FReference& reference = assets.GetSnapshotReference(a);
+
+		if (reference.bUnresolved)
+		{
+			RPG_LogWarn(RpgLogWorld, "Snapshot asset reference (%s) cannot be resolved!", *reference.Name);
+		}
+	}
+
+	RPG_Log(RpgLogWorld, "Loaded world (%s) snapshot. GameObjects: %i, ComponentBlocks: %i, AssetReferences: %i",
+		*Name, gameObjectCount, header.ComponentBlockCount, header.AssetReferenceCount
+	);
+
+	if (optOut_GameObjects)
+	{
+		*optOut_GameObjects = std::move(gameObjects);
+	}
+
+	return true;
+}
+
+
+bool RpgWorld::Snapshot_LoadFromFile(const RpgFilePath& filePath, RpgWorldSnapshotAssetTable& assets, RpgArray<RpgGameObjectID>* optOut_GameObjects) noexcept
+{
+	const int64_t sizeBytes = RpgPlatformFile::File_GetSize(*filePath);
+
+	if (sizeBytes < static_cast<int64_t>(sizeof(RpgWorldSnapshotHeader)) || sizeBytes > INT32_MAX)
+	{
+		RPG_LogError(RpgLogWorld, "Load world snapshot from file (%s) failed. Invalid file size!", *filePath);
+		return false;
+	}
+
+	RpgArray<uint8_t> bytes(static_cast<int>(sizeBytes));
+
+	if (!RpgPlatformFile::File_Read(*filePath, bytes.GetData(), bytes.GetCount()))
+	{
+		return false;
+	}
+
+	return Snapshot_Load(bytes.GetData(), bytes.GetCount(), assets, optOut_GameObjects);
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "../RpgAssetFile.h"
+#include "../dsa/RpgMap.h"
+
+
+// Magic number for world snapshot header
+#define RPG_WORLD_SNAPSHOT_MAGIX				0x57475052 // (RPGW)
+
+// World snapshot version. Bump when layout of header, blocks or any component record changes
+#define RPG_WORLD_SNAPSHOT_VERSION				1
+
+// Alignment of each block in snapshot data. Blocks are read in place, records must not require larger alignment
+#define RPG_WORLD_SNAPSHOT_ALIGNMENT			16
+
+// Maximum length of component type name stored in component block header (including null terminator)
+#define RPG_WORLD_SNAPSHOT_TYPE_NAME_LENGTH		64
+
+
+
+// Snapshot data layout (see RpgWorld::Snapshot_Save). All offsets are relative to the start of the data and aligned to RPG_WORLD_SNAPSHOT_ALIGNMENT.
+//
+//	[Header]
+//	[Name block]		int NameCount, int NameCharsSizeBytes, int NameOffsets[NameCount], int GameObjectNameIndices[GameObjectCount], char NameChars[NameCharsSizeBytes] (null terminated)
+//	[Transform block]	RpgMatrixTransform LocalMatrices[GameObjectCount], RpgMatrixTransform WorldMatrices[GameObjectCount], int ParentIndices[GameObjectCount] (RPG_INDEX_INVALID if no parent)
+//	[Component blocks]	ComponentBlockCount x ([RpgWorldSnapshotComponentBlockHeader], int GameObjectIndices[Count], FRecord Records[Count])
+//	[Asset table]		AssetReferenceCount x (uint16_t Type, uint16_t NameLength, char Name[NameLength + 1])
+struct RpgWorldSnapshotHeader
+{
+	uint32_t Magix{ 0 };
+	uint16_t Version{ 0 };
+	uint16_t ComponentBlockCount{ 0 };
+	uint64_t SizeBytes{ 0 };
+
+	int GameObjectCount{ 0 };
+	int AssetReferenceCount{ 0 };
+
+	uint64_t NameBlockOffset{ 0 };
+	uint64_t TransformBlockOffset{ 0 };
+	uint64_t ComponentBlockOffset{ 0 };
+	uint64_t AssetTableOffset{ 0 };
+};
+
+
+struct RpgWorldSnapshotComponentBlockHeader
+{
+	char TypeName[RPG_WORLD_SNAPSHOT_TYPE_NAME_LENGTH]{};
+
+	// Size of one record. Block is skipped on load if it does not match current record size of the type
+	uint32_t RecordSizeBytes{ 0 };
+
+	// Number of records
+	int Count{ 0 };
+
+	// Offset of records, relative to the start of the data
+	uint64_t RecordOffset{ 0 };
+
+	// Offset of the next component block, relative to the start of the data
+	uint64_t NextBlockOffset{ 0 };
+};
+
+
+
+// Shared asset references of world snapshot. Component records store index into the asset table of the snapshot instead of the asset pointer.
+// Save: component snapshot adds the asset with AddReference(), each asset (type, name) is stored once per snapshot.
+// Load: component snapshot gets the asset with Resolve(). Asset that is not in this table yet is resolved with the resolver set for its type.
+// Each asset is resolved once and kept by this table, so the same table can be used to load many snapshots (e.g. streaming cells)
+// and snapshots saved with this table can be loaded back with it without resolver.
+class RpgWorldSnapshotAssetTable
+{
+	RPG_NOCOPY(RpgWorldSnapshotAssetTable)
+
+public:
+	// Find shared asset by name. Returns empty pointer if not found
+	template<typename TSharedAsset>
+	using TResolveFunction = TSharedAsset(*)(const RpgName& name) noexcept;
+
+
+public:
+	RpgWorldSnapshotAssetTable() noexcept
+	{
+		RpgPlatformMemory::MemZero(Resolvers, sizeof(Resolvers));
+	}
+
+	~RpgWorldSnapshotAssetTable() noexcept
+	{
+		Clear();
+	}
+
+
+	// [Save] Add reference to shared asset. The asset is kept by this table
+	// @param type - Asset type
+	// @param asset - Shared asset, must have GetName()
+	// @returns Reference index in the snapshot, RPG_INDEX_INVALID if <asset> is empty
+	template<typename TSharedAsset>
+	[[nodiscard]] inline int AddReference(RpgAssetFileType type, const TSharedAsset& asset) noexcept
+	{
+		if (!asset)
+		{
+			return RPG_INDEX_INVALID;
+		}
+
+		const int referenceIndex = FindOrAddReference(type, asset->GetName());
+		FReference& reference = References[referenceIndex];
+
+		if (reference.Resolved == nullptr)
+		{
+			SetResolved(reference, new TSharedAsset(asset));
+		}
+
+		if (reference.SnapshotIndex == RPG_INDEX_INVALID)
+		{
+			reference.SnapshotIndex = SnapshotReferences.GetCount();
+			SnapshotReferences.AddValue(referenceIndex);
+		}
+
+		return reference.SnapshotIndex;
+	}
+
+
+	// [Load] Set function that resolves references of asset <type>. References of type without resolver are loaded as empty pointer
+	template<typename TSharedAsset>
+	inline void SetResolver(RpgAssetFileType type, TResolveFunction<TSharedAsset> resolve) noexcept
+	{
+		Resolvers[static_cast<int>(type)] = reinterpret_cast<FGenericFunction>(resolve);
+	}
+
+
+	// [Load] Get shared asset of reference
+	// @param type - Asset type, must match the type the reference has been added with
+	// @param snapshotIndex - Reference index returned by AddReference() on save
+	// @returns Shared asset, empty if <snapshotIndex> is RPG_INDEX_INVALID, out of range, has different type or the asset cannot be resolved
+	template<typename TSharedAsset>
+	[[nodiscard]] inline const TSharedAsset& Resolve(RpgAssetFileType type, int snapshotIndex) noexcept
+	{
+		static const TSharedAsset EMPTY_ASSET;
+
+		if (snapshotIndex == RPG_INDEX_INVALID)
+		{
+			return EMPTY_ASSET;
+		}
+
+		// Records are not validated by the world, invalid index comes from corrupted data
+		if (snapshotIndex < 0 || snapshotIndex >= SnapshotReferences.GetCount() || References[SnapshotReferences[snapshotIndex]].Type != type)
+		{
+			RPG_LogWarn(RpgLogTemp, "Invalid snapshot asset reference index %i!", snapshotIndex);
+			return EMPTY_ASSET;
+		}
+
+		FReference& reference = References[SnapshotReferences[snapshotIndex]];
+
+		if (reference.Resolved == nullptr)
+		{
+			TSharedAsset* resolved = new TSharedAsset();
+			const FGenericFunction resolve = Resolvers[static_cast<int>(type)];
+
+			if (resolve)
+			{
+				*resolved = reinterpret_cast<TResolveFunction<TSharedAsset>>(resolve)(reference.Name);
+			}
+
+			SetResolved(reference, resolved);
+			reference.bUnresolved = !(*resolved);
+		}
+
+		return *static_cast<const TSharedAsset*>(reference.Resolved);
+	}
+
+
+	// Get number of assets kept by this table
+	[[nodiscard]] inline int GetCount() const noexcept
+	{
+		return References.GetCount();
+	}
+
+
+	// Remove all references and release kept assets. Resolvers are kept
+	inline void Clear() noexcept
+	{
+		for (int i = 0; i < References.GetCount(); ++i)
+		{
+			if (References[i].Resolved)
+			{
+				References[i].Release(References[i].Resolved);
+			}
+		}
+
+		References.Clear();
+		SnapshotReferences.Clear();
+
+		for (int t = 0; t < static_cast<int>(RpgAssetFileType::MAX_COUNT); ++t)
+		{
+			ReferenceIndices[t].Clear();
+		}
+	}
+
+
+private:
+	typedef void (*FGenericFunction)();
+	typedef void (*FReleaseFunction)(void* data) noexcept;
+
+	struct FReference
+	{
+		RpgName Name;
+		RpgAssetFileType Type;
+		bool bUnresolved;
+
+		// Index in the snapshot being saved/loaded, RPG_INDEX_INVALID if not referenced by it
+		int SnapshotIndex;
+
+		// Type-erased TSharedAsset, set on AddReference() or first Resolve()
+		void* Resolved;
+		FReleaseFunction Release;
+	};
+
+
+	template<typename TSharedAsset>
+	static inline void SetResolved(FReference& reference, TSharedAsset* resolved) noexcept
+	{
+		reference.Resolved = resolved;
+		reference.Release = [](void* data) noexcept
+		{
+			delete static_cast<TSharedAsset*>(data);
+		};
+	}
+
+
+	inline int FindOrAddReference(RpgAssetFileType type, const RpgName& name) noexcept
+	{
+		RpgMap<RpgName, int>& referenceIndices = ReferenceIndices[static_cast<int>(type)];
+
+		if (const int* existingIndex = referenceIndices.GetValueByKey(name))
+		{
+			return *existingIndex;
+		}
+
+		const int referenceIndex = References.GetCount();
+		referenceIndices.Add(name) = referenceIndex;
+
+		FReference& reference = References.Add();
+		reference.Name = name;
+		reference.Type = type;
+		reference.bUnresolved = false;
+		reference.SnapshotIndex = RPG_INDEX_INVALID;
+		reference.Resolved = nullptr;
+		reference.Release = nullptr;
+
+		return referenceIndex;
+	}
+
+
+	// [RpgWorld] Start saving/loading snapshot, snapshot references are empty
+	inline void BeginSnapshot() noexcept
+	{
+		for (int i = 0; i < SnapshotReferences.GetCount(); ++i)
+		{
+			References[SnapshotReferences[i]].SnapshotIndex = RPG_INDEX_INVALID;
+		}
+
+		SnapshotReferences.Clear();
+	}
+
+
+	// [RpgWorld] Add reference read from snapshot data. Must be called in snapshot order
+	inline void AddSnapshotReference(RpgAssetFileType type, const RpgName& name) noexcept
+	{
+		const int referenceIndex = FindOrAddReference(type, name);
+		SnapshotReferences.AddValue(referenceIndex);
+
+		if (References[referenceIndex].SnapshotIndex == RPG_INDEX_INVALID)
+		{
+			References[referenceIndex].SnapshotIndex = SnapshotReferences.GetCount() - 1;
+		}
+	}
+
+
+	[[nodiscard]] inline int GetSnapshotReferenceCount() const noexcept
+	{
+		return SnapshotReferences.GetCount();
+	}
+
+	[[nodiscard]] inline const FReference& GetSnapshotReference(int snapshotIndex) const noexcept
+	{
+		return References[SnapshotReferences[snapshotIndex]];
+	}
+
+
+private:
+	// Assets kept by this table
+	RpgArray<FReference> References;
+
+	// Index into References for each reference of the snapshot being saved/loaded
+	RpgArray<int> SnapshotReferences;
+
+	// Index into References of each asset name, per asset type
+	RpgMap<RpgName, int> ReferenceIndices[static_cast<int>(RpgAssetFileType::MAX_COUNT)];
+	FGenericFunction Resolvers[static_cast<int>(RpgAssetFileType::MAX_COUNT)];
+
+
+	friend class RpgWorld;
+
+};
@@ -1,5 +1,7 @@
 #include "RpgEngine.h"
 #include "core/RpgCommandLine.h"
+#include "core/RpgProfiler.h"
+#include "core/world/RpgStreamingWorldSubsystem.h"
 #include "physics/world/RpgPhysicsComponent.h"
 #include "physics/world/RpgPhysicsWorldSubsystem.h"
 #include "render/world/RpgRenderComponent.h"
@@ -47,6 +49,7 @@ RpgEngine::RpgEngine(const char* windowTitle) noexcept
 		MainWorld->Subsystem_Add<RpgPhysicsWorldSubsystem>(0);
 		MainWorld->Subsystem_Add<RpgAnimationWorldSubsystem>(1);
 		MainWorld->Subsystem_Add<RpgRenderWorldSubsystem>(2);
+		MainWorld->Subsystem_Add<RpgStreamingWorldSubsystem>(3);
 
 		// Components
 		MainWorld->Component_Register<RpgPhysicsComponent_Filter>();
@@ -82,6 +85,25 @@ void RpgEngine::Initialize() noexcept
 
 	SetMainCamera(MainWorld->GameObject_Create("camera_main"));
 	MainWorld->GameObject_AttachScript(MainCameraObject, &ScriptDebugCamera);
+
+	// Stream test level in cells around the main camera: -world_streaming=<cellSize>
+	if (RpgCommandLine::HasCommand("world_streaming"))
+	{
+		const int cellSize = RpgCommandLine::GetCommandValueInt("world_streaming");
+		const RpgString directoryPath = RpgFileSystem::GetProjectDirPath() + "saved/world_streaming";
+
+		if (RpgPlatformFile::Directory_Create(*directoryPath))
+		{
+			MainWorld->Subsystem_Get<RpgStreamingWorldSubsystem>()->BuildCells(directoryPath, cellSize > 0 ? static_cast<float>(cellSize) : RPG_ENGINE_WORLD_STREAMING_CELL_SIZE);
+		}
+	}
+
+	// Capture profiler trace at startup: -profile_trace=<frameCount>
+	if (RpgCommandLine::HasCommand("profile_trace"))
+	{
+		const int frameCount = RpgCommandLine::GetCommandValueInt("profile_trace");
+		RpgProfiler::RequestCapture(frameCount > 0 ? frameCount : RPG_ENGINE_PROFILER_CAPTURE_FRAME_COUNT, "RpgTrace.json");
+	}
 }
 
 
@@ -132,6 +154,10 @@ void RpgEngine::KeyboardButton(const SDL_KeyboardEvent& e) noexcept
 			RpgRenderWorldSubsystem* subsystem = MainWorld->Subsystem_Get<RpgRenderWorldSubsystem>();
 			subsystem->bDebugDrawMeshBound = !subsystem->bDebugDrawMeshBound;
 		}
+		else if (e.scancode == SDL_SCANCODE_F10)
+		{
+			RpgProfiler::RequestCapture(RPG_ENGINE_PROFILER_CAPTURE_FRAME_COUNT, "RpgTrace.json");
+		}
 		else if (e.scancode == SDL_SCANCODE_F9)
 		{
 			if (MainWorld->HasStartedPlay())
@@ -149,6 +175,9 @@ void RpgEngine::KeyboardButton(const SDL_KeyboardEvent& e) noexcept
 
 void RpgEngine::FrameTick(uint64_t frameCounter, float deltaTime) noexcept
 {
+	RpgProfiler::BeginFrame(frameCounter);
+	RPG_PROFILER_Scope("FrameTick");
+
 	const int frameIndex = frameCounter % RPG_FRAME_BUFFERING;
 
 	RpgPointInt windowDimension;
@@ -181,6 +210,8 @@ void RpgEngine::FrameTick(uint64_t frameCounter, float deltaTime) noexcept
 
 	// Begin frame
 	{
+		RPG_PROFILER_Scope("FrameTick_BeginFrame");
+		RpgFrameArena::BeginFrame(frameIndex);
 		MainWorld->BeginFrame(frameIndex);
 	}
 
@@ -197,90 +228,96 @@ void RpgEngine::FrameTick(uint64_t frameCounter, float deltaTime) noexcept
 
 	// Tick update
 	{
+		RPG_PROFILER_Scope("FrameTick_TickUpdate");
 		MainWorld->DispatchTickUpdate(deltaTime);
 	}
 	
 
 	// Post tick update
 	{
+		RPG_PROFILER_Scope("FrameTick_PostTickUpdate");
 		MainWorld->DispatchPostTickUpdate();
 	}
 
 
 	// Render
-	RpgD3D12::BeginFrame(frameIndex);
-
-	Renderer->BeginRender(frameIndex, deltaTime);
 	{
-		Renderer->RegisterWorld(MainWorld);
+		RPG_PROFILER_Scope("FrameTick_Render");
+		RpgD3D12::BeginFrame(frameIndex);
 
-		// Setup renderer default final texture
-		Renderer->FinalTexture = SceneViewport.GetTextureRenderTarget(frameIndex);
+		Renderer->BeginRender(frameIndex, deltaTime);
+		{
+			Renderer->RegisterWorld(MainWorld);
 
-		// Dispatch render
-		MainWorld->DispatchRender(frameIndex, Renderer.Get());
+			// Setup renderer default final texture
+			Renderer->FinalTexture = SceneViewport.GetTextureRenderTarget(frameIndex);
 
-		// Render 2D
-		RpgRenderer2D& r2 = Renderer->GetRenderer2D();
+			// Dispatch render
+			MainWorld->DispatchRender(frameIndex, Renderer.Get());
 
-		// GUI
-		GuiContext.End(r2);
+			// Render 2D
+			RpgRenderer2D& r2 = Renderer->GetRenderer2D();
 
+			// GUI
+			GuiContext.End(r2);
 
-	#ifndef RPG_BUILD_SHIPPING
-		// Debug info
-		{
-			static RpgString debugInfoText;
 
-			RpgTransform mainCameraTransform = MainCameraObject.IsValid() ? MainWorld->GameObject_GetWorldTransform(MainCameraObject) : RpgTransform();
-			float pitch, yaw;
-			ScriptDebugCamera.GetRotationPitchYaw(pitch, yaw);
-			
-			debugInfoText = RpgString::Format(
-				"CameraPosition: %.2f, %.2f, %.2f\n"
-				"CameraPitchYaw: %.2f, %.2f\n"
-				"CameraFrustumCulling: %d\n"
-				"Gamma: %.2f\n"
-				"VSync: %d\n"
-				"\n"
-				"GameObject: %i\n"
-				, mainCameraTransform.Position.X, mainCameraTransform.Position.Y, mainCameraTransform.Position.Z
-				, pitch, yaw
-				, mainCameraComp ? mainCameraComp->bFrustumCulling : false
-				, Renderer->Gamma
-				, Renderer->GetVsync()
-				, MainWorld->GameObject_GetCount()
-			);
-
-			r2.AddText(*debugInfoText, debugInfoText.GetLength(), 8, 16, RpgColorRGBA(255, 255, 255));
-		}
-	#endif // !RPG_BUILD_SHIPPING
+		#ifndef RPG_BUILD_SHIPPING
+			// Debug info
+			{
+				static RpgString debugInfoText;
 
+				RpgTransform mainCameraTransform = MainCameraObject.IsValid() ? MainWorld->GameObject_GetWorldTransform(MainCameraObject) : RpgTransform();
+				float pitch, yaw;
+				ScriptDebugCamera.GetRotationPitchYaw(pitch, yaw);
+			
+				debugInfoText = RpgString::Format(
+					"CameraPosition: %.2f, %.2f, %.2f\n"
+					"CameraPitchYaw: %.2f, %.2f\n"
+					"CameraFrustumCulling: %d\n"
+					"Gamma: %.2f\n"
+					"VSync: %d\n"
+					"\n"
+					"GameObject: %i\n"
+					, mainCameraTransform.Position.X, mainCameraTransform.Position.Y, mainCameraTransform.Position.Z
+					, pitch, yaw
+					, mainCameraComp ? mainCameraComp->bFrustumCulling : false
+					, Renderer->Gamma
+					, Renderer->GetVsync()
+					, MainWorld->GameObject_GetCount()
+				);
+
+				r2.AddText(*debugInfoText, debugInfoText.GetLength(), 8, 16, RpgColorRGBA(255, 255, 255));
+			}
+		#endif // !RPG_BUILD_SHIPPING
 
-		// Fps info
-		{
-			RpgColorRGBA fpsTextColor;
 
-			if (FpsCountMs < 30)
+			// Fps info
 			{
-				fpsTextColor = RpgColorRGBA::RED;
+				RpgColorRGBA fpsTextColor;
+
+				if (FpsCountMs < 30)
+				{
+					fpsTextColor = RpgColorRGBA::RED;
+				}
+				else if (FpsCountMs < 50)
+				{
+					fpsTextColor = RpgColorRGBA::YELLOW;
+				}
+				else
+				{
+					fpsTextColor = RpgColorRGBA::GREEN;
+				}
+
+				r2.AddText(*FpsString, FpsString.GetLength(), r2.GetViewportDimension().X - 110, 16, fpsTextColor);
 			}
-			else if (FpsCountMs < 50)
-			{
-				fpsTextColor = RpgColorRGBA::YELLOW;
-			}
-			else
-			{
-				fpsTextColor = RpgColorRGBA::GREEN;
-			}
-
-			r2.AddText(*FpsString, FpsString.GetLength(), r2.GetViewportDimension().X - 110, 16, fpsTextColor);
 		}
+		Renderer->EndRender(frameIndex, deltaTime);
 	}
-	Renderer->EndRender(frameIndex, deltaTime);
 
 
 	// End frame
+	RPG_PROFILER_Scope("FrameTick_EndFrame");
 	MainWorld->EndFrame(frameIndex);
 	InputManager.Flush();
 }
@@ -320,6 +357,7 @@ void RpgEngine::SetMainCamera(RpgGameObjectID cameraObject) noexcept
 	}
 
 	MainCameraObject = cameraObject;
+	MainWorld->Subsystem_Get<RpgStreamingWorldSubsystem>()->SetFocusGameObject(MainCameraObject);
 
 	RpgRenderComponent_Camera* cameraComp = MainWorld->GameObject_AddComponent<RpgRenderComponent_Camera>(MainCameraObject);
 	cameraComp->Viewport = &SceneViewport;
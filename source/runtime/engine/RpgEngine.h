@@ -10,6 +10,13 @@
 #include "script/RpgScript_DebugCamera.h"
 
 
+// Default number of frames captured by profiler (F10 or command line -profile_trace)
+#define RPG_ENGINE_PROFILER_CAPTURE_FRAME_COUNT		120
+
+// Default cell size of world streaming (command line -world_streaming)
+#define RPG_ENGINE_WORLD_STREAMING_CELL_SIZE		2000.0f
+
+
 
 extern class RpgEngine* g_Engine;
 
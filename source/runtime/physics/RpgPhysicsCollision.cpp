@@ -113,9 +113,13 @@ namespace RpgPhysicsCollision
 // =========================================================================================================================================================== //
 	void Filter::GeneratePairs(RpgArray<FPairTest>& out_Pairs, RpgWorld* world) noexcept
 	{
-		for (auto firstIt = world->Component_CreateIterator<RpgPhysicsComponent_Filter>(); firstIt; ++firstIt)
+		// Filter and collision of each game object are resolved once by the query, not for every pair
+		const RpgWorldQuery<RpgPhysicsComponent_Filter, RpgPhysicsComponent_Collision> query = world->Query<RpgPhysicsComponent_Filter, RpgPhysicsComponent_Collision>();
+		const int count = query.GetCount();
+
+		for (int first = 0; first < count; ++first)
 		{
-			RpgPhysicsComponent_Filter& firstFilter = firstIt.GetValue();
+			const RpgPhysicsComponent_Filter& firstFilter = query.Get<RpgPhysicsComponent_Filter>(first);
 
 			if (firstFilter.ObjectChannel == RpgPhysicsCollision::CHANNEL_NONE)
 			{
@@ -123,14 +127,9 @@ namespace RpgPhysicsCollision
 			}
 
 
-			for (auto secondIt = firstIt; secondIt; ++secondIt)
+			for (int second = first + 1; second < count; ++second)
 			{
-				if (firstIt == secondIt)
-				{
-					continue;
-				}
-
-				const RpgPhysicsComponent_Filter& secondFilter = secondIt.GetValue();
+				const RpgPhysicsComponent_Filter& secondFilter = query.Get<RpgPhysicsComponent_Filter>(second);
 
 				if (secondFilter.ObjectChannel == RpgPhysicsCollision::CHANNEL_NONE)
 				{
@@ -139,13 +138,7 @@ namespace RpgPhysicsCollision
 
 				if (firstFilter.ResponseChannels[secondFilter.ObjectChannel] == secondFilter.ResponseChannels[firstFilter.ObjectChannel])
 				{
-					RpgPhysicsComponent_Collision* firstCollision = world->GameObject_GetComponent<RpgPhysicsComponent_Collision>(firstFilter.GameObject);
-					RPG_Check(firstCollision && firstCollision->GameObject == firstFilter.GameObject);
-
-					RpgPhysicsComponent_Collision* secondCollision = world->GameObject_GetComponent<RpgPhysicsComponent_Collision>(secondFilter.GameObject);
-					RPG_Check(secondCollision && secondCollision->GameObject == secondFilter.GameObject);
-
-					out_Pairs.AddValue({ firstCollision, secondCollision });
+					out_Pairs.AddValue({ &query.Get<RpgPhysicsComponent_Collision>(first), &query.Get<RpgPhysicsComponent_Collision>(second) });
 				}
 			}
 		}
@@ -0,0 +1,31 @@
+#include "RpgPhysicsTask_Broadphase.h"
+
+
+
+RpgPhysicsTask_Broadphase::RpgPhysicsTask_Broadphase() noexcept
+{
+	FilterPairs = nullptr;
+	NarrowphasePairs = nullptr;
+}
+
+
+void RpgPhysicsTask_Broadphase::Reset() noexcept
+{
+	RpgThreadTask::Reset();
+
+	FilterPairs = nullptr;
+	NarrowphasePairs = nullptr;
+}
+
+
+void RpgPhysicsTask_Broadphase::Execute() noexcept
+{
+	RPG_Assert(FilterPairs && NarrowphasePairs);
+
+	if (FilterPairs->IsEmpty())
+	{
+		return;
+	}
+
+	RpgPhysicsCollision::Broadphase::GeneratePairs(*NarrowphasePairs, *FilterPairs);
+}
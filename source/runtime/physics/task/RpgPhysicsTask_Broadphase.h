@@ -0,0 +1,26 @@
+#pragma once
+
+#include "core/RpgThreadPool.h"
+#include "../RpgPhysicsTypes.h"
+
+
+
+class RpgPhysicsTask_Broadphase : public RpgThreadTask
+{
+public:
+	const RpgArray<RpgPhysicsCollision::FPairTest>* FilterPairs;
+	RpgArray<RpgPhysicsCollision::FPairTest>* NarrowphasePairs;
+
+
+public:
+	RpgPhysicsTask_Broadphase() noexcept;
+	virtual void Reset() noexcept override;
+	virtual void Execute() noexcept override;
+
+
+	virtual const char* GetTaskName() const noexcept override
+	{
+		return "RpgPhysicsTask_Broadphase";
+	}
+
+};
@@ -0,0 +1,28 @@
+#include "RpgPhysicsTask_Narrowphase.h"
+
+
+
+RpgPhysicsTask_Narrowphase::RpgPhysicsTask_Narrowphase() noexcept
+{
+	NarrowphasePairs = nullptr;
+}
+
+
+void RpgPhysicsTask_Narrowphase::Reset() noexcept
+{
+	RpgThreadTask::Reset();
+
+	NarrowphasePairs = nullptr;
+}
+
+
+void RpgPhysicsTask_Narrowphase::Execute() noexcept
+{
+	RPG_Assert(NarrowphasePairs);
+
+	// test overlaps
+	for (int i = 0; i < NarrowphasePairs->GetCount(); ++i)
+	{
+
+	}
+}
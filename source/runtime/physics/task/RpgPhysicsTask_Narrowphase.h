@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/RpgThreadPool.h"
+#include "../RpgPhysicsTypes.h"
+
+
+
+class RpgPhysicsTask_Narrowphase : public RpgThreadTask
+{
+public:
+	const RpgArray<RpgPhysicsCollision::FPairTest>* NarrowphasePairs;
+
+
+public:
+	RpgPhysicsTask_Narrowphase() noexcept;
+	virtual void Reset() noexcept override;
+	virtual void Execute() noexcept override;
+
+
+	virtual const char* GetTaskName() const noexcept override
+	{
+		return "RpgPhysicsTask_Narrowphase";
+	}
+
+};
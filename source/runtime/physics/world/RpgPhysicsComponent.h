@@ -109,3 +109,87 @@ private:
 	friend RpgPhysicsTask_UpdateShape;
 
 };
+
+
+
+template<>
+struct RpgComponentSnapshot<RpgPhysicsComponent_Filter>
+{
+	static constexpr bool bEnabled = true;
+
+	struct FRecord
+	{
+		uint8_t ObjectChannel;
+		uint8_t ResponseChannelCount;
+		uint8_t ResponseChannels[RpgPhysicsCollision::CHANNEL_MAX_COUNT];
+	};
+
+
+	static inline void Save(FRecord& out_Record, const RpgPhysicsComponent_Filter& component, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		out_Record.ObjectChannel = component.ObjectChannel;
+		out_Record.ResponseChannelCount = static_cast<uint8_t>(component.ResponseChannels.GetCount());
+
+		for (int i = 0; i < component.ResponseChannels.GetCount(); ++i)
+		{
+			out_Record.ResponseChannels[i] = component.ResponseChannels[i];
+		}
+	}
+
+
+	static inline void Load(RpgPhysicsComponent_Filter& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		const int responseChannelCount = (record.ResponseChannelCount < RpgPhysicsCollision::CHANNEL_MAX_COUNT) ? record.ResponseChannelCount : RpgPhysicsCollision::CHANNEL_MAX_COUNT;
+
+		component.ObjectChannel = static_cast<RpgPhysicsCollision::EChannel>(record.ObjectChannel);
+		component.ResponseChannels.Resize(responseChannelCount);
+
+		for (int i = 0; i < responseChannelCount; ++i)
+		{
+			component.ResponseChannels[i] = static_cast<RpgPhysicsCollision::EResponse>(record.ResponseChannels[i]);
+		}
+	}
+};
+
+
+
+// Bound is not saved, it's recomputed from shape on the next physics update
+template<>
+struct RpgComponentSnapshot<RpgPhysicsComponent_Collision>
+{
+	static constexpr bool bEnabled = true;
+
+	struct FRecord
+	{
+		float Size[4];
+		float Velocity[3];
+		float AngularVelocity[3];
+		uint8_t Shape;
+	};
+
+
+	static inline void Save(FRecord& out_Record, const RpgPhysicsComponent_Collision& component, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		out_Record.Size[0] = component.Size.X;
+		out_Record.Size[1] = component.Size.Y;
+		out_Record.Size[2] = component.Size.Z;
+		out_Record.Size[3] = component.Size.W;
+		out_Record.Velocity[0] = component.Velocity.X;
+		out_Record.Velocity[1] = component.Velocity.Y;
+		out_Record.Velocity[2] = component.Velocity.Z;
+		out_Record.AngularVelocity[0] = component.AngularVelocity.X;
+		out_Record.AngularVelocity[1] = component.AngularVelocity.Y;
+		out_Record.AngularVelocity[2] = component.AngularVelocity.Z;
+		out_Record.Shape = component.Shape;
+	}
+
+
+	static inline void Load(RpgPhysicsComponent_Collision& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		component.Size = RpgVector4(record.Size[0], record.Size[1], record.Size[2], record.Size[3]);
+		component.Velocity = RpgVector3(record.Velocity[0], record.Velocity[1], record.Velocity[2]);
+		component.AngularVelocity = RpgVector3(record.AngularVelocity[0], record.AngularVelocity[1], record.AngularVelocity[2]);
+		component.Shape = static_cast<RpgPhysicsCollision::EShape>(record.Shape);
+		component.bUpdateBounding = true;
+	}
+};
@@ -8,6 +8,9 @@ RpgPhysicsWorldSubsystem::RpgPhysicsWorldSubsystem() noexcept
 	Name = "PhysicsWorldSubsystem";
 	bTickUpdateCollision = false;
 
+	DeclareComponentWrite<RpgPhysicsComponent_Filter>();
+	DeclareComponentWrite<RpgPhysicsComponent_Collision>();
+
 #ifndef RPG_BUILD_SHIPPING
 	bDebugDrawCollisionBound = false;
 	bDebugDrawCollisionShape = false;
@@ -40,50 +43,49 @@ void RpgPhysicsWorldSubsystem::TickUpdate(float deltaTime) noexcept
 
 	RpgWorld* world = GetWorld();
 
+	TaskUpdateBound.Reset();
+	TaskUpdateBound.World = world;
 
-	RpgArrayInline<RpgThreadTask*, 4> submitTasks;
-	// update bounds
-	{
-		TaskUpdateBound.Reset();
-		TaskUpdateBound.World = world;
-		submitTasks.AddValue(&TaskUpdateBound);
-	}
-	// update shapes
-	{
-		TaskUpdateShape.Reset();
-		TaskUpdateShape.World = world;
-		submitTasks.AddValue(&TaskUpdateShape);
-	}
-	RpgThreadPool::SubmitTasks(submitTasks.GetData(), submitTasks.GetCount());
+	TaskUpdateShape.Reset();
+	TaskUpdateShape.World = world;
 
+	TaskBroadphase.Reset();
+	TaskBroadphase.FilterPairs = &BroadphaseCollisionPairs;
+	TaskBroadphase.NarrowphasePairs = &NarrowphaseCollisionPairs;
+	TaskBroadphase.AddDependency(&TaskUpdateBound);
 
-	// generate pairs for broadphase
-	RpgPhysicsCollision::Filter::GeneratePairs(BroadphaseCollisionPairs, world);
+	TaskNarrowphase.Reset();
+	TaskNarrowphase.NarrowphasePairs = &NarrowphaseCollisionPairs;
+	TaskNarrowphase.AddDependency(&TaskBroadphase);
+	TaskNarrowphase.AddDependency(&TaskUpdateShape);
 
-	if (BroadphaseCollisionPairs.IsEmpty())
+
+	// update bounds and shapes
 	{
-		return;
+		RpgThreadTask* submitTasks[2] = { &TaskUpdateBound, &TaskUpdateShape };
+		RpgThreadPool::SubmitTasks(submitTasks, 2);
 	}
 
 
-	// wait update bound finished
-	TaskUpdateBound.Wait();
-
-	// generate pairs for narrowphase
-	RpgPhysicsCollision::Broadphase::GeneratePairs(NarrowphaseCollisionPairs, BroadphaseCollisionPairs);
-
+	// generate pairs for broadphase
+	RpgPhysicsCollision::Filter::GeneratePairs(BroadphaseCollisionPairs, world);
 
-	// wait update shape finished
-	TaskUpdateShape.Wait();
 
-	// test overlaps
-	for (int i = 0; i < NarrowphaseCollisionPairs.GetCount(); ++i)
+	// broadphase runs once update bound finished, narrowphase runs once broadphase and update shape finished
 	{
-
+		RpgThreadTask* submitTasks[2] = { &TaskBroadphase, &TaskNarrowphase };
+		RpgThreadPool::SubmitTasks(submitTasks, 2);
 	}
 }
 
 
+void RpgPhysicsWorldSubsystem::PostTickUpdate() noexcept
+{
+	RpgThreadTask* waitTasks[4] = { &TaskUpdateBound, &TaskUpdateShape, &TaskBroadphase, &TaskNarrowphase };
+	RPG_THREAD_TASK_WaitAll(waitTasks, 4);
+}
+
+
 void RpgPhysicsWorldSubsystem::Render(int frameIndex, RpgRenderer* renderer) noexcept
 {
 
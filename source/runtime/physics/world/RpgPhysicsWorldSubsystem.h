@@ -3,6 +3,8 @@
 #include "core/world/RpgWorld.h"
 #include "../task/RpgPhysicsTask_UpdateBound.h"
 #include "../task/RpgPhysicsTask_UpdateShape.h"
+#include "../task/RpgPhysicsTask_Broadphase.h"
+#include "../task/RpgPhysicsTask_Narrowphase.h"
 
 
 
@@ -15,12 +17,15 @@ protected:
 	virtual void StartPlay() noexcept override;
 	virtual void StopPlay() noexcept override;
 	virtual void TickUpdate(float deltaTime) noexcept override;
+	virtual void PostTickUpdate() noexcept override;
 	virtual void Render(int frameIndex, RpgRenderer* renderer) noexcept override;
 
 
 private:
 	RpgPhysicsTask_UpdateBound TaskUpdateBound;
 	RpgPhysicsTask_UpdateShape TaskUpdateShape;
+	RpgPhysicsTask_Broadphase TaskBroadphase;
+	RpgPhysicsTask_Narrowphase TaskNarrowphase;
 	RpgArray<RpgPhysicsCollision::FPairTest> BroadphaseCollisionPairs;
 	RpgArray<RpgPhysicsCollision::FPairTest> NarrowphaseCollisionPairs;
 	bool bTickUpdateCollision;
@@ -6,6 +6,9 @@
 #include "RpgMaterial.h"
 
 
+class RpgAnimationComponent_AnimSkeletonPose;
+
+
 
 // Global material resource
 // Texture descriptor dynamic indexing
@@ -195,7 +198,7 @@ public:
 	RpgMeshSkinnedResource() noexcept;
 	
 	FMeshID AddMesh(const RpgSharedMesh& mesh, int& out_IndexCount, int& out_IndexStart, int& out_IndexVertexOffset) noexcept;
-	FSkeletonID AddObjectBoneSkinningTransforms(FMeshID meshId, const RpgArray<RpgMatrixTransform>& boneSkinningTransforms) noexcept;
+	FSkeletonID AddObjectBoneSkinningTransforms(FMeshID meshId, const RpgMatrixTransform* boneSkinningTransforms, int boneCount) noexcept;
 
 	void UpdateResources() noexcept;
 	void CommandCopy(ID3D12GraphicsCommandList* cmdList) noexcept;
@@ -511,7 +514,7 @@ private:
 		}
 	};
 
-	RpgArray<FTagTransformID> CachedTagTransforms;
+	RpgArraySmall<FTagTransformID, 64> CachedTagTransforms;
 	RpgArray<RpgMatrixTransform> TransformDatas;
 	ComPtr<D3D12MA::Allocation> TransformStructBuffer;
 
@@ -545,6 +548,10 @@ struct RpgSceneMesh
 	RpgMatrixTransform WorldTransformMatrix;
 	RpgSharedMaterial Material;
 	RpgSharedMesh Mesh;
+
+	// Animation pose of game object, nullptr if it has no animation component
+	const RpgAnimationComponent_AnimSkeletonPose* AnimSkeletonPose{ nullptr };
+
 	int Lod{ 0 };
 };
 
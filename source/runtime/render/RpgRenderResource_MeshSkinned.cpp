@@ -39,7 +39,7 @@ RpgMeshSkinnedResource::FMeshID RpgMeshSkinnedResource::AddMesh(const RpgSharedM
 }
 
 
-RpgMeshSkinnedResource::FSkeletonID RpgMeshSkinnedResource::AddObjectBoneSkinningTransforms(FMeshID meshId, const RpgArray<RpgMatrixTransform>& boneSkinningTransforms) noexcept
+RpgMeshSkinnedResource::FSkeletonID RpgMeshSkinnedResource::AddObjectBoneSkinningTransforms(FMeshID meshId, const RpgMatrixTransform* boneSkinningTransforms, int boneCount) noexcept
 {
 	const FSkeletonID id = SkeletonBoneSkinningTransforms.GetCount();
 	
@@ -53,7 +53,7 @@ RpgMeshSkinnedResource::FSkeletonID RpgMeshSkinnedResource::AddObjectBoneSkinnin
 	param.IndexCount = meshData.IndexCount;
 	param.SkeletonIndex = id;
 
-	for (int b = 0; b < boneSkinningTransforms.GetCount(); ++b)
+	for (int b = 0; b < boneCount; ++b)
 	{
 		SkeletonBoneSkinningTransforms.AddValue(boneSkinningTransforms[b].Xmm);
 	}
@@ -256,7 +256,8 @@ void RpgRenderer::EndRender(int frameIndex, float deltaTime) noexcept
 	ID3D12CommandQueue* cmdQueueDirect = RpgD3D12::GetCommandQueueDirect();
 
 
-	// Wait all shadow pass tasks
+	// Wait all shadow pass tasks. Pass tasks do not depend on each other on CPU (copy/compute ordering is done with GPU fences),
+	// the waits below are joins for main thread to submit recorded command lists to direct queue in order and present
 	RPG_THREAD_TASK_WaitAll(taskShadowPasses.GetData(), taskShadowPasses.GetCount());
 	{
 		RpgArrayInline<ID3D12CommandList*, 32> directCommandLists;
@@ -69,7 +69,7 @@ void RpgSceneViewport::PreRender(RpgRenderFrameContext& frameContext, RpgWorldRe
 
 	const RpgWorldResource::FViewID cameraId = worldResource->AddView(ViewMatrix, ProjectionMatrix, ViewPosition, NearClipZ, FarClipZ);
 
-	RpgArray<RpgMatrixTransform> tempBoneSkinningTransforms;
+	RpgArrayFrame<RpgMatrixTransform> tempBoneSkinningTransforms;
 
 	for (int m = 0; m < Meshes.GetCount(); ++m)
 	{
@@ -85,7 +85,7 @@ void RpgSceneViewport::PreRender(RpgRenderFrameContext& frameContext, RpgWorldRe
 
 		if (bHasSkin)
 		{
-			const RpgAnimationComponent_AnimSkeletonPose* animComp = world->GameObject_GetComponent<RpgAnimationComponent_AnimSkeletonPose>(data.GameObject);
+			const RpgAnimationComponent_AnimSkeletonPose* animComp = data.AnimSkeletonPose;
 
 			// draw as static mesh if no animation component
 			bIsStaticMesh = (animComp == nullptr);
@@ -104,7 +104,7 @@ void RpgSceneViewport::PreRender(RpgRenderFrameContext& frameContext, RpgWorldRe
 				}
 
 				const RpgMeshSkinnedResource::FMeshID meshId = meshSkinnedResource->AddMesh(data.Mesh, draw.IndexCount, draw.IndexStart, draw.IndexVertexOffset);
-				meshSkinnedResource->AddObjectBoneSkinningTransforms(meshId, tempBoneSkinningTransforms);
+				meshSkinnedResource->AddObjectBoneSkinningTransforms(meshId, tempBoneSkinningTransforms.GetData(), tempBoneSkinningTransforms.GetCount());
 			}
 		}
 
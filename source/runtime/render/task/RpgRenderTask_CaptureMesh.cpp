@@ -1,6 +1,68 @@
 #include "RpgRenderTask_Capture.h"
 #include "core/world/RpgWorld.h"
 #include "../world/RpgRenderComponent.h"
+#include "animation/world/RpgAnimationComponent.h"
+
+
+
+typedef RpgComponentSoA<RpgRenderComponent_Mesh>::FChunk FMeshChunk;
+
+
+// Test world bounds of all lanes in <chunk> against frustum <planes>, 4 lanes at a time
+// @returns Bitmask, bit N is set if bound of lane N is completely outside of the frustum
+static uint64_t CullMeshChunk(const FMeshChunk& chunk, const RpgVector4 planes[6]) noexcept
+{
+	using namespace DirectX;
+
+	const XMVECTOR half = XMVectorReplicate(0.5f);
+	uint64_t outsideMask = 0;
+
+	for (int lane = 0; lane < RPG_COMPONENT_CHUNK_SIZE; lane += 4)
+	{
+		const XMVECTOR minX = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(chunk.MinX + lane));
+		const XMVECTOR minY = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(chunk.MinY + lane));
+		const XMVECTOR minZ = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(chunk.MinZ + lane));
+		const XMVECTOR maxX = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(chunk.MaxX + lane));
+		const XMVECTOR maxY = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(chunk.MaxY + lane));
+		const XMVECTOR maxZ = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(chunk.MaxZ + lane));
+
+		const XMVECTOR centerX = XMVectorMultiply(XMVectorAdd(minX, maxX), half);
+		const XMVECTOR centerY = XMVectorMultiply(XMVectorAdd(minY, maxY), half);
+		const XMVECTOR centerZ = XMVectorMultiply(XMVectorAdd(minZ, maxZ), half);
+		const XMVECTOR extentX = XMVectorMultiply(XMVectorSubtract(maxX, minX), half);
+		const XMVECTOR extentY = XMVectorMultiply(XMVectorSubtract(maxY, minY), half);
+		const XMVECTOR extentZ = XMVectorMultiply(XMVectorSubtract(maxZ, minZ), half);
+
+		XMVECTOR outside = XMVectorFalseInt();
+
+		for (int p = 0; p < 6; ++p)
+		{
+			const XMVECTOR plane = planes[p].Xmm;
+			const XMVECTOR normalX = XMVectorSplatX(plane);
+			const XMVECTOR normalY = XMVectorSplatY(plane);
+			const XMVECTOR normalZ = XMVectorSplatZ(plane);
+
+			// distance of center to plane
+			XMVECTOR distance = XMVectorMultiplyAdd(centerX, normalX, XMVectorSplatW(plane));
+			distance = XMVectorMultiplyAdd(centerY, normalY, distance);
+			distance = XMVectorMultiplyAdd(centerZ, normalZ, distance);
+
+			// extents projected onto plane normal
+			XMVECTOR radius = XMVectorMultiply(extentX, XMVectorAbs(normalX));
+			radius = XMVectorMultiplyAdd(extentY, XMVectorAbs(normalY), radius);
+			radius = XMVectorMultiplyAdd(extentZ, XMVectorAbs(normalZ), radius);
+
+			outside = XMVectorOrInt(outside, XMVectorGreater(distance, radius));
+		}
+
+		uint32_t outsideLanes[4];
+		XMStoreInt4(outsideLanes, outside);
+
+		outsideMask |= static_cast<uint64_t>((outsideLanes[0] & 1) | (outsideLanes[1] & 2) | (outsideLanes[2] & 4) | (outsideLanes[3] & 8)) << lane;
+	}
+
+	return outsideMask;
+}
 
 
 
@@ -27,34 +89,86 @@ void RpgRenderTask_CaptureMesh::Execute() noexcept
 
 	const bool bFrustumCulling = Camera->bFrustumCulling;
 	RpgSceneViewport* viewport = Camera->GetSceneViewport();
-	const RpgBoundingFrustum frustum = viewport->GetViewFrustum();
+	RpgVector4 frustumPlanes[6];
+	viewport->GetViewFrustum().GetPlanes(frustumPlanes);
 	viewport->Meshes.Clear();
 
-	for (auto it = World->Component_CreateConstIterator<RpgRenderComponent_Mesh>(); it; ++it)
+	// Each chunk collects its meshes separately, then merged in chunk order so the result is deterministic.
+	// Multiple of RPG_COMPONENT_CHUNK_SIZE so each range covers whole SoA chunks
+	constexpr int GRAIN_SIZE = RPG_COMPONENT_CHUNK_SIZE * 4;
+
+	const RpgComponentStorage<RpgRenderComponent_Mesh>* storage = World->Component_GetStorage<RpgRenderComponent_Mesh>();
+	const RpgFreeList<RpgRenderComponent_Mesh>& components = storage->GetComponents();
+	const int componentCapacity = components.GetCapacity();
+	const int soaChunkCount = storage->SoA_GetChunkCount();
+
+	// Animation pose per mesh component index, resolved by one linear pass over the query instead of a lookup per mesh
+	RpgArrayFrame<const RpgAnimationComponent_AnimSkeletonPose*> animSkeletonPoses;
+	animSkeletonPoses.Resize(componentCapacity);
+
+	const RpgWorldQuery<const RpgAnimationComponent_AnimSkeletonPose, const RpgRenderComponent_Mesh> animQuery = World->Query<const RpgAnimationComponent_AnimSkeletonPose, const RpgRenderComponent_Mesh>();
+
+	for (int q = 0; q < animQuery.GetCount(); ++q)
 	{
-		const RpgRenderComponent_Mesh& comp = it.GetValue();
+		animSkeletonPoses[animQuery.GetComponentIndex<const RpgRenderComponent_Mesh>(q)] = &animQuery.Get<const RpgAnimationComponent_AnimSkeletonPose>(q);
+	}
 
-		// - check valid model
-		// - check visibility
-		// - if frustum culling enabled, test bound againts frustum
-		if (!comp.Model || !comp.bIsVisible || (bFrustumCulling && !frustum.TestIntersectAABB(comp.Bound)) )
+	RpgArrayFrame<RpgArrayFrame<RpgSceneMesh>> chunkMeshes;
+	chunkMeshes.Resize((componentCapacity + GRAIN_SIZE - 1) / GRAIN_SIZE);
+
+	RpgThreadPool::ParallelFor(componentCapacity, GRAIN_SIZE, 
+		[&](int beginIndex, int endIndex)
 		{
-			continue;
-		}
+			RpgArrayFrame<RpgSceneMesh>& meshes = chunkMeshes[beginIndex / GRAIN_SIZE];
 
-		const RpgMatrixTransform worldTransformMatrix = World->GameObject_GetWorldTransformMatrix(comp.GameObject);
+			for (int chunkIndex = beginIndex / RPG_COMPONENT_CHUNK_SIZE; chunkIndex * RPG_COMPONENT_CHUNK_SIZE < endIndex && chunkIndex < soaChunkCount; ++chunkIndex)
+			{
+				uint64_t laneMask = storage->SoA_GetChunkValidMask(chunkIndex);
+				if (laneMask == 0)
+				{
+					continue;
+				}
 
-		for (int m = 0; m < comp.Model->GetMeshCount(); ++m)
-		{
-			RpgSceneMesh& data = viewport->Meshes.Add();
-			data.GameObject = comp.GameObject;
-			data.WorldTransformMatrix = worldTransformMatrix;
-			data.Material = comp.Model->GetMaterial(m);
-			data.Mesh = comp.Model->GetMeshLod(m, 0);
+				// if frustum culling enabled, test bounds of whole chunk againts frustum
+				if (bFrustumCulling)
+				{
+					laneMask &= ~CullMeshChunk(storage->SoA_GetChunk(chunkIndex), frustumPlanes);
+				}
+
+				for (; laneMask; laneMask &= laneMask - 1)
+				{
+					const int i = chunkIndex * RPG_COMPONENT_CHUNK_SIZE + std::countr_zero(laneMask);
+					const RpgRenderComponent_Mesh& comp = components.GetAt(i);
+
+					// - check valid model
+					// - check visibility
+					if (!comp.Model || !comp.bIsVisible)
+					{
+						continue;
+					}
 
-			// TODO: Determine LOD level based on distance from the camera
+					const RpgMatrixTransform worldTransformMatrix = World->GameObject_GetWorldTransformMatrix(comp.GameObject);
 
-			data.Lod = 0;
+					for (int m = 0; m < comp.Model->GetMeshCount(); ++m)
+					{
+						RpgSceneMesh& data = meshes.Add();
+						data.GameObject = comp.GameObject;
+						data.WorldTransformMatrix = worldTransformMatrix;
+						data.Material = comp.Model->GetMaterial(m);
+						data.Mesh = comp.Model->GetMeshLod(m, 0);
+						data.AnimSkeletonPose = animSkeletonPoses[i];
+
+						// TODO: Determine LOD level based on distance from the camera
+
+						data.Lod = 0;
+					}
+				}
+			}
 		}
+	);
+
+	for (int c = 0; c < chunkMeshes.GetCount(); ++c)
+	{
+		viewport->Meshes.InsertAtRange(chunkMeshes[c], RPG_INDEX_LAST);
 	}
 }
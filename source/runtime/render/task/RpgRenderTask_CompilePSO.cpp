@@ -7,6 +7,7 @@
 RpgRenderTask_CompilePSO::RpgRenderTask_CompilePSO() noexcept
 {
 	RootSignature = nullptr;
+	SetPriority(RpgThreadTaskPriority::BACKGROUND);
 }
 
 
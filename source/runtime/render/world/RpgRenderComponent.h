@@ -17,6 +17,7 @@ class RpgRenderComponent_Mesh
 	RPG_COMPONENT_TYPE("RpgComponent (Render) - Mesh");
 
 public:
+	// World space bound. Mirrored into SoA chunks, call RpgComponentStorage::SoA_Update() after modifying it
 	RpgBoundingAABB Bound;
 	RpgSharedModel Model;
 	bool bIsVisible;
@@ -42,6 +43,76 @@ public:
 
 
 
+// World space bounds of mesh components as SoA, streamed by frustum culling in RpgRenderTask_CaptureMesh
+template<>
+struct RpgComponentSoA<RpgRenderComponent_Mesh>
+{
+	static constexpr bool bEnabled = true;
+
+	struct alignas(RPG_CACHE_LINE_SIZE) FChunk
+	{
+		float MinX[RPG_COMPONENT_CHUNK_SIZE];
+		float MinY[RPG_COMPONENT_CHUNK_SIZE];
+		float MinZ[RPG_COMPONENT_CHUNK_SIZE];
+		float MaxX[RPG_COMPONENT_CHUNK_SIZE];
+		float MaxY[RPG_COMPONENT_CHUNK_SIZE];
+		float MaxZ[RPG_COMPONENT_CHUNK_SIZE];
+	};
+
+
+	static inline void Write(FChunk& chunk, int lane, const RpgRenderComponent_Mesh& component) noexcept
+	{
+		chunk.MinX[lane] = component.Bound.Min.X;
+		chunk.MinY[lane] = component.Bound.Min.Y;
+		chunk.MinZ[lane] = component.Bound.Min.Z;
+		chunk.MaxX[lane] = component.Bound.Max.X;
+		chunk.MaxY[lane] = component.Bound.Max.Y;
+		chunk.MaxZ[lane] = component.Bound.Max.Z;
+	}
+};
+
+
+template<>
+struct RpgComponentSnapshot<RpgRenderComponent_Mesh>
+{
+	static constexpr bool bEnabled = true;
+
+	struct FRecord
+	{
+		float BoundMin[3];
+		float BoundMax[3];
+		int ModelReference;
+		uint8_t bIsVisible;
+	};
+
+
+	static inline void Save(FRecord& out_Record, const RpgRenderComponent_Mesh& component, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		out_Record.BoundMin[0] = component.Bound.Min.X;
+		out_Record.BoundMin[1] = component.Bound.Min.Y;
+		out_Record.BoundMin[2] = component.Bound.Min.Z;
+		out_Record.BoundMax[0] = component.Bound.Max.X;
+		out_Record.BoundMax[1] = component.Bound.Max.Y;
+		out_Record.BoundMax[2] = component.Bound.Max.Z;
+		out_Record.ModelReference = assets.AddReference(RpgAssetFileType::MODEL, component.Model);
+		out_Record.bIsVisible = component.bIsVisible;
+	}
+
+
+	// SoA chunk is updated by the storage after load
+	static inline void Load(RpgRenderComponent_Mesh& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		component.Bound = RpgBoundingAABB(
+			RpgVector3(record.BoundMin[0], record.BoundMin[1], record.BoundMin[2]), 
+			RpgVector3(record.BoundMax[0], record.BoundMax[1], record.BoundMax[2])
+		);
+		component.Model = assets.Resolve<RpgSharedModel>(RpgAssetFileType::MODEL, record.ModelReference);
+		component.bIsVisible = record.bIsVisible;
+	}
+};
+
+
+
 class RpgRenderComponent_Light
 {
 	RPG_COMPONENT_TYPE("RpgComponent (Render) - Light");
@@ -108,6 +179,55 @@ private:
 };
 
 
+// Shadow viewport is not saved, it's created by render subsystem
+template<>
+struct RpgComponentSnapshot<RpgRenderComponent_Light>
+{
+	static constexpr bool bEnabled = true;
+
+	struct FRecord
+	{
+		float ColorIntensity[4];
+		float AttenuationRadius;
+		float AttenuationFallOffExp;
+		float SpotInnerConeDegree;
+		float SpotOuterConeDegree;
+		uint8_t Type;
+		uint8_t bCastShadow;
+		uint8_t bIsVisible;
+	};
+
+
+	static inline void Save(FRecord& out_Record, const RpgRenderComponent_Light& component, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		out_Record.ColorIntensity[0] = component.ColorIntensity.R;
+		out_Record.ColorIntensity[1] = component.ColorIntensity.G;
+		out_Record.ColorIntensity[2] = component.ColorIntensity.B;
+		out_Record.ColorIntensity[3] = component.ColorIntensity.A;
+		out_Record.AttenuationRadius = component.AttenuationRadius;
+		out_Record.AttenuationFallOffExp = component.AttenuationFallOffExp;
+		out_Record.SpotInnerConeDegree = component.SpotInnerConeDegree;
+		out_Record.SpotOuterConeDegree = component.SpotOuterConeDegree;
+		out_Record.Type = component.Type;
+		out_Record.bCastShadow = component.bCastShadow;
+		out_Record.bIsVisible = component.bIsVisible;
+	}
+
+
+	static inline void Load(RpgRenderComponent_Light& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		component.ColorIntensity = RpgColorLinear(record.ColorIntensity[0], record.ColorIntensity[1], record.ColorIntensity[2], record.ColorIntensity[3]);
+		component.AttenuationRadius = record.AttenuationRadius;
+		component.AttenuationFallOffExp = record.AttenuationFallOffExp;
+		component.SpotInnerConeDegree = record.SpotInnerConeDegree;
+		component.SpotOuterConeDegree = record.SpotOuterConeDegree;
+		component.Type = static_cast<RpgRenderLight::EType>(record.Type);
+		component.bCastShadow = record.bCastShadow;
+		component.bIsVisible = record.bIsVisible;
+	}
+};
+
+
 
 class RpgRenderComponent_Camera
 {
@@ -170,3 +290,48 @@ private:
 	friend RpgRenderTask_CaptureLight;
 
 };
+
+
+
+// Viewport is not saved, camera renders into its own viewport after load until it's assigned again
+template<>
+struct RpgComponentSnapshot<RpgRenderComponent_Camera>
+{
+	static constexpr bool bEnabled = true;
+
+	struct FRecord
+	{
+		int RenderTargetDimension[2];
+		float PerspectiveFoVDegree;
+		float NearClipZ;
+		float FarClipZ;
+		uint8_t ProjectionMode;
+		uint8_t bActivated;
+		uint8_t bFrustumCulling;
+	};
+
+
+	static inline void Save(FRecord& out_Record, const RpgRenderComponent_Camera& component, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		out_Record.RenderTargetDimension[0] = component.RenderTargetDimension.X;
+		out_Record.RenderTargetDimension[1] = component.RenderTargetDimension.Y;
+		out_Record.PerspectiveFoVDegree = component.PerspectiveFoVDegree;
+		out_Record.NearClipZ = component.NearClipZ;
+		out_Record.FarClipZ = component.FarClipZ;
+		out_Record.ProjectionMode = static_cast<uint8_t>(component.ProjectionMode);
+		out_Record.bActivated = component.bActivated;
+		out_Record.bFrustumCulling = component.bFrustumCulling;
+	}
+
+
+	static inline void Load(RpgRenderComponent_Camera& component, const FRecord& record, RpgWorldSnapshotAssetTable& assets) noexcept
+	{
+		component.RenderTargetDimension = RpgPointInt(record.RenderTargetDimension[0], record.RenderTargetDimension[1]);
+		component.PerspectiveFoVDegree = record.PerspectiveFoVDegree;
+		component.NearClipZ = record.NearClipZ;
+		component.FarClipZ = record.FarClipZ;
+		component.ProjectionMode = static_cast<RpgRenderProjectionMode>(record.ProjectionMode);
+		component.bActivated = record.bActivated;
+		component.bFrustumCulling = record.bFrustumCulling;
+	}
+};
@@ -2,6 +2,7 @@
 #include "RpgRenderComponent.h"
 #include "../RpgRenderer.h"
 #include "../task/RpgRenderTask_Capture.h"
+#include "animation/world/RpgAnimationComponent.h"
 
 
 
@@ -9,6 +10,13 @@ RpgRenderWorldSubsystem::RpgRenderWorldSubsystem() noexcept
 {
 	Name = "RenderWorldSubsystem";
 
+	DeclareComponentWrite<RpgRenderComponent_Mesh>();
+	DeclareComponentWrite<RpgRenderComponent_Light>();
+	DeclareComponentWrite<RpgRenderComponent_Camera>();
+
+	// Skinned meshes read final pose in RpgRenderTask_CaptureMesh
+	DeclareComponentRead<RpgAnimationComponent_AnimSkeletonPose>();
+
 
 #ifndef RPG_BUILD_SHIPPING
 	bDebugDrawMeshBound = false;
@@ -20,22 +28,38 @@ RpgRenderWorldSubsystem::RpgRenderWorldSubsystem() noexcept
 
 void RpgRenderWorldSubsystem::PostTickUpdate() noexcept
 {
-    RpgWorld* world = GetWorld();
+	RpgWorld* world = GetWorld();
 
-    for (auto it = world->Component_CreateIterator<RpgRenderComponent_Mesh>(); it; ++it)
-    {
-        RpgRenderComponent_Mesh& comp = it.GetValue();
+	RpgComponentStorage<RpgRenderComponent_Mesh>* meshStorage = world->Component_GetStorage<RpgRenderComponent_Mesh>();
+	const RpgArray<RpgGameObjectID>& movedObjects = world->GameObject_GetTransformUpdatedList();
+
+	// update bounds of moved meshes in parallel, each component only reads its own game object transform and writes its own SoA lane
+	RpgThreadPool::ParallelFor(movedObjects.GetCount(), 256, 
+		[world, meshStorage, &movedObjects](int beginIndex, int endIndex)
+		{
+			for (int i = beginIndex; i < endIndex; ++i)
+			{
+				const RpgGameObjectID gameObject = movedObjects[i];
+				if (!world->GameObject_IsValid(gameObject))
+				{
+					continue;
+				}
 
-        if (!world->GameObject_IsTransformUpdated(comp.GameObject))
-        {
-            continue;
-        }
+				const int index = world->GameObject_GetComponentIndex<RpgRenderComponent_Mesh>(gameObject);
+				if (index == RPG_COMPONENT_ID_INVALID)
+				{
+					continue;
+				}
 
-        comp.Bound = comp.Model ? comp.Model->GetBound() : RpgBoundingAABB(RpgVector3(-32.0f), RpgVector3(32.0f));
+				RpgRenderComponent_Mesh& comp = meshStorage->Get(index);
+				comp.Bound = comp.Model ? comp.Model->GetBound() : RpgBoundingAABB(RpgVector3(-32.0f), RpgVector3(32.0f));
 
-        // transform bound into world space
-        comp.Bound = RpgBoundingBox(comp.Bound, world->GameObject_GetWorldTransformMatrix(comp.GameObject)).ToAABB();
-    }
+				// transform bound into world space
+				comp.Bound = RpgBoundingBox(comp.Bound, world->GameObject_GetWorldTransformMatrix(gameObject)).ToAABB();
+				meshStorage->SoA_Update(index);
+			}
+		}
+	);
 
 
 	for (auto it = world->Component_CreateIterator<RpgRenderComponent_Light>(); it; ++it)
@@ -59,6 +59,7 @@ public:
 	RpgShaderTask_CompileHLSL() noexcept
 	{
 		Type = RpgShader::TYPE_NONE;
+		SetPriority(RpgThreadTaskPriority::BACKGROUND);
 	}
 
 